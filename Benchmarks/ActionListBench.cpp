@@ -0,0 +1,66 @@
+// ActionList::Invoke against a std::vector of std::function
+
+#include "Benchmark.h"
+
+#include <Containers/ActionList.h>
+
+#include <functional>
+#include <vector>
+
+namespace
+{
+  u64 s_Sink = 0;
+
+  void Handler(const u64 &value)
+  {
+    s_Sink += value;
+  }
+
+  void BM_ActionListInvoke(Bench::State &state)
+  {
+    const i64 handlers = state.Range(0);
+    CustomSTL::ActionList<u64> actions;
+    for (i64 i = 0; i < handlers; ++i)
+      actions.Subscribe(Handler);
+
+    u64 next = 0;
+    for (auto _ : state)
+      actions.Invoke(next++);
+    Bench::DoNotOptimize(s_Sink);
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * handlers);
+  }
+
+  void BM_FunctionVectorInvoke(Bench::State &state)
+  {
+    const i64 handlers = state.Range(0);
+    std::vector<std::function<void(const u64 &)>> actions;
+    for (i64 i = 0; i < handlers; ++i)
+      actions.emplace_back(Handler);
+
+    u64 next = 0;
+    for (auto _ : state)
+    {
+      const u64 value = next++;
+      for (const auto &action : actions)
+        action(value);
+    }
+    Bench::DoNotOptimize(s_Sink);
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * handlers);
+  }
+
+  // Subscribe then Unsubscribe with Range(0) other handlers registered
+  void BM_ActionListSubscribe(Bench::State &state)
+  {
+    CustomSTL::ActionList<u64> actions;
+    for (i64 i = 0; i < state.Range(0); ++i)
+      actions.Subscribe(Handler);
+
+    for (auto _ : state)
+      actions.Unsubscribe(actions.Subscribe(Handler));
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+}
+
+BENCHMARK(BM_FunctionVectorInvoke)->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK(BM_ActionListInvoke)->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK(BM_ActionListSubscribe)->Arg(8)->Arg(64);
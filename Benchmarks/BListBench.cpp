@@ -0,0 +1,221 @@
+// BList at several node sizes against std::list and std::vector doing the
+// same job
+
+#include "Benchmark.h"
+
+#include <STLContainers/BList.h>
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <random>
+#include <vector>
+
+namespace
+{
+  std::vector<int> Keys(size_t count)
+  {
+    std::mt19937 engine(42);
+    std::vector<int> keys(count);
+    for (int &key : keys)
+      key = static_cast<int>(engine() % (count * 4));
+    return keys;
+  }
+
+  template <unsigned Size>
+  BList<int, Size> SortedBList(const std::vector<int> &keys)
+  {
+    BList<int, Size> list;
+    for (int key : keys)
+      list.insert(key);
+    return list;
+  }
+
+  template <unsigned Size>
+  void BM_BListPushBack(Bench::State &state)
+  {
+    const int count = static_cast<int>(state.Range(0));
+    for (auto _ : state)
+    {
+      BList<int, Size> list;
+      for (int i = 0; i < count; ++i)
+        list.push_back(i);
+      Bench::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * count);
+  }
+
+  template <typename Container>
+  void BM_StdPushBack(Bench::State &state)
+  {
+    const int count = static_cast<int>(state.Range(0));
+    for (auto _ : state)
+    {
+      Container list;
+      for (int i = 0; i < count; ++i)
+        list.push_back(i);
+      Bench::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * count);
+  }
+
+  // Builds a sorted list from random keys
+  template <unsigned Size>
+  void BM_BListSortedInsert(Bench::State &state)
+  {
+    const std::vector<int> keys = Keys(static_cast<size_t>(state.Range(0)));
+    for (auto _ : state)
+    {
+      BList<int, Size> list;
+      for (int key : keys)
+        list.insert(key);
+      Bench::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * keys.size()));
+  }
+
+  void BM_StdListSortedInsert(Bench::State &state)
+  {
+    const std::vector<int> keys = Keys(static_cast<size_t>(state.Range(0)));
+    for (auto _ : state)
+    {
+      std::list<int> list;
+      for (int key : keys)
+        list.insert(std::find_if(list.begin(), list.end(), [key](int value) { return value > key; }), key);
+      Bench::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * keys.size()));
+  }
+
+  void BM_StdVectorSortedInsert(Bench::State &state)
+  {
+    const std::vector<int> keys = Keys(static_cast<size_t>(state.Range(0)));
+    for (auto _ : state)
+    {
+      std::vector<int> list;
+      for (int key : keys)
+        list.insert(std::upper_bound(list.begin(), list.end(), key), key);
+      Bench::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * keys.size()));
+  }
+
+  // Linear search by value
+  template <unsigned Size>
+  void BM_BListFind(Bench::State &state)
+  {
+    const std::vector<int> keys = Keys(static_cast<size_t>(state.Range(0)));
+    const BList<int, Size> list = SortedBList<Size>(keys);
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(list.find(keys[next]));
+      next = next + 1 == keys.size() ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_StdListFind(Bench::State &state)
+  {
+    std::vector<int> keys = Keys(static_cast<size_t>(state.Range(0)));
+    std::vector<int> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    const std::list<int> list(sorted.begin(), sorted.end());
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(std::find(list.begin(), list.end(), keys[next]));
+      next = next + 1 == keys.size() ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  // Ordered search, BList skips whole nodes by their last value
+  template <unsigned Size>
+  void BM_BListLowerBound(Bench::State &state)
+  {
+    const std::vector<int> keys = Keys(static_cast<size_t>(state.Range(0)));
+    const BList<int, Size> list = SortedBList<Size>(keys);
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(list.lower_bound(keys[next]));
+      next = next + 1 == keys.size() ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_StdVectorLowerBound(Bench::State &state)
+  {
+    std::vector<int> keys = Keys(static_cast<size_t>(state.Range(0)));
+    std::vector<int> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(std::lower_bound(sorted.begin(), sorted.end(), keys[next]));
+      next = next + 1 == keys.size() ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  // Random access by position
+  template <unsigned Size>
+  void BM_BListIndex(Bench::State &state)
+  {
+    const int count = static_cast<int>(state.Range(0));
+    BList<int, Size> list;
+    for (int i = 0; i < count; ++i)
+      list.push_back(i);
+
+    std::mt19937 engine(7);
+    for (auto _ : state)
+      Bench::DoNotOptimize(list[static_cast<int>(engine() % static_cast<unsigned>(count))]);
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_StdListIndex(Bench::State &state)
+  {
+    const int count = static_cast<int>(state.Range(0));
+    std::list<int> list;
+    for (int i = 0; i < count; ++i)
+      list.push_back(i);
+
+    std::mt19937 engine(7);
+    for (auto _ : state)
+      Bench::DoNotOptimize(*std::next(list.begin(), engine() % static_cast<unsigned>(count)));
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_StdPushBack, std::list<int>)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_StdPushBack, std::vector<int>)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_BListPushBack, 1)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_BListPushBack, 4)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_BListPushBack, 16)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_BListPushBack, 64)->Arg(4096);
+
+BENCHMARK(BM_StdListSortedInsert)->Arg(1024);
+BENCHMARK(BM_StdVectorSortedInsert)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListSortedInsert, 1)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListSortedInsert, 4)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListSortedInsert, 16)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListSortedInsert, 64)->Arg(1024);
+
+BENCHMARK(BM_StdListFind)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListFind, 1)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListFind, 4)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListFind, 16)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListFind, 64)->Arg(1024);
+
+BENCHMARK(BM_StdVectorLowerBound)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListLowerBound, 1)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListLowerBound, 4)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListLowerBound, 16)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListLowerBound, 64)->Arg(1024);
+
+BENCHMARK(BM_StdListIndex)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListIndex, 1)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListIndex, 4)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListIndex, 16)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_BListIndex, 64)->Arg(1024);
@@ -0,0 +1,316 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace Bench
+{
+  namespace
+  {
+    constexpr u64 MAX_ITERATIONS = 1'000'000'000;
+
+    struct Options
+    {
+      std::string filter;
+      std::string json;
+      double minTime = 0.5;
+      unsigned repetitions = 3;
+      bool list = false;
+    };
+
+    struct Result
+    {
+      std::string name;
+      u64 iterations = 0;
+      double realNs = 0.0;        // Per iteration
+      double cpuNs = 0.0;         // Per iteration
+      double itemsPerSecond = 0.0;
+      double bytesPerSecond = 0.0;
+      std::string error;
+    };
+
+    std::vector<std::unique_ptr<Registration>> &Registry()
+    {
+      static std::vector<std::unique_ptr<Registration>> registry;
+      return registry;
+    }
+
+    double CpuSeconds()
+    {
+      return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+    }
+
+    std::string JsonEscape(const std::string &text)
+    {
+      std::string escaped;
+      for (char c : text)
+      {
+        if (c == '"' || c == '\\')
+          escaped += '\\';
+        escaped += c;
+      }
+      return escaped;
+    }
+
+    bool ParseFlag(const char *arg, const char *flag, std::string &value)
+    {
+      const size_t length = std::strlen(flag);
+      if (std::strncmp(arg, flag, length) != 0 || arg[length] != '=')
+        return false;
+      value = arg + length + 1;
+      return true;
+    }
+  }
+
+  void State::StartTimer()
+  {
+    if (running)
+      return;
+    running = true;
+    cpuStart = CpuSeconds();
+    realStart = Clock::now();
+  }
+
+  void State::StopTimer()
+  {
+    if (!running)
+      return;
+    realSeconds += std::chrono::duration<double>(Clock::now() - realStart).count();
+    cpuSeconds += CpuSeconds() - cpuStart;
+    running = false;
+  }
+
+  Registration *Register(std::string name, Function function)
+  {
+    Registry().push_back(std::make_unique<Registration>(std::move(name), function));
+    return Registry().back().get();
+  }
+
+  class Runner
+  {
+  public:
+    explicit Runner(const Options &options) : options(options) {}
+
+    // Every (benchmark, argument set) pair as a name and its arguments
+    template <typename Func>
+    void ForEachRun(Func &&func) const
+    {
+      for (const std::unique_ptr<Registration> &registration : Registry())
+      {
+        std::vector<std::vector<i64>> argSets = registration->argSets;
+        if (argSets.empty())
+          argSets.emplace_back();
+
+        for (const std::vector<i64> &args : argSets)
+        {
+          std::string name = registration->name;
+          for (i64 arg : args)
+          {
+            name += '/';
+            name += std::to_string(arg);
+          }
+          if (name.find(options.filter) != std::string::npos)
+            func(*registration, name, args);
+        }
+      }
+    }
+
+    Result Run(const Registration &registration, const std::string &name, const std::vector<i64> &args) const
+    {
+      std::vector<State> runs;
+
+      // Grow the iteration count until one run is long enough to measure
+      u64 iterations = 1;
+      while (true)
+      {
+        State state(iterations, args);
+        registration.function(state);
+        const double seconds = state.realSeconds;
+        const bool done = seconds >= options.minTime || iterations >= MAX_ITERATIONS || !state.error.empty();
+        if (done)
+        {
+          runs.push_back(std::move(state));
+          break;
+        }
+
+        double multiplier = 10.0;
+        if (seconds / options.minTime > 0.1)
+          multiplier = options.minTime * 1.4 / seconds;
+        const double next = std::ceil(static_cast<double>(iterations) * multiplier);
+        iterations = std::min(MAX_ITERATIONS, std::max(iterations + 1, static_cast<u64>(next)));
+      }
+
+      while (runs.size() < options.repetitions && runs.front().error.empty())
+      {
+        State state(iterations, args);
+        registration.function(state);
+        runs.push_back(std::move(state));
+      }
+
+      // The median by wall clock time
+      std::sort(runs.begin(), runs.end(), [](const State &a, const State &b) {
+        return a.realSeconds < b.realSeconds;
+      });
+      const State &median = runs[runs.size() / 2];
+
+      Result result;
+      result.name = name;
+      result.iterations = median.iterations;
+      result.realNs = median.realSeconds * 1e9 / static_cast<double>(median.iterations);
+      result.cpuNs = median.cpuSeconds * 1e9 / static_cast<double>(median.iterations);
+      if (median.realSeconds > 0.0)
+      {
+        result.itemsPerSecond = static_cast<double>(median.itemsProcessed) / median.realSeconds;
+        result.bytesPerSecond = static_cast<double>(median.bytesProcessed) / median.realSeconds;
+      }
+      for (const State &run : runs)
+        if (!run.error.empty())
+          result.error = run.error;
+      return result;
+    }
+
+    void WriteJson(const std::vector<Result> &results) const
+    {
+      std::ofstream out(options.json);
+      if (!out)
+        throw std::runtime_error("Cannot open " + options.json);
+      out.precision(10);
+
+      char date[32] = {};
+      std::time_t now = std::time(nullptr);
+      std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+      char host[256] = "unknown";
+#if defined(__unix__) || defined(__APPLE__)
+      gethostname(host, sizeof(host) - 1);
+#endif
+
+#ifdef NDEBUG
+      const char *buildType = "release";
+#else
+      const char *buildType = "debug";
+#endif
+
+      out << "{\n  \"context\": {\n"
+          << "    \"date\": \"" << date << "\",\n"
+          << "    \"host_name\": \"" << JsonEscape(host) << "\",\n"
+          << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+          << "    \"library_build_type\": \"" << buildType << "\",\n"
+          << "    \"min_time\": " << options.minTime << ",\n"
+          << "    \"repetitions\": " << options.repetitions << "\n"
+          << "  },\n  \"benchmarks\": [";
+
+      for (size_t i = 0; i < results.size(); ++i)
+      {
+        const Result &result = results[i];
+        out << (i ? ",\n" : "\n") << "    {\n"
+            << "      \"name\": \"" << JsonEscape(result.name) << "\",\n"
+            << "      \"run_name\": \"" << JsonEscape(result.name) << "\",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"iterations\": " << result.iterations << ",\n"
+            << "      \"real_time\": " << result.realNs << ",\n"
+            << "      \"cpu_time\": " << result.cpuNs << ",\n"
+            << "      \"time_unit\": \"ns\"";
+        if (result.itemsPerSecond > 0.0)
+          out << ",\n      \"items_per_second\": " << result.itemsPerSecond;
+        if (result.bytesPerSecond > 0.0)
+          out << ",\n      \"bytes_per_second\": " << result.bytesPerSecond;
+        if (!result.error.empty())
+          out << ",\n      \"error_occurred\": true,\n      \"error_message\": \"" << JsonEscape(result.error) << "\"";
+        out << "\n    }";
+      }
+      out << "\n  ]\n}\n";
+    }
+
+  private:
+    const Options &options;
+  };
+
+  int RunAll(int argc, char **argv)
+  {
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string value;
+      if (ParseFlag(argv[i], "--filter", value))
+        options.filter = value;
+      else if (ParseFlag(argv[i], "--json", value))
+        options.json = value;
+      else if (ParseFlag(argv[i], "--min-time", value))
+        options.minTime = std::max(1e-3, std::atof(value.c_str()));
+      else if (ParseFlag(argv[i], "--repetitions", value))
+        options.repetitions = static_cast<unsigned>(std::max(1, std::atoi(value.c_str())));
+      else if (std::strcmp(argv[i], "--list") == 0)
+        options.list = true;
+      else
+      {
+        std::fprintf(stderr,
+                     "usage: %s [--filter=<substring>] [--min-time=<seconds>] [--repetitions=<n>] "
+                     "[--json=<path>] [--list]\n",
+                     argv[0]);
+        return 1;
+      }
+    }
+
+    Runner runner(options);
+    if (options.list)
+    {
+      runner.ForEachRun([](const Registration &, const std::string &name, const std::vector<i64> &) {
+        std::printf("%s\n", name.c_str());
+      });
+      return 0;
+    }
+
+    std::printf("%-56s %14s %14s %12s %20s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations", "Throughput");
+    std::printf("%s\n", std::string(120, '-').c_str());
+
+    std::vector<Result> results;
+    runner.ForEachRun([&](const Registration &registration, const std::string &name, const std::vector<i64> &args) {
+      Result result = runner.Run(registration, name, args);
+      char throughput[32] = "";
+      if (result.itemsPerSecond > 0.0)
+        std::snprintf(throughput, sizeof(throughput), "%.4g items/s", result.itemsPerSecond);
+      else if (result.bytesPerSecond > 0.0)
+        std::snprintf(throughput, sizeof(throughput), "%.4g B/s", result.bytesPerSecond);
+
+      if (!result.error.empty())
+        std::printf("%-56s ERROR: %s\n", name.c_str(), result.error.c_str());
+      else
+        std::printf("%-56s %14.2f %14.2f %12llu %20s\n", name.c_str(), result.realNs, result.cpuNs,
+                    static_cast<unsigned long long>(result.iterations), throughput);
+      std::fflush(stdout);
+      results.push_back(std::move(result));
+    });
+
+    if (!options.json.empty())
+    {
+      try
+      {
+        runner.WriteJson(results);
+      }
+      catch (const std::exception &e)
+      {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+      }
+    }
+    return 0;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  return Bench::RunAll(argc, argv);
+}
@@ -0,0 +1,236 @@
+/**********************************************************************************
+* \brief  A small self-contained benchmark harness with the shape of Google
+*         Benchmark, so benchmarks read the same and the JSON it writes can be
+*         fed to the same comparison tools.
+*
+*           void BM_Thing(Bench::State &state)
+*           {
+*             for (auto _ : state)
+*               Bench::DoNotOptimize(Thing(state.Range(0)));
+*             state.SetItemsProcessed(state.Iterations());
+*           }
+*           BENCHMARK(BM_Thing)->Arg(64)->Arg(1024);
+*
+*         Each benchmark is run with a growing iteration count until one run
+*         takes at least --min-time, then repeated --repetitions times at that
+*         count. The median run is reported.
+*
+*         Flags: --filter=<substring> --min-time=<seconds> --repetitions=<n>
+*                --json=<path> --list
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Bench
+{
+  class State;
+  using Function = void (*)(State &);
+
+  class State
+  {
+  public:
+    // What the range-for loop hands out, empty so the loop variable costs
+    // nothing and is never reported as unused
+    struct [[maybe_unused]] Value
+    {
+    };
+
+    class Iterator
+    {
+      State *state;
+      u64 remaining;
+
+    public:
+      Iterator(State *state, u64 remaining) : state(state), remaining(remaining) {}
+
+      Value operator*() const
+      {
+        return {};
+      }
+
+      Iterator &operator++()
+      {
+        --remaining;
+        return *this;
+      }
+
+      // Stops the clock when the last iteration is done
+      bool operator!=(const Iterator &) const
+      {
+        if (remaining)
+          return true;
+        state->StopTimer();
+        return false;
+      }
+    };
+
+    State(u64 iterations, std::vector<i64> args) : iterations(iterations), args(std::move(args)) {}
+
+    Iterator begin()
+    {
+      StartTimer();
+      return Iterator(this, iterations);
+    }
+
+    Iterator end()
+    {
+      return Iterator(this, 0);
+    }
+
+    u64 Iterations() const
+    {
+      return iterations;
+    }
+
+    i64 Range(size_t index = 0) const
+    {
+      return index < args.size() ? args[index] : 0;
+    }
+
+    // Excludes setup work inside the loop from the measurement
+    void PauseTiming()
+    {
+      StopTimer();
+    }
+
+    void ResumeTiming()
+    {
+      StartTimer();
+    }
+
+    void SetItemsProcessed(i64 items)
+    {
+      itemsProcessed = items;
+    }
+
+    void SetBytesProcessed(i64 bytes)
+    {
+      bytesProcessed = bytes;
+    }
+
+    // Marks the run as failed, the loop still has to finish
+    void SkipWithError(std::string message)
+    {
+      error = std::move(message);
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    friend class Runner;
+
+    void StartTimer();
+    void StopTimer();
+
+    u64 iterations;
+    std::vector<i64> args;
+    i64 itemsProcessed = 0;
+    i64 bytesProcessed = 0;
+    std::string error;
+
+    bool running = false;
+    Clock::time_point realStart;
+    double cpuStart = 0.0;
+    double realSeconds = 0.0;
+    double cpuSeconds = 0.0;
+  };
+
+  class Registration
+  {
+  public:
+    Registration(std::string name, Function function) : name(std::move(name)), function(function) {}
+
+    // Adds a run with one argument
+    Registration *Arg(i64 value)
+    {
+      argSets.push_back({value});
+      return this;
+    }
+
+    // Adds a run with several arguments, read back with Range(0), Range(1)...
+    Registration *Args(std::initializer_list<i64> values)
+    {
+      argSets.emplace_back(values);
+      return this;
+    }
+
+    // Adds runs for lo, lo * multiplier, ... up to and including hi. Throws
+    // std::invalid_argument unless 0 < lo <= hi and multiplier > 1, the
+    // steps would never reach hi otherwise.
+    Registration *Range(i64 lo, i64 hi, i64 multiplier = 8)
+    {
+      if (lo <= 0 || hi < lo || multiplier <= 1)
+        throw std::invalid_argument("Bench::Registration::Range: needs 0 < lo <= hi and multiplier > 1");
+      for (i64 value = lo; value < hi; value = value > hi / multiplier ? hi : value * multiplier)
+        argSets.push_back({value});
+      argSets.push_back({hi});
+      return this;
+    }
+
+  private:
+    friend class Runner;
+
+    std::string name;
+    Function function;
+    std::vector<std::vector<i64>> argSets;
+  };
+
+  Registration *Register(std::string name, Function function);
+
+  // Parses the flags, runs every matching benchmark and returns the exit code
+  int RunAll(int argc, char **argv);
+
+  // Keeps the compiler from optimising away the computation of value
+  template <typename T>
+  inline void DoNotOptimize(const T &value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile char *sink = reinterpret_cast<const volatile char *>(&value);
+    (void)*sink;
+#endif
+  }
+
+  template <typename T>
+  inline void DoNotOptimize(T &value)
+  {
+#if defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#elif defined(__GNUC__)
+    asm volatile("" : "+m,r"(value) : : "memory");
+#else
+    DoNotOptimize(static_cast<const T &>(value));
+#endif
+  }
+
+  // Forces pending writes to memory to be treated as observable
+  inline void ClobberMemory()
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+#endif
+  }
+}
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+
+#define BENCHMARK(function)                                                          \
+  [[maybe_unused]] static ::Bench::Registration *BENCH_CONCAT(s_Benchmark, __LINE__) = \
+      ::Bench::Register(#function, function)
+
+#define BENCHMARK_TEMPLATE(function, ...)                                            \
+  [[maybe_unused]] static ::Bench::Registration *BENCH_CONCAT(s_Benchmark, __LINE__) = \
+      ::Bench::Register(#function "<" #__VA_ARGS__ ">", function<__VA_ARGS__>)
@@ -0,0 +1,137 @@
+// bitset against std::bitset
+
+#include "Benchmark.h"
+
+#include <STLContainers/bitset.h>
+
+#include <bitset>
+#include <random>
+#include <vector>
+
+namespace
+{
+  std::vector<size_t> Indices(size_t bits)
+  {
+    std::mt19937 engine(42);
+    std::vector<size_t> indices(1024);
+    for (size_t &index : indices)
+      index = engine() % bits;
+    return indices;
+  }
+
+  template <typename Bits>
+  void Randomise(Bits &bits, size_t size)
+  {
+    std::mt19937 engine(3);
+    for (size_t i = 0; i < size; ++i)
+      bits.set(i, engine() & 1);
+  }
+
+  // Set and test at random positions
+  template <typename Bits, size_t N>
+  void BM_SetTest(Bench::State &state)
+  {
+    const std::vector<size_t> indices = Indices(N);
+    Bits bits;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      bits.set(indices[next]);
+      Bench::DoNotOptimize(bits.test(indices[(next + 512) & 1023]));
+      next = (next + 1) & 1023;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+  template <typename Bits, size_t N>
+  void BM_Flip(Bench::State &state)
+  {
+    const std::vector<size_t> indices = Indices(N);
+    Bits bits;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      bits.flip(indices[next]);
+      next = (next + 1) & 1023;
+    }
+    Bench::DoNotOptimize(bits);
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  template <typename Bits, size_t N>
+  void BM_Count(Bench::State &state)
+  {
+    Bits bits;
+    Randomise(bits, N);
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(bits);
+      Bench::DoNotOptimize(bits.count());
+    }
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * (N / 8)));
+  }
+
+  // a &= b, a |= b, a ^= b and ~a over the whole set
+  template <typename Bits, size_t N>
+  void BM_Logic(Bench::State &state)
+  {
+    Bits a, b;
+    Randomise(a, N);
+    Randomise(b, N / 2);
+    for (auto _ : state)
+    {
+      a &= b;
+      a |= b;
+      a ^= b;
+      a = ~a;
+      Bench::DoNotOptimize(a);
+    }
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * 4 * (N / 8)));
+  }
+
+  template <typename Bits, size_t N>
+  void BM_AnyNone(Bench::State &state)
+  {
+    Bits bits;
+    bits.set(N - 1);
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(bits);
+      Bench::DoNotOptimize(bits.any());
+      Bench::DoNotOptimize(bits.none());
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+  template <typename Bits, size_t N>
+  void BM_ToString(Bench::State &state)
+  {
+    Bits bits;
+    Randomise(bits, N);
+    for (auto _ : state)
+      Bench::DoNotOptimize(bits.to_string());
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * N));
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_SetTest, std::bitset<64>, 64);
+BENCHMARK_TEMPLATE(BM_SetTest, CustomSTL::bitset<64>, 64);
+BENCHMARK_TEMPLATE(BM_SetTest, std::bitset<4096>, 4096);
+BENCHMARK_TEMPLATE(BM_SetTest, CustomSTL::bitset<4096>, 4096);
+
+BENCHMARK_TEMPLATE(BM_Flip, std::bitset<4096>, 4096);
+BENCHMARK_TEMPLATE(BM_Flip, CustomSTL::bitset<4096>, 4096);
+
+BENCHMARK_TEMPLATE(BM_Count, std::bitset<64>, 64);
+BENCHMARK_TEMPLATE(BM_Count, CustomSTL::bitset<64>, 64);
+BENCHMARK_TEMPLATE(BM_Count, std::bitset<4096>, 4096);
+BENCHMARK_TEMPLATE(BM_Count, CustomSTL::bitset<4096>, 4096);
+
+BENCHMARK_TEMPLATE(BM_Logic, std::bitset<4096>, 4096);
+BENCHMARK_TEMPLATE(BM_Logic, CustomSTL::bitset<4096>, 4096);
+
+BENCHMARK_TEMPLATE(BM_AnyNone, std::bitset<4096>, 4096);
+BENCHMARK_TEMPLATE(BM_AnyNone, CustomSTL::bitset<4096>, 4096);
+
+BENCHMARK_TEMPLATE(BM_ToString, std::bitset<4096>, 4096);
+BENCHMARK_TEMPLATE(BM_ToString, CustomSTL::bitset<4096>, 4096);
@@ -0,0 +1,86 @@
+// ConcurrentHashMap against a std::unordered_map behind one mutex, the
+// pattern it replaces, under a 95% read mix
+
+#include "Benchmark.h"
+
+#include <Containers/ConcurrentHashMap.h>
+
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  constexpr u64 KEY_COUNT = 1 << 16;
+
+  class MutexMap
+  {
+    std::unordered_map<u64, u64> map;
+    mutable std::mutex m;
+
+  public:
+    bool Find(u64 key, u64 &output) const
+    {
+      std::lock_guard<std::mutex> lock(m);
+      auto found = map.find(key);
+      if (found == map.end())
+        return false;
+      output = found->second;
+      return true;
+    }
+
+    bool InsertOrAssign(u64 key, u64 value)
+    {
+      std::lock_guard<std::mutex> lock(m);
+      return map.insert_or_assign(key, value).second;
+    }
+  };
+
+  // One in twenty operations is a write. Keys come from a per-thread LCG
+  // so the threads do not walk the table in step.
+  template <typename Map>
+  void Step(Map &map, u64 &rng, u64 &output)
+  {
+    rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    const u64 key = (rng >> 33) % KEY_COUNT;
+    if ((rng >> 20) % 20 == 0)
+      map.InsertOrAssign(key, rng);
+    else
+      map.Find(key, output);
+  }
+
+  // Range(0) threads each do as many operations as the benchmark thread
+  template <typename Map>
+  void BM_ReadMostly(Bench::State &state)
+  {
+    const u64 threads = static_cast<u64>(state.Range(0));
+    const u64 count = state.Iterations();
+    Map map;
+    for (u64 key = 0; key < KEY_COUNT; ++key)
+      map.InsertOrAssign(key, key);
+
+    std::vector<std::thread> helpers;
+    for (u64 t = 1; t < threads; ++t)
+      helpers.emplace_back([&map, t, count] {
+        u64 rng = t, output = 0;
+        for (u64 i = 0; i < count; ++i)
+          Step(map, rng, output);
+        Bench::DoNotOptimize(output);
+      });
+
+    u64 rng = 0, output = 0;
+    for (auto _ : state)
+      Step(map, rng, output);
+    Bench::DoNotOptimize(output);
+
+    for (std::thread &helper : helpers)
+      helper.join();
+    state.SetItemsProcessed(static_cast<i64>(count * threads));
+  }
+
+  using ShardedMap = CustomSTL::ConcurrentHashMap<u64, u64>;
+}
+
+BENCHMARK_TEMPLATE(BM_ReadMostly, MutexMap)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK_TEMPLATE(BM_ReadMostly, ShardedMap)->Arg(1)->Arg(4)->Arg(16);
@@ -0,0 +1,215 @@
+// flat_hash_map and flat_hash_set against std::unordered_map and
+// std::unordered_set
+
+#include "Benchmark.h"
+
+#include <STLContainers/flat_hash_map.h>
+#include <STLContainers/flat_hash_set.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+  // Scattered 64-bit keys, so neither table benefits from sequential ids
+  std::vector<u64> Keys(size_t count, u64 seed)
+  {
+    std::vector<u64> keys(count);
+    u64 state = seed;
+    for (u64 &key : keys)
+    {
+      state += 0x9E3779B97F4A7C15ULL;
+      u64 mixed = state;
+      mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+      key = mixed ^ (mixed >> 31);
+    }
+    return keys;
+  }
+
+  std::vector<std::string> Names(size_t count)
+  {
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (u64 key : Keys(count, 3))
+      names.push_back("symbol_" + std::to_string(key));
+    return names;
+  }
+
+  // Build a map of Range(0) keys from empty
+  template <typename Map>
+  void BM_Insert(Bench::State &state)
+  {
+    const std::vector<u64> keys = Keys(static_cast<size_t>(state.Range(0)), 1);
+    for (auto _ : state)
+    {
+      Map map;
+      for (u64 key : keys)
+        map.emplace(key, key);
+      Bench::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * keys.size()));
+  }
+
+  template <typename Map>
+  void BM_InsertReserved(Bench::State &state)
+  {
+    const std::vector<u64> keys = Keys(static_cast<size_t>(state.Range(0)), 1);
+    for (auto _ : state)
+    {
+      Map map;
+      map.reserve(keys.size());
+      for (u64 key : keys)
+        map.emplace(key, key);
+      Bench::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * keys.size()));
+  }
+
+  // Lookups that all hit, then lookups that all miss, with Range(0) keys
+  template <typename Map>
+  void BM_FindHit(Bench::State &state)
+  {
+    const std::vector<u64> keys = Keys(static_cast<size_t>(state.Range(0)), 1);
+    Map map;
+    for (u64 key : keys)
+      map.emplace(key, key);
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(map.find(keys[next]));
+      if (++next == keys.size())
+        next = 0;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  template <typename Map>
+  void BM_FindMiss(Bench::State &state)
+  {
+    const std::vector<u64> keys = Keys(static_cast<size_t>(state.Range(0)), 1);
+    const std::vector<u64> absent = Keys(keys.size(), 2);
+    Map map;
+    for (u64 key : keys)
+      map.emplace(key, key);
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(map.find(absent[next]));
+      if (++next == absent.size())
+        next = 0;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  // Erase one key and insert another with Range(0) live, the steady state
+  // of a session table
+  template <typename Map>
+  void BM_Churn(Bench::State &state)
+  {
+    const std::vector<u64> keys = Keys(static_cast<size_t>(state.Range(0)) * 2, 1);
+    const size_t live = keys.size() / 2;
+    Map map;
+    for (size_t i = 0; i < live; ++i)
+      map.emplace(keys[i], keys[i]);
+
+    size_t oldest = 0;
+    for (auto _ : state)
+    {
+      map.erase(keys[oldest]);
+      const size_t fresh = oldest + live < keys.size() ? oldest + live : oldest + live - keys.size();
+      map.emplace(keys[fresh], keys[fresh]);
+      if (++oldest == keys.size())
+        oldest = 0;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+  // Symbol table lookups by name
+  template <typename Map>
+  void BM_FindString(Bench::State &state)
+  {
+    const std::vector<std::string> names = Names(static_cast<size_t>(state.Range(0)));
+    Map map;
+    for (size_t i = 0; i < names.size(); ++i)
+      map.emplace(names[i], static_cast<u64>(i));
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(map.find(names[next]));
+      if (++next == names.size())
+        next = 0;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  template <typename Map>
+  void BM_Iterate(Bench::State &state)
+  {
+    const std::vector<u64> keys = Keys(static_cast<size_t>(state.Range(0)), 1);
+    Map map;
+    for (u64 key : keys)
+      map.emplace(key, key);
+
+    for (auto _ : state)
+    {
+      u64 sum = 0;
+      for (const auto &entry : map)
+        sum += entry.second;
+      Bench::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * keys.size()));
+  }
+
+  template <typename Set>
+  void BM_SetContains(Bench::State &state)
+  {
+    const std::vector<u64> keys = Keys(static_cast<size_t>(state.Range(0)), 1);
+    const std::vector<u64> probes = Keys(keys.size(), 2);
+    Set set(keys.begin(), keys.end());
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      const u64 key = next & 1 ? keys[next] : probes[next];
+      Bench::DoNotOptimize(set.find(key) != set.end());
+      if (++next == keys.size())
+        next = 0;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  using StdMap = std::unordered_map<u64, u64>;
+  using FlatMap = CustomSTL::flat_hash_map<u64, u64>;
+  using StdStringMap = std::unordered_map<std::string, u64>;
+  using FlatStringMap = CustomSTL::flat_hash_map<std::string, u64>;
+  using StdSet = std::unordered_set<u64>;
+  using FlatSet = CustomSTL::flat_hash_set<u64>;
+}
+
+BENCHMARK_TEMPLATE(BM_Insert, StdMap)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Insert, FlatMap)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_InsertReserved, StdMap)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_InsertReserved, FlatMap)->Arg(1024)->Arg(1 << 20);
+
+BENCHMARK_TEMPLATE(BM_FindHit, StdMap)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_FindHit, FlatMap)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_FindMiss, StdMap)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_FindMiss, FlatMap)->Arg(1024)->Arg(1 << 20);
+
+BENCHMARK_TEMPLATE(BM_Churn, StdMap)->Arg(1024)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_Churn, FlatMap)->Arg(1024)->Arg(1 << 16);
+
+BENCHMARK_TEMPLATE(BM_FindString, StdStringMap)->Arg(1024)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_FindString, FlatStringMap)->Arg(1024)->Arg(1 << 16);
+
+BENCHMARK_TEMPLATE(BM_Iterate, StdMap)->Arg(1024)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_Iterate, FlatMap)->Arg(1024)->Arg(1 << 16);
+
+BENCHMARK_TEMPLATE(BM_SetContains, StdSet)->Arg(1024)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_SetContains, FlatSet)->Arg(1024)->Arg(1 << 20);
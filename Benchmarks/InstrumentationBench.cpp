@@ -0,0 +1,56 @@
+// Cost of the instrumentation macros on the hot path
+
+#include "Benchmark.h"
+
+#include <Utils/Instrumentation.h>
+
+#include <atomic>
+
+namespace
+{
+  void BM_InstrumentCount(Bench::State &state)
+  {
+    for (auto _ : state)
+      INSTRUMENT_COUNT("Bench.Count");
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  // What a shared counter costs instead, even uncontended
+  void BM_SharedAtomicCount(Bench::State &state)
+  {
+    static std::atomic<u64> counter{0};
+    for (auto _ : state)
+      counter.fetch_add(1, std::memory_order_relaxed);
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_InstrumentRecord(Bench::State &state)
+  {
+    u64 value = 0;
+    for (auto _ : state)
+      INSTRUMENT_RECORD("Bench.Record", value++ & 0xFFFF);
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_InstrumentScope(Bench::State &state)
+  {
+    for (auto _ : state)
+    {
+      INSTRUMENT_SCOPE("Bench.Scope");
+      Bench::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_InstrumentationSnapshot(Bench::State &state)
+  {
+    for (auto _ : state)
+      Bench::DoNotOptimize(CustomSTL::Instrumentation::Snapshot());
+  }
+}
+
+BENCHMARK(BM_SharedAtomicCount);
+BENCHMARK(BM_InstrumentCount);
+BENCHMARK(BM_InstrumentRecord);
+BENCHMARK(BM_InstrumentScope);
+BENCHMARK(BM_InstrumentationSnapshot);
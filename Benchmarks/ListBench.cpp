@@ -0,0 +1,152 @@
+// list, chunked_list and intrusive_list against std::list
+
+#include "Benchmark.h"
+
+#include <STLContainers/chunked_list.h>
+#include <STLContainers/intrusive_list.h>
+#include <STLContainers/list.h>
+
+#include <list>
+#include <vector>
+
+namespace
+{
+  struct Item
+  {
+    int value = 0;
+    CustomSTL::intrusive_list_hook hook;
+  };
+
+  using IntrusiveList = CustomSTL::intrusive_list<Item, &Item::hook>;
+
+  template <typename List>
+  void BM_PushBack(Bench::State &state)
+  {
+    const int count = static_cast<int>(state.Range(0));
+    for (auto _ : state)
+    {
+      List list;
+      for (int i = 0; i < count; ++i)
+        list.push_back(i);
+      Bench::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * count);
+  }
+
+  template <typename List>
+  void BM_PushFrontPopBack(Bench::State &state)
+  {
+    const int count = static_cast<int>(state.Range(0));
+    List list;
+    for (int i = 0; i < count; ++i)
+      list.push_back(i);
+
+    int next = count;
+    for (auto _ : state)
+    {
+      list.push_front(next++);
+      list.pop_back();
+    }
+    Bench::DoNotOptimize(list.front());
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  template <typename List>
+  void BM_Iterate(Bench::State &state)
+  {
+    const int count = static_cast<int>(state.Range(0));
+    List list;
+    for (int i = 0; i < count; ++i)
+      list.push_back(i);
+
+    for (auto _ : state)
+    {
+      long sum = 0;
+      for (int value : list)
+        sum += value;
+      Bench::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * count);
+  }
+
+  // Erases every other element while walking the list
+  template <typename List>
+  void BM_EraseAlternate(Bench::State &state)
+  {
+    const int count = static_cast<int>(state.Range(0));
+    for (auto _ : state)
+    {
+      state.PauseTiming();
+      List list;
+      for (int i = 0; i < count; ++i)
+        list.push_back(i);
+      state.ResumeTiming();
+
+      for (auto it = list.begin(); it != list.end();)
+      {
+        it = list.erase(it);
+        if (it != list.end())
+          ++it;
+      }
+      Bench::DoNotOptimize(list);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * (count / 2));
+  }
+
+  // intrusive_list links objects it does not own, so the nodes come from a
+  // vector allocated once and the loop only measures the linking
+  void BM_IntrusivePushBack(Bench::State &state)
+  {
+    const size_t count = static_cast<size_t>(state.Range(0));
+    std::vector<Item> items(count);
+    for (auto _ : state)
+    {
+      IntrusiveList list;
+      for (Item &item : items)
+        list.push_back(item);
+      Bench::DoNotOptimize(list);
+      list.clear();
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * count));
+  }
+
+  void BM_IntrusiveIterate(Bench::State &state)
+  {
+    const size_t count = static_cast<size_t>(state.Range(0));
+    std::vector<Item> items(count);
+    IntrusiveList list;
+    for (size_t i = 0; i < count; ++i)
+    {
+      items[i].value = static_cast<int>(i);
+      list.push_back(items[i]);
+    }
+
+    for (auto _ : state)
+    {
+      long sum = 0;
+      for (const Item &item : list)
+        sum += item.value;
+      Bench::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * count));
+    list.clear();
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_PushBack, std::list<int>)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_PushBack, CustomSTL::list<int>)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_PushBack, CustomSTL::chunked_list<int>)->Arg(64)->Arg(4096);
+BENCHMARK(BM_IntrusivePushBack)->Arg(64)->Arg(4096);
+
+BENCHMARK_TEMPLATE(BM_PushFrontPopBack, std::list<int>)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_PushFrontPopBack, CustomSTL::list<int>)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_PushFrontPopBack, CustomSTL::chunked_list<int>)->Arg(1024);
+
+BENCHMARK_TEMPLATE(BM_Iterate, std::list<int>)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Iterate, CustomSTL::list<int>)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Iterate, CustomSTL::chunked_list<int>)->Arg(4096);
+BENCHMARK(BM_IntrusiveIterate)->Arg(4096);
+
+BENCHMARK_TEMPLATE(BM_EraseAlternate, std::list<int>)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_EraseAlternate, CustomSTL::list<int>)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_EraseAlternate, CustomSTL::chunked_list<int>)->Arg(4096);
@@ -0,0 +1,57 @@
+// Logger throughput with text and binary files. The sink only counts what
+// it is given, so bytes per second over items per second is the size of a
+// record on disk in each format. The rings block when full and the final
+// Flush is timed, so this is the rate the logger thread keeps up with, not
+// just the cost of the call.
+
+#include "Benchmark.h"
+
+#include <Utils/Logger.h>
+
+#include <atomic>
+
+namespace
+{
+  using namespace CustomSTL;
+
+  std::atomic<u64> s_SinkBytes{0};
+
+  class CountingSink : public LogSink
+  {
+  public:
+    void Write(const iovec *chunks, int count) override
+    {
+      u64 bytes = 0;
+      for (int i = 0; i < count; ++i)
+        bytes += chunks[i].iov_len;
+      s_SinkBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  };
+
+  template <LogFileFormat Format>
+  void BM_Log(Bench::State &state)
+  {
+    LoggerOptions options;
+    options.overflow = LogOverflow::Block;
+    options.format = Format;
+    s_SinkBytes.store(0, std::memory_order_relaxed);
+    Logger::Start(MakeUnique<CountingSink>(), options);
+
+    u64 i = 0;
+    for (auto _ : state)
+    {
+      LOG_INFO("request {} from {} took {} us, status {}", i, "worker-7", 12.5 + static_cast<double>(i & 15), i % 3 == 0);
+      ++i;
+    }
+    state.ResumeTiming();
+    Logger::Flush();
+    state.PauseTiming();
+
+    Logger::Stop();
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+    state.SetBytesProcessed(static_cast<i64>(s_SinkBytes.load(std::memory_order_relaxed)));
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_Log, LogFileFormat::Text);
+BENCHMARK_TEMPLATE(BM_Log, LogFileFormat::Binary);
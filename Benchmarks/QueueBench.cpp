@@ -0,0 +1,134 @@
+// Queue and MPSCQueue against a std::queue guarded by a mutex and a
+// condition variable, the textbook blocking queue
+
+#include "Benchmark.h"
+
+#include <Containers/MPSCQueue.h>
+#include <Containers/ThreadQueue.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  template <typename T>
+  class LockedQueue
+  {
+    std::queue<T> queue;
+    std::mutex m;
+    std::condition_variable c;
+
+  public:
+    bool TryEnqueue(T data)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m);
+        queue.push(std::move(data));
+      }
+      c.notify_one();
+      return true;
+    }
+
+    bool Enqueue(T data)
+    {
+      return TryEnqueue(std::move(data));
+    }
+
+    bool TryDequeue(T &output)
+    {
+      std::lock_guard<std::mutex> lock(m);
+      if (queue.empty())
+        return false;
+      output = std::move(queue.front());
+      queue.pop();
+      return true;
+    }
+
+    bool Dequeue(T &output)
+    {
+      std::unique_lock<std::mutex> lock(m);
+      c.wait(lock, [this] { return !queue.empty(); });
+      output = std::move(queue.front());
+      queue.pop();
+      return true;
+    }
+  };
+
+  struct Message : CustomSTL::MPSCNode
+  {
+    u64 value = 0;
+  };
+
+  // Enqueue then dequeue on one thread, the cost of the queue itself
+  // without any contention
+  template <typename Queue>
+  void BM_RoundTrip(Bench::State &state)
+  {
+    Queue queue;
+    u64 next = 0, output = 0;
+    for (auto _ : state)
+    {
+      queue.TryEnqueue(next++);
+      queue.TryDequeue(output);
+      Bench::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+  void BM_MPSCQueueRoundTrip(Bench::State &state)
+  {
+    CustomSTL::MPSCQueue<Message> queue;
+    std::vector<Message> messages(64);
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      queue.Enqueue(&messages[next]);
+      Bench::DoNotOptimize(queue.Dequeue());
+      next = (next + 1) & 63;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+  // Range(0) producer threads feed the benchmark thread, which blocks in
+  // Dequeue whenever it runs dry
+  template <typename Queue>
+  void BM_ProducerConsumer(Bench::State &state)
+  {
+    const u64 producers = static_cast<u64>(state.Range(0));
+    const u64 total = state.Iterations();
+    Queue queue;
+
+    std::vector<std::thread> threads;
+    for (u64 p = 0; p < producers; ++p)
+    {
+      const u64 count = total / producers + (p < total % producers ? 1 : 0);
+      threads.emplace_back([&queue, count] {
+        for (u64 i = 0; i < count; ++i)
+          queue.Enqueue(i);
+      });
+    }
+
+    u64 output = 0;
+    for (auto _ : state)
+    {
+      queue.Dequeue(output);
+      Bench::DoNotOptimize(output);
+    }
+
+    for (std::thread &thread : threads)
+      thread.join();
+    state.SetItemsProcessed(static_cast<i64>(total));
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_RoundTrip, LockedQueue<u64>);
+BENCHMARK_TEMPLATE(BM_RoundTrip, CustomSTL::Queue<u64>);
+BENCHMARK_TEMPLATE(BM_RoundTrip, CustomSTL::Queue<u64, true>);
+BENCHMARK(BM_MPSCQueueRoundTrip);
+
+BENCHMARK_TEMPLATE(BM_ProducerConsumer, LockedQueue<u64>)->Arg(1)->Arg(4);
+BENCHMARK_TEMPLATE(BM_ProducerConsumer, CustomSTL::Queue<u64>)->Arg(1)->Arg(4);
+BENCHMARK_TEMPLATE(BM_ProducerConsumer, CustomSTL::Queue<u64, true>)->Arg(1)->Arg(4);
@@ -0,0 +1,173 @@
+// Random and Sampling against std::mt19937 with the standard distributions
+
+#include "Benchmark.h"
+
+#include <Utils/Random.h>
+#include <Utils/Sampling.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+  void BM_RandomFloat(Bench::State &state)
+  {
+    Random::Seed(1);
+    for (auto _ : state)
+      Bench::DoNotOptimize(Random::RandomFloat());
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_StdUniformReal(Bench::State &state)
+  {
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    for (auto _ : state)
+      Bench::DoNotOptimize(distribution(engine));
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_RandomUIntRange(Bench::State &state)
+  {
+    Random::Seed(1);
+    for (auto _ : state)
+      Bench::DoNotOptimize(Random::RandomUIntRange(0, 999));
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_StdUniformInt(Bench::State &state)
+  {
+    std::mt19937 engine(1);
+    std::uniform_int_distribution<unsigned> distribution(0, 999);
+    for (auto _ : state)
+      Bench::DoNotOptimize(distribution(engine));
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  // Bulk generation into a buffer of Range(0) floats
+  void BM_RandomFill(Bench::State &state)
+  {
+    Random::Seed(1);
+    std::vector<float> out(static_cast<size_t>(state.Range(0)));
+    for (auto _ : state)
+    {
+      Random::Fill(out, -1.0f, 1.0f);
+      Bench::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * out.size()));
+  }
+
+  void BM_StdFill(Bench::State &state)
+  {
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> out(static_cast<size_t>(state.Range(0)));
+    for (auto _ : state)
+    {
+      for (float &value : out)
+        value = distribution(engine);
+      Bench::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * out.size()));
+  }
+
+  void BM_RandomFillNormal(Bench::State &state)
+  {
+    Random::Seed(1);
+    std::vector<float> out(static_cast<size_t>(state.Range(0)));
+    for (auto _ : state)
+    {
+      Random::FillNormal(out, 0.0f, 1.0f);
+      Bench::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * out.size()));
+  }
+
+  void BM_StdFillNormal(Bench::State &state)
+  {
+    std::mt19937 engine(1);
+    std::normal_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<float> out(static_cast<size_t>(state.Range(0)));
+    for (auto _ : state)
+    {
+      for (float &value : out)
+        value = distribution(engine);
+      Bench::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * out.size()));
+  }
+
+  void BM_RandomShuffle(Bench::State &state)
+  {
+    Random::Seed(1);
+    std::vector<u32> items(static_cast<size_t>(state.Range(0)));
+    for (size_t i = 0; i < items.size(); ++i)
+      items[i] = static_cast<u32>(i);
+    for (auto _ : state)
+    {
+      Random::Shuffle(std::span<u32>(items));
+      Bench::DoNotOptimize(items.data());
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * items.size()));
+  }
+
+  void BM_StdShuffle(Bench::State &state)
+  {
+    std::mt19937 engine(1);
+    std::vector<u32> items(static_cast<size_t>(state.Range(0)));
+    for (size_t i = 0; i < items.size(); ++i)
+      items[i] = static_cast<u32>(i);
+    for (auto _ : state)
+    {
+      std::shuffle(items.begin(), items.end(), engine);
+      Bench::DoNotOptimize(items.data());
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * items.size()));
+  }
+
+  // Weighted choice among Range(0) outcomes
+  std::vector<double> Weights(size_t count)
+  {
+    std::vector<double> weights(count);
+    for (size_t i = 0; i < count; ++i)
+      weights[i] = 1.0 + static_cast<double>(i % 7);
+    return weights;
+  }
+
+  void BM_AliasTableSample(Bench::State &state)
+  {
+    Random::Seed(1);
+    const std::vector<double> weights = Weights(static_cast<size_t>(state.Range(0)));
+    const AliasTable table{std::span<const double>(weights)};
+    for (auto _ : state)
+      Bench::DoNotOptimize(table.Sample());
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  void BM_StdDiscreteDistribution(Bench::State &state)
+  {
+    std::mt19937 engine(1);
+    const std::vector<double> weights = Weights(static_cast<size_t>(state.Range(0)));
+    std::discrete_distribution<u32> distribution(weights.begin(), weights.end());
+    for (auto _ : state)
+      Bench::DoNotOptimize(distribution(engine));
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+}
+
+BENCHMARK(BM_StdUniformReal);
+BENCHMARK(BM_RandomFloat);
+BENCHMARK(BM_StdUniformInt);
+BENCHMARK(BM_RandomUIntRange);
+
+BENCHMARK(BM_StdFill)->Arg(4096);
+BENCHMARK(BM_RandomFill)->Arg(4096);
+BENCHMARK(BM_StdFillNormal)->Arg(4096);
+BENCHMARK(BM_RandomFillNormal)->Arg(4096);
+
+BENCHMARK(BM_StdShuffle)->Arg(4096);
+BENCHMARK(BM_RandomShuffle)->Arg(4096);
+
+BENCHMARK(BM_StdDiscreteDistribution)->Arg(16)->Arg(1024);
+BENCHMARK(BM_AliasTableSample)->Arg(16)->Arg(1024);
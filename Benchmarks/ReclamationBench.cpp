@@ -0,0 +1,172 @@
+// Epoch-based reclamation against hazard pointers: the cost of a read-side
+// guard alone, and a Treiber stack freeing its nodes with each of them next
+// to the same stack behind a mutex
+
+#include "Benchmark.h"
+
+#include <Utils/EpochReclamation.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  using CustomSTL::EpochReclamation;
+  using CustomSTL::HazardPointers;
+
+  struct Node
+  {
+    u64 value;
+    Node *next;
+  };
+
+  class MutexStack
+  {
+    std::vector<u64> values;
+    std::mutex m;
+
+  public:
+    void Push(u64 value)
+    {
+      std::lock_guard<std::mutex> lock(m);
+      values.push_back(value);
+    }
+
+    bool Pop(u64 &value)
+    {
+      std::lock_guard<std::mutex> lock(m);
+      if (values.empty())
+        return false;
+      value = values.back();
+      values.pop_back();
+      return true;
+    }
+  };
+
+  class TreiberStack
+  {
+  protected:
+    std::atomic<Node *> head{nullptr};
+
+  public:
+    void Push(u64 value)
+    {
+      Node *node = new Node{value, head.load(std::memory_order_relaxed)};
+      while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    }
+  };
+
+  // The guard keeps the head alive while its next pointer is read
+  class EpochStack : public TreiberStack
+  {
+  public:
+    ~EpochStack()
+    {
+      u64 value;
+      while (Pop(value))
+        ;
+      EpochReclamation::Synchronize();
+    }
+
+    bool Pop(u64 &value)
+    {
+      Node *node;
+      {
+        EpochReclamation::Guard guard;
+        node = head.load(std::memory_order_acquire);
+        while (node && !head.compare_exchange_weak(node, node->next, std::memory_order_acquire))
+          ;
+        if (!node)
+          return false;
+        value = node->value;
+      }
+      EpochReclamation::Retire(node);
+      return true;
+    }
+  };
+
+  class HazardStack : public TreiberStack
+  {
+  public:
+    ~HazardStack()
+    {
+      u64 value;
+      while (Pop(value))
+        ;
+      HazardPointers::Reclaim();
+    }
+
+    bool Pop(u64 &value)
+    {
+      HazardPointers::Guard guard;
+      while (Node *node = guard.Protect(head))
+      {
+        if (head.compare_exchange_strong(node, node->next, std::memory_order_acquire))
+        {
+          value = node->value;
+          guard.Reset();
+          HazardPointers::Retire(node);
+          return true;
+        }
+      }
+      return false;
+    }
+  };
+
+  template <typename Guard>
+  void BM_Guard(Bench::State &state)
+  {
+    for (auto _ : state)
+    {
+      Guard guard;
+      Bench::DoNotOptimize(guard);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  // A push and a pop per iteration, Range(0) threads each doing as many
+  // as the benchmark thread
+  template <typename Stack>
+  void BM_PushPop(Bench::State &state)
+  {
+    const u64 threads = static_cast<u64>(state.Range(0));
+    const u64 count = state.Iterations();
+    Stack stack;
+    for (u64 i = 0; i < 1024; ++i)
+      stack.Push(i);
+
+    std::vector<std::thread> helpers;
+    for (u64 t = 1; t < threads; ++t)
+      helpers.emplace_back([&stack, count] {
+        u64 value = 0;
+        for (u64 i = 0; i < count; ++i)
+        {
+          stack.Push(i);
+          stack.Pop(value);
+        }
+        Bench::DoNotOptimize(value);
+      });
+
+    u64 value = 0, i = 0;
+    for (auto _ : state)
+    {
+      stack.Push(i++);
+      stack.Pop(value);
+    }
+    Bench::DoNotOptimize(value);
+
+    for (std::thread &helper : helpers)
+      helper.join();
+    state.SetItemsProcessed(static_cast<i64>(count * threads * 2));
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_Guard, EpochReclamation::Guard);
+BENCHMARK_TEMPLATE(BM_Guard, HazardPointers::Guard);
+
+BENCHMARK_TEMPLATE(BM_PushPop, MutexStack)->Arg(1)->Arg(4);
+BENCHMARK_TEMPLATE(BM_PushPop, EpochStack)->Arg(1)->Arg(4);
+BENCHMARK_TEMPLATE(BM_PushPop, HazardStack)->Arg(1)->Arg(4);
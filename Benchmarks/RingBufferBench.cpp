@@ -0,0 +1,197 @@
+// RingBuffer, MappedRingBuffer, SharedRingBuffer and BroadcastRing against
+// std::deque used as a FIFO
+
+#include "Benchmark.h"
+
+#include <Containers/BroadcastRing.h>
+#include <Containers/RingBuffer.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#ifdef __linux__
+#include <Containers/MappedRingBuffer.h>
+#include <Containers/SharedRingBuffer.h>
+
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  // RingBuffer masks indices with N, so N + 1 has to be a power of 2
+  constexpr size_t RING_CAPACITY = 1023;
+
+  // One in, one out with the ring kept half full
+  template <bool Stats>
+  void BM_RingBufferRoundTrip(Bench::State &state)
+  {
+    CustomSTL::RingBuffer<u64, RING_CAPACITY, Stats> ring;
+    for (u64 i = 0; i < RING_CAPACITY / 2; ++i)
+      ring.Enqueue(i);
+
+    u64 next = 0, output = 0;
+    for (auto _ : state)
+    {
+      ring.Enqueue(next++);
+      ring.Dequeue(output);
+      Bench::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+  void BM_DequeRoundTrip(Bench::State &state)
+  {
+    std::deque<u64> deque;
+    for (u64 i = 0; i < RING_CAPACITY / 2; ++i)
+      deque.push_back(i);
+
+    u64 next = 0, output = 0;
+    for (auto _ : state)
+    {
+      deque.push_back(next++);
+      output = deque.front();
+      deque.pop_front();
+      Bench::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+#ifdef __linux__
+  void BM_MappedRingBufferRoundTrip(Bench::State &state)
+  {
+    CustomSTL::MappedRingBuffer<u64> ring(RING_CAPACITY + 1);
+    for (u64 i = 0; i < RING_CAPACITY / 2; ++i)
+      ring.Enqueue(i);
+
+    u64 next = 0, output = 0;
+    for (auto _ : state)
+    {
+      ring.Enqueue(next++);
+      ring.Dequeue(output);
+      Bench::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+  void BM_SharedRingBufferRoundTrip(Bench::State &state)
+  {
+    const std::string name = "/CustomSTLBench" + std::to_string(getpid());
+    auto ring = CustomSTL::SharedRingBuffer<u64>::Create(name, RING_CAPACITY + 1);
+    CustomSTL::SharedRingBuffer<u64>::Unlink(name);
+    for (u64 i = 0; i < RING_CAPACITY / 2; ++i)
+      ring->Enqueue(i);
+
+    u64 next = 0, output = 0;
+    for (auto _ : state)
+    {
+      ring->Enqueue(next++);
+      ring->Dequeue(output);
+      Bench::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+#endif
+
+  // Fill completely, then drain
+  void BM_RingBufferBurst(Bench::State &state)
+  {
+    CustomSTL::RingBuffer<u64, RING_CAPACITY> ring;
+    u64 output = 0;
+    for (auto _ : state)
+    {
+      for (u64 i = 0; i < RING_CAPACITY; ++i)
+        ring.Enqueue(i);
+      while (ring.Dequeue(output))
+        Bench::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * RING_CAPACITY * 2));
+  }
+
+  void BM_DequeBurst(Bench::State &state)
+  {
+    std::deque<u64> deque;
+    u64 output = 0;
+    for (auto _ : state)
+    {
+      for (u64 i = 0; i < RING_CAPACITY; ++i)
+        deque.push_back(i);
+      while (!deque.empty())
+      {
+        output = deque.front();
+        deque.pop_front();
+        Bench::DoNotOptimize(output);
+      }
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * RING_CAPACITY * 2));
+  }
+
+#ifdef __linux__
+  // Bulk copy in and out through the contiguous views the mirror mapping
+  // allows, Range(0) bytes at a time
+  void BM_MappedRingBufferSpans(Bench::State &state)
+  {
+    const size_t chunk = static_cast<size_t>(state.Range(0));
+    CustomSTL::MappedRingBuffer<byte> ring(1 << 16);
+    std::vector<byte> input(chunk, byte{1}), output(chunk);
+    for (auto _ : state)
+    {
+      ring.Write(input.data(), chunk);
+      std::span<const byte> view = ring.ReadSpan();
+      std::memcpy(output.data(), view.data(), view.size());
+      ring.Consume(view.size());
+      Bench::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * chunk * 2));
+  }
+#endif
+
+  void BM_DequeSpans(Bench::State &state)
+  {
+    const size_t chunk = static_cast<size_t>(state.Range(0));
+    std::deque<byte> deque;
+    std::vector<byte> input(chunk, byte{1}), output(chunk);
+    for (auto _ : state)
+    {
+      deque.insert(deque.end(), input.begin(), input.end());
+      std::copy(deque.begin(), deque.end(), output.begin());
+      deque.clear();
+      Bench::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * chunk * 2));
+  }
+
+  // Publish one message and have one reader take it
+  void BM_BroadcastRingRoundTrip(Bench::State &state)
+  {
+    CustomSTL::BroadcastRing<u64, 1024> ring;
+    auto reader = ring.Subscribe();
+    u64 next = 0, output = 0;
+    for (auto _ : state)
+    {
+      ring.Publish(next++);
+      reader.TryRead(output);
+      Bench::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+}
+
+BENCHMARK(BM_DequeRoundTrip);
+BENCHMARK_TEMPLATE(BM_RingBufferRoundTrip, false);
+BENCHMARK_TEMPLATE(BM_RingBufferRoundTrip, true);
+BENCHMARK(BM_BroadcastRingRoundTrip);
+#ifdef __linux__
+BENCHMARK(BM_MappedRingBufferRoundTrip);
+BENCHMARK(BM_SharedRingBufferRoundTrip);
+#endif
+
+BENCHMARK(BM_DequeBurst);
+BENCHMARK(BM_RingBufferBurst);
+
+BENCHMARK(BM_DequeSpans)->Arg(256)->Arg(4096);
+#ifdef __linux__
+BENCHMARK(BM_MappedRingBufferSpans)->Arg(256)->Arg(4096);
+#endif
@@ -0,0 +1,120 @@
+// simd algorithms at each instruction set level over 4M elements,
+// Range(0) is the level: 0 scalar, 1 SSE2, 2 AVX2
+
+#include "Benchmark.h"
+
+#include <Utils/SimdAlgorithms.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  namespace simd = CustomSTL::simd;
+
+  constexpr size_t COUNT = 1 << 22;
+
+  template <typename T>
+  std::vector<T> Values()
+  {
+    std::vector<T> values(COUNT);
+    u64 state = 1;
+    for (T &value : values)
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      value = static_cast<T>((state >> 33) % 100);
+    }
+    return values;
+  }
+
+  // Restores the detected level when the benchmark ends
+  class LevelScope
+  {
+  public:
+    explicit LevelScope(Bench::State &state)
+    {
+      const auto wanted = static_cast<simd::level>(state.Range(0));
+      if (wanted > simd::detected_level())
+        state.SkipWithError("instruction set not supported by this CPU");
+      simd::set_level(wanted);
+    }
+
+    ~LevelScope()
+    {
+      simd::set_level(simd::detected_level());
+    }
+  };
+
+  template <typename T>
+  void BM_Sum(Bench::State &state)
+  {
+    const std::vector<T> values = Values<T>();
+    LevelScope level(state);
+    for (auto _ : state)
+      Bench::DoNotOptimize(simd::sum(values));
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * COUNT * sizeof(T)));
+  }
+
+  template <typename T>
+  void BM_Max(Bench::State &state)
+  {
+    const std::vector<T> values = Values<T>();
+    LevelScope level(state);
+    for (auto _ : state)
+      Bench::DoNotOptimize(simd::max(values));
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * COUNT * sizeof(T)));
+  }
+
+  template <typename T>
+  void BM_CountIf(Bench::State &state)
+  {
+    const std::vector<T> values = Values<T>();
+    LevelScope level(state);
+    for (auto _ : state)
+      Bench::DoNotOptimize(simd::count_if(values, simd::compare_op::gt, T(90)));
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * COUNT * sizeof(T)));
+  }
+
+  template <typename T>
+  void BM_Transform(Bench::State &state)
+  {
+    const std::vector<T> values = Values<T>();
+    std::vector<T> output(COUNT);
+    LevelScope level(state);
+    for (auto _ : state)
+    {
+      simd::transform(values, output, simd::transform_op::mul, T(3));
+      Bench::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * COUNT * sizeof(T) * 2));
+  }
+
+  // Byte search for a byte that is not there, against memchr
+  void BM_FindByte(Bench::State &state)
+  {
+    const std::vector<u8> bytes = Values<u8>();
+    LevelScope level(state);
+    for (auto _ : state)
+      Bench::DoNotOptimize(simd::find(bytes, u8(200)));
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * COUNT));
+  }
+
+  void BM_Memchr(Bench::State &state)
+  {
+    const std::vector<u8> bytes = Values<u8>();
+    for (auto _ : state)
+      Bench::DoNotOptimize(std::memchr(bytes.data(), 200, bytes.size()));
+    state.SetBytesProcessed(static_cast<i64>(state.Iterations() * COUNT));
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_Sum, i32)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_TEMPLATE(BM_Sum, f32)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_TEMPLATE(BM_Max, i32)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_TEMPLATE(BM_Max, f64)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_TEMPLATE(BM_CountIf, f32)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_TEMPLATE(BM_CountIf, u16)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_TEMPLATE(BM_Transform, i32)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_TEMPLATE(BM_Transform, f32)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_FindByte)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_Memchr);
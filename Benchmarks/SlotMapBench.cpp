@@ -0,0 +1,182 @@
+// slot_map against the handle patterns it replaces, a std::unordered_map
+// keyed by an increasing id and a std::list searched with find_if
+
+#include "Benchmark.h"
+
+#include <STLContainers/slot_map.h>
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  // The three stores behind one interface: Insert returns a handle, Find
+  // returns a pointer or nullptr
+  class SlotMapStore
+  {
+    CustomSTL::slot_map<u64> map;
+
+  public:
+    using Handle = CustomSTL::slot_map_key;
+
+    Handle Insert(u64 value) { return map.insert(value); }
+    void Erase(Handle handle) { map.erase(handle); }
+    u64 *Find(Handle handle) { return map.find(handle); }
+
+    template <typename Function>
+    void ForEach(Function function)
+    {
+      for (u64 &value : map)
+        function(value);
+    }
+  };
+
+  class HashMapStore
+  {
+    std::unordered_map<u64, u64> map;
+    u64 top = 1;
+
+  public:
+    using Handle = u64;
+
+    Handle Insert(u64 value)
+    {
+      map.emplace(top, value);
+      return top++;
+    }
+
+    void Erase(Handle handle) { map.erase(handle); }
+
+    u64 *Find(Handle handle)
+    {
+      auto found = map.find(handle);
+      return found == map.end() ? nullptr : &found->second;
+    }
+
+    template <typename Function>
+    void ForEach(Function function)
+    {
+      for (auto &entry : map)
+        function(entry.second);
+    }
+  };
+
+  // What ActionList does today
+  class ListStore
+  {
+    std::list<std::pair<u64, u64>> list;
+    u64 top = 1;
+
+  public:
+    using Handle = u64;
+
+    Handle Insert(u64 value)
+    {
+      list.emplace_back(top, value);
+      return top++;
+    }
+
+    void Erase(Handle handle)
+    {
+      auto found = std::find_if(list.begin(), list.end(), [handle](const auto &entry) { return entry.first == handle; });
+      if (found != list.end())
+        list.erase(found);
+    }
+
+    u64 *Find(Handle handle)
+    {
+      auto found = std::find_if(list.begin(), list.end(), [handle](const auto &entry) { return entry.first == handle; });
+      return found == list.end() ? nullptr : &found->second;
+    }
+
+    template <typename Function>
+    void ForEach(Function function)
+    {
+      for (auto &entry : list)
+        function(entry.second);
+    }
+  };
+
+  // Range(0) live elements, then Find by handles in a scattered order
+  template <typename Store>
+  void BM_Lookup(Bench::State &state)
+  {
+    const size_t count = static_cast<size_t>(state.Range(0));
+    Store store;
+    std::vector<typename Store::Handle> handles;
+    for (size_t i = 0; i < count; ++i)
+      handles.push_back(store.Insert(i));
+    for (size_t i = 0; i < count; ++i)
+      std::swap(handles[i], handles[(i * 7919) % count]);
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      Bench::DoNotOptimize(store.Find(handles[next]));
+      if (++next == count)
+        next = 0;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()));
+  }
+
+  // Erase the oldest handle and insert a new one with Range(0) live
+  template <typename Store>
+  void BM_Churn(Bench::State &state)
+  {
+    const size_t count = static_cast<size_t>(state.Range(0));
+    Store store;
+    std::vector<typename Store::Handle> handles;
+    for (size_t i = 0; i < count; ++i)
+      handles.push_back(store.Insert(i));
+
+    size_t oldest = 0;
+    u64 next = count;
+    for (auto _ : state)
+    {
+      store.Erase(handles[oldest]);
+      handles[oldest] = store.Insert(next++);
+      if (++oldest == count)
+        oldest = 0;
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations()) * 2);
+  }
+
+  // Full scan after the same churn, so the stores are not in their
+  // freshly built layout
+  template <typename Store>
+  void BM_Iterate(Bench::State &state)
+  {
+    const size_t count = static_cast<size_t>(state.Range(0));
+    Store store;
+    std::vector<typename Store::Handle> handles;
+    for (size_t i = 0; i < count; ++i)
+      handles.push_back(store.Insert(i));
+    for (size_t i = 0; i < count; i += 3)
+      store.Erase(handles[i]);
+    for (size_t i = 0; i < count; i += 3)
+      store.Insert(i);
+
+    for (auto _ : state)
+    {
+      u64 sum = 0;
+      store.ForEach([&sum](u64 value) { sum += value; });
+      Bench::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<i64>(state.Iterations() * count));
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_Lookup, ListStore)->Arg(64);
+BENCHMARK_TEMPLATE(BM_Lookup, HashMapStore)->Arg(64)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Lookup, SlotMapStore)->Arg(64)->Arg(65536);
+
+BENCHMARK_TEMPLATE(BM_Churn, ListStore)->Arg(64);
+BENCHMARK_TEMPLATE(BM_Churn, HashMapStore)->Arg(64)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Churn, SlotMapStore)->Arg(64)->Arg(65536);
+
+BENCHMARK_TEMPLATE(BM_Iterate, ListStore)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Iterate, HashMapStore)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Iterate, SlotMapStore)->Arg(65536);
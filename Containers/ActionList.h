@@ -2,6 +2,10 @@
 #include <Utils/NonCopyable.h>
 #include <Types/Base.h>
 
+#include <algorithm>
+#include <list>
+#include <utility>
+
 namespace CustomSTL
 {
   template <typename... ActionArgs>
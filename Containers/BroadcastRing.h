@@ -0,0 +1,165 @@
+/**********************************************************************************
+* \brief  Single-producer, multi-reader broadcast ring (disruptor style).
+*         Every reader has its own cursor and sees every message, messages are
+*         read in place without being copied out of the ring. The producer
+*         never waits for readers, it simply overwrites the oldest slot.
+*
+*         Each slot carries a sequence number. A reader that falls more than
+*         N messages behind finds a newer sequence in the slot it expected,
+*         reports Lapped and skips forward to the oldest message still held.
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+#include <Utils/NonCopyable.h>
+
+#include <atomic>
+#include <type_traits>
+
+namespace CustomSTL
+{
+  enum class BroadcastStatus
+  {
+    Ok,     // A message was read
+    Empty,  // The reader is caught up
+    Lapped  // The producer overwrote messages the reader had not read yet
+  };
+
+  // Power of 2 for N only
+  template <typename T, size_t N>
+  class BroadcastRing : NonCopyable
+  {
+    static_assert(N && (N & (N - 1)) == 0, "N must be a power of 2");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Readers race with the producer, T must be trivially copyable");
+
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr u64 mask = N - 1;
+
+    // seq is 2 * s + 1 while message s is being written, 2 * s + 2 once it
+    // is published and 0 before the slot is first used
+    struct alignas(CACHE_LINE) Slot
+    {
+      std::atomic<u64> seq{0};
+      T value;
+    };
+
+    UniquePtr<Slot[]> slots;
+    alignas(CACHE_LINE) std::atomic<u64> cursor{0};
+
+  public:
+    class Reader
+    {
+      const BroadcastRing *ring;
+      u64 next;
+      u64 missed = 0;
+
+      friend class BroadcastRing;
+      Reader(const BroadcastRing *ring, u64 next) : ring(ring), next(next) {}
+
+    public:
+      // Calls func(const T &) on the next message in place. When the result
+      // is Lapped the message was overwritten during the call and whatever
+      // func computed must be discarded.
+      template <typename Func>
+      BroadcastStatus Read(Func &&func)
+      {
+        const Slot &slot = ring->slots[next & mask];
+        const u64 expected = 2 * next + 2;
+
+        u64 before = slot.seq.load(std::memory_order_acquire);
+        if (before < expected)
+          return BroadcastStatus::Empty;
+        if (before > expected)
+          return Resync();
+
+        func(slot.value);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != before)
+          return Resync();
+
+        ++next;
+        return BroadcastStatus::Ok;
+      }
+
+      // Copying variant of Read, output is only valid when Ok is returned
+      BroadcastStatus TryRead(T &output)
+      {
+        return Read([&output](const T &value) { output = value; });
+      }
+
+      // Sequence number of the next message this reader will see
+      u64 Position() const
+      {
+        return next;
+      }
+
+      // Messages skipped because the reader was lapped
+      u64 Missed() const
+      {
+        return missed;
+      }
+
+      // Messages published but not read yet, may exceed N when lapped
+      u64 Backlog() const
+      {
+        return ring->cursor.load(std::memory_order_acquire) - next;
+      }
+
+    private:
+      BroadcastStatus Resync()
+      {
+        u64 published = ring->cursor.load(std::memory_order_acquire);
+        // Skip to the oldest message that is still in the ring, leaving a
+        // slot of slack for the one the producer is writing right now
+        u64 oldest = published > N ? published - N + 1 : 0;
+        if (oldest > next)
+        {
+          missed += oldest - next;
+          next = oldest;
+        }
+        return BroadcastStatus::Lapped;
+      }
+    };
+
+    BroadcastRing() : slots(MakeUnique<Slot[]>(N)) {}
+
+    // Producer only
+    void Publish(const T &data)
+    {
+      u64 s = cursor.load(std::memory_order_relaxed);
+      Slot &slot = slots[s & mask];
+
+      slot.seq.store(2 * s + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      slot.value = data;
+      slot.seq.store(2 * s + 2, std::memory_order_release);
+      cursor.store(s + 1, std::memory_order_release);
+    }
+
+    // New reader that starts with the next message to be published
+    Reader Subscribe() const
+    {
+      return Reader(this, cursor.load(std::memory_order_acquire));
+    }
+
+    // New reader that starts with the oldest message still in the ring
+    Reader SubscribeFromOldest() const
+    {
+      u64 published = cursor.load(std::memory_order_acquire);
+      return Reader(this, published > N ? published - N + 1 : 0);
+    }
+
+    // Number of messages published so far
+    u64 Published() const
+    {
+      return cursor.load(std::memory_order_acquire);
+    }
+
+    size_t Capacity() const
+    {
+      return N;
+    }
+  };
+}
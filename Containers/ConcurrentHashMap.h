@@ -0,0 +1,219 @@
+/**********************************************************************************
+* \brief  Hash map shared between threads, for read-mostly lookup tables.
+*
+*         Keys are spread over a power of 2 number of shards, each a
+*         flat_hash_map behind its own std::shared_mutex and on its own cache
+*         lines. Readers of different shards never touch the same memory and
+*         readers of the same shard only share its lock word, so lookups keep
+*         scaling as long as there are several times more shards than
+*         threads. Writers only block the shard they write to.
+*
+*         Values are copied out, or visited in place under the shard's lock,
+*         never handed out by reference since a writer may move them.
+*         ForEach walks one shard at a time, so it never holds up the whole
+*         map, but it is only consistent per shard.
+**********************************************************************************/
+
+#pragma once
+
+#include <Types/Base.h>
+#include <Utils/NonCopyable.h>
+#include <STLContainers/flat_hash_map.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+
+namespace CustomSTL
+{
+  template <typename Key, typename Value, typename Hash = flat_hash<Key>, typename KeyEqual = flat_equal<Key>>
+  class ConcurrentHashMap : NonCopyable
+  {
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Shard
+    {
+      mutable std::shared_mutex m;
+      flat_hash_map<Key, Value, Hash, KeyEqual> map;
+      std::atomic<size_t> count{0};   // map.size(), readable without the lock
+    };
+
+    std::unique_ptr<Shard[]> m_Shards;
+    size_t m_Mask;
+    [[no_unique_address]] Hash m_Hash;
+
+    // Fibonacci hashing of the key's hash. flat_hash_map mixes the same
+    // hash differently for its slots, so a shard's keys still spread
+    // over all of its slots.
+    template <typename K>
+    Shard &ShardFor(const K &key) const
+    {
+      const u64 hash = static_cast<u64>(m_Hash(key)) * 0x9E3779B97F4A7C15ULL;
+      return m_Shards[static_cast<size_t>(hash >> 40) & m_Mask];
+    }
+
+    static void NoteSize(Shard &shard)
+    {
+      shard.count.store(shard.map.size(), std::memory_order_relaxed);
+    }
+
+  public:
+    // 4 shards per hardware thread, rounded up to a power of 2
+    static size_t DefaultShardCount()
+    {
+      const size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+      return std::bit_ceil(threads * 4);
+    }
+
+    explicit ConcurrentHashMap(size_t shardCount = DefaultShardCount())
+      : m_Shards(std::make_unique<Shard[]>(std::bit_ceil(std::max<size_t>(shardCount, 1)))),
+        m_Mask(std::bit_ceil(std::max<size_t>(shardCount, 1)) - 1)
+    {
+    }
+
+    size_t ShardCount() const
+    {
+      return m_Mask + 1;
+    }
+
+    // Copies the value out. Returns false if the key is absent.
+    template <typename K>
+    bool Find(const K &key, Value &output) const
+    {
+      const Shard &shard = ShardFor(key);
+      std::shared_lock<std::shared_mutex> lock(shard.m);
+      auto found = shard.map.find(key);
+      if (found == shard.map.end())
+        return false;
+      output = found->second;
+      return true;
+    }
+
+    template <typename K>
+    bool Contains(const K &key) const
+    {
+      const Shard &shard = ShardFor(key);
+      std::shared_lock<std::shared_mutex> lock(shard.m);
+      return shard.map.contains(key);
+    }
+
+    // Calls visitor(const Value &) under the shard's shared lock, for values
+    // too large to copy out. The visitor must not touch the map.
+    template <typename K, typename Visitor>
+    bool Visit(const K &key, Visitor &&visitor) const
+    {
+      const Shard &shard = ShardFor(key);
+      std::shared_lock<std::shared_mutex> lock(shard.m);
+      auto found = shard.map.find(key);
+      if (found == shard.map.end())
+        return false;
+      visitor(std::as_const(found->second));
+      return true;
+    }
+
+    // Returns false, leaving the map unchanged, if the key is present
+    bool Insert(Key key, Value value)
+    {
+      Shard &shard = ShardFor(key);
+      std::unique_lock<std::shared_mutex> lock(shard.m);
+      const bool inserted = shard.map.try_emplace(std::move(key), std::move(value)).second;
+      NoteSize(shard);
+      return inserted;
+    }
+
+    // Returns true if the key was inserted, false if its value was replaced
+    bool InsertOrAssign(Key key, Value value)
+    {
+      Shard &shard = ShardFor(key);
+      std::unique_lock<std::shared_mutex> lock(shard.m);
+      const bool inserted = shard.map.insert_or_assign(std::move(key), std::move(value)).second;
+      NoteSize(shard);
+      return inserted;
+    }
+
+    // Calls updater(Value &) under the shard's exclusive lock, for
+    // read-modify-write. Returns false if the key is absent.
+    template <typename K, typename Updater>
+    bool Update(const K &key, Updater &&updater)
+    {
+      Shard &shard = ShardFor(key);
+      std::unique_lock<std::shared_mutex> lock(shard.m);
+      auto found = shard.map.find(key);
+      if (found == shard.map.end())
+        return false;
+      updater(found->second);
+      return true;
+    }
+
+    template <typename K>
+    bool Erase(const K &key)
+    {
+      Shard &shard = ShardFor(key);
+      std::unique_lock<std::shared_mutex> lock(shard.m);
+      const bool erased = shard.map.erase(key) != 0;
+      NoteSize(shard);
+      return erased;
+    }
+
+    // Calls visitor(const Key &, const Value &) for every entry, holding one
+    // shard's shared lock at a time. Entries written meanwhile in shards
+    // not yet visited are seen, those in shards already visited are not.
+    template <typename Visitor>
+    void ForEach(Visitor &&visitor) const
+    {
+      for (size_t i = 0; i <= m_Mask; ++i)
+      {
+        const Shard &shard = m_Shards[i];
+        std::shared_lock<std::shared_mutex> lock(shard.m);
+        for (const auto &entry : shard.map)
+          visitor(entry.first, entry.second);
+      }
+    }
+
+    // Sum of the shard sizes without taking any lock, exact only while no
+    // writer is running
+    size_t Size() const
+    {
+      size_t size = 0;
+      for (size_t i = 0; i <= m_Mask; ++i)
+        size += m_Shards[i].count.load(std::memory_order_relaxed);
+      return size;
+    }
+
+    bool Empty() const
+    {
+      return Size() == 0;
+    }
+
+    // Clears one shard at a time
+    void Clear()
+    {
+      for (size_t i = 0; i <= m_Mask; ++i)
+      {
+        Shard &shard = m_Shards[i];
+        std::unique_lock<std::shared_mutex> lock(shard.m);
+        shard.map.clear();
+        NoteSize(shard);
+      }
+    }
+
+    // Reserves count / ShardCount() entries per shard, with some slack since
+    // keys do not split evenly
+    void Reserve(size_t count)
+    {
+      const size_t perShard = count / (m_Mask + 1);
+      const size_t slack = perShard / 8 + 8;
+      for (size_t i = 0; i <= m_Mask; ++i)
+      {
+        Shard &shard = m_Shards[i];
+        std::unique_lock<std::shared_mutex> lock(shard.m);
+        shard.map.reserve(perShard + slack);
+      }
+    }
+  };
+}
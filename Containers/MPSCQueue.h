@@ -0,0 +1,148 @@
+/**********************************************************************************
+* \brief  This file contains an intrusive, unbounded multi-producer single-consumer
+*         queue (Vyukov style). Enqueue is wait-free and never allocates, items
+*         carry their own link by deriving from MPSCNode. Only one thread may
+*         dequeue.
+*
+*         With Wakeup enabled the consumer can sleep in Wait() and is woken by
+*         producers through std::atomic wait/notify, which is a futex on Linux.
+*         Producers only pay for the notify when the consumer is asleep.
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+#include <Utils/NonCopyable.h>
+
+#include <atomic>
+#include <concepts>
+
+namespace CustomSTL
+{
+  struct MPSCNode
+  {
+    std::atomic<MPSCNode *> next{nullptr};
+  };
+
+  template <typename T, bool Wakeup = false>
+    requires std::derived_from<T, MPSCNode>
+  class MPSCQueue : NonCopyable
+  {
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Producers swap the head, the consumer owns the tail, kept apart so
+    // producers do not invalidate the consumer's line on every push
+    alignas(CACHE_LINE) std::atomic<MPSCNode *> head;
+    alignas(CACHE_LINE) MPSCNode *tail;
+    MPSCNode stub;
+
+    alignas(CACHE_LINE) std::atomic<u32> signal{0};
+    std::atomic<bool> sleeping{false};
+
+    void Push(MPSCNode *node)
+    {
+      node->next.store(nullptr, std::memory_order_relaxed);
+      MPSCNode *prev = head.exchange(node, std::memory_order_acq_rel);
+      // Between the exchange and this store the chain is briefly broken,
+      // Dequeue treats that window as empty
+      prev->next.store(node, std::memory_order_release);
+    }
+
+  public:
+    MPSCQueue() : head(&stub), tail(&stub) {}
+
+    // Wait-free, safe from any number of threads
+    void Enqueue(T *item)
+    {
+      Push(item);
+      if constexpr (Wakeup)
+      {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed))
+          WakeUp();
+      }
+    }
+
+    // Consumer only. Returns nullptr if empty or if a producer is in the
+    // middle of linking the next item.
+    T *Dequeue()
+    {
+      MPSCNode *t = tail;
+      MPSCNode *next = t->next.load(std::memory_order_acquire);
+
+      if (t == &stub)
+      {
+        if (!next)
+          return nullptr;
+        tail = next;
+        t = next;
+        next = next->next.load(std::memory_order_acquire);
+      }
+
+      if (next)
+      {
+        tail = next;
+        return static_cast<T *>(t);
+      }
+
+      if (t != head.load(std::memory_order_acquire))
+        return nullptr;
+
+      // t is the last item, park the stub behind it so t can be handed out
+      Push(&stub);
+      next = t->next.load(std::memory_order_acquire);
+      if (next)
+      {
+        tail = next;
+        return static_cast<T *>(t);
+      }
+      return nullptr;
+    }
+
+    // Consumer only. Hands up to max items to func in FIFO order and
+    // returns how many were drained.
+    template <typename Func>
+    size_t DequeueBatch(Func &&func, size_t max = SIZE_MAX)
+    {
+      size_t count = 0;
+      while (count < max)
+      {
+        T *item = Dequeue();
+        if (!item)
+          break;
+        func(item);
+        ++count;
+      }
+      return count;
+    }
+
+    // Consumer only. The head alone is not enough: Dequeue can park the
+    // stub behind an item whose link is not published yet, leaving the head
+    // on the stub while items are still queued ahead of it.
+    bool IsEmpty() const
+    {
+      return tail == &stub && stub.next.load(std::memory_order_acquire) == nullptr &&
+             head.load(std::memory_order_acquire) == &stub;
+    }
+
+    // Consumer only. Sleeps until the queue is not empty or WakeUp is called.
+    void Wait() requires Wakeup
+    {
+      if (!IsEmpty())
+        return;
+
+      u32 ticket = signal.load(std::memory_order_acquire);
+      sleeping.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (IsEmpty())
+        signal.wait(ticket, std::memory_order_acquire);
+      sleeping.store(false, std::memory_order_relaxed);
+    }
+
+    // Wakes the consumer, e.g. to make it notice a shutdown flag
+    void WakeUp() requires Wakeup
+    {
+      signal.fetch_add(1, std::memory_order_release);
+      signal.notify_one();
+    }
+  };
+}
@@ -0,0 +1,278 @@
+/**********************************************************************************
+* \brief  Single-producer single-consumer ring buffer sized at run time.
+*         The capacity is rounded up to a power of 2 and the storage is mapped
+*         twice back to back (the "magic ring buffer"), so every run of readable
+*         or writable items is contiguous in memory even when it wraps. That
+*         lets parsers work on ReadSpan() directly and bulk writes be a single
+*         memcpy.
+*
+*         The storage can be backed by huge pages, explicitly with MAP_HUGETLB
+*         pages or, when those are not reserved on the machine, by asking for
+*         transparent huge pages with madvise. Prefaulting populates the page
+*         tables up front so the first lap does not take page faults.
+*
+*         Linux only, T must be trivially copyable.
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+#include <Utils/NonCopyable.h>
+
+#if !defined(__linux__)
+#error "MappedRingBuffer requires Linux (memfd_create and mmap)"
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <span>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace CustomSTL
+{
+  struct MappedRingOptions
+  {
+    bool hugePages = false; // Back the ring with huge pages
+    bool prefault = false;  // Populate the page tables at construction
+  };
+
+  template <typename T>
+  class MappedRingBuffer : NonCopyable
+  {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "MappedRingBuffer stores raw bytes, T must be trivially copyable");
+
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+    T *buffer = nullptr;
+    size_t capacity = 0;
+    size_t mask = 0;
+    void *reserved = nullptr;
+    size_t reservedBytes = 0;
+    bool hugeTLB = false;
+
+    // Monotonic item counters, the slot is counter & mask
+    alignas(CACHE_LINE) std::atomic<u64> head{0};
+    alignas(CACHE_LINE) std::atomic<u64> tail{0};
+
+    static size_t RoundUpPow2(size_t value)
+    {
+      size_t result = 1;
+      while (result < value)
+        result <<= 1;
+      return result;
+    }
+
+    [[noreturn]] static void Fail(const char *what)
+    {
+      throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    // Creates the backing memory and maps it twice. Returns the name of the
+    // failing step, errno holds the reason, or nullptr on success.
+    const char *Map(size_t bytes, const MappedRingOptions &options, bool useHugeTLB)
+    {
+      int fd = memfd_create("MappedRingBuffer", MFD_CLOEXEC | (useHugeTLB ? MFD_HUGETLB : 0));
+      if (fd < 0)
+        return "MappedRingBuffer: memfd_create";
+      if (ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+      {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return "MappedRingBuffer: ftruncate";
+      }
+
+      // Reserve room for both copies, plus slack to align for huge pages
+      size_t alignment = options.hugePages ? HUGE_PAGE : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      reservedBytes = 2 * bytes + alignment;
+      reserved = mmap(nullptr, reservedBytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (reserved == MAP_FAILED)
+      {
+        int error = errno;
+        reserved = nullptr;
+        close(fd);
+        errno = error;
+        return "MappedRingBuffer: reserve";
+      }
+
+      uptr base = (reinterpret_cast<uptr>(reserved) + alignment - 1) & ~(alignment - 1);
+      int flags = MAP_SHARED | MAP_FIXED | (options.prefault ? MAP_POPULATE : 0);
+      for (size_t copy = 0; copy < 2; ++copy)
+      {
+        void *address = reinterpret_cast<void *>(base + copy * bytes);
+        if (mmap(address, bytes, PROT_READ | PROT_WRITE, flags, fd, 0) == MAP_FAILED)
+        {
+          int error = errno;
+          close(fd);
+          munmap(reserved, reservedBytes);
+          reserved = nullptr;
+          errno = error;
+          return "MappedRingBuffer: mirror mapping";
+        }
+      }
+      close(fd);
+
+      // Best effort, shmem THP may be disabled on this machine
+      if (options.hugePages && !useHugeTLB)
+        madvise(reinterpret_cast<void *>(base), 2 * bytes, MADV_HUGEPAGE);
+
+      buffer = reinterpret_cast<T *>(base);
+      hugeTLB = useHugeTLB;
+      return nullptr;
+    }
+
+  public:
+    // Capacity is rounded up to a power of 2, and further until the ring is
+    // a whole number of pages
+    explicit MappedRingBuffer(size_t minCapacity, MappedRingOptions options = {})
+    {
+      size_t pageSize = options.hugePages ? HUGE_PAGE : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      capacity = RoundUpPow2(minCapacity ? minCapacity : 1);
+      while ((capacity * sizeof(T)) % pageSize)
+        capacity <<= 1;
+      mask = capacity - 1;
+
+      // MAP_HUGETLB needs pages reserved by the administrator, fall back to
+      // regular pages with a transparent huge page hint when there are none
+      size_t bytes = capacity * sizeof(T);
+      if (options.hugePages && !Map(bytes, options, true))
+        return;
+      if (const char *failed = Map(bytes, options, false))
+        Fail(failed);
+    }
+
+    ~MappedRingBuffer()
+    {
+      if (reserved)
+        munmap(reserved, reservedBytes);
+    }
+
+    bool IsFull() const
+    {
+      return Count() == capacity;
+    }
+
+    bool IsEmpty() const
+    {
+      return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    size_t Capacity() const
+    {
+      return capacity;
+    }
+
+    size_t Count() const
+    {
+      return static_cast<size_t>(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire));
+    }
+
+    // True if the ring got MAP_HUGETLB pages rather than a madvise hint
+    bool UsesHugeTLB() const
+    {
+      return hugeTLB;
+    }
+
+    // Consumer only
+    void Clear()
+    {
+      head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Producer only
+    bool Enqueue(const T &data)
+    {
+      u64 t = tail.load(std::memory_order_relaxed);
+      if (t - head.load(std::memory_order_acquire) == capacity)
+        return false;
+
+      buffer[t & mask] = data;
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Producer only. Copies as many items as fit with one memcpy and
+    // returns how many were written.
+    size_t Write(const T *data, size_t count)
+    {
+      std::span<T> space = WriteSpan();
+      size_t n = count < space.size() ? count : space.size();
+      std::memcpy(space.data(), data, n * sizeof(T));
+      Commit(n);
+      return n;
+    }
+
+    // Producer only. Contiguous free space, fill it and Commit
+    std::span<T> WriteSpan()
+    {
+      u64 t = tail.load(std::memory_order_relaxed);
+      size_t free = capacity - static_cast<size_t>(t - head.load(std::memory_order_acquire));
+      return {buffer + (t & mask), free};
+    }
+
+    // Producer only. Publishes count items written through WriteSpan
+    void Commit(size_t count)
+    {
+      tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer only
+    bool Peek(T &output) const
+    {
+      u64 h = head.load(std::memory_order_relaxed);
+      if (h == tail.load(std::memory_order_acquire))
+        return false;
+
+      output = buffer[h & mask];
+      return true;
+    }
+
+    // Consumer only
+    const T *Peek() const
+    {
+      u64 h = head.load(std::memory_order_relaxed);
+      if (h == tail.load(std::memory_order_acquire))
+        return nullptr;
+      return &buffer[h & mask];
+    }
+
+    // Consumer only. Everything readable as one contiguous span, even
+    // across the wrap point. Release it with Consume.
+    std::span<const T> ReadSpan() const
+    {
+      u64 h = head.load(std::memory_order_relaxed);
+      size_t count = static_cast<size_t>(tail.load(std::memory_order_acquire) - h);
+      return {buffer + (h & mask), count};
+    }
+
+    // Consumer only. Frees the first count items of ReadSpan
+    void Consume(size_t count)
+    {
+      head.store(head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer only
+    bool Dequeue(T &output)
+    {
+      if (!Peek(output))
+        return false;
+      Consume(1);
+      return true;
+    }
+
+    // Consumer only
+    bool Dequeue()
+    {
+      if (IsEmpty())
+        return false;
+      Consume(1);
+      return true;
+    }
+  };
+}
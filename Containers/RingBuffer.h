@@ -1,19 +1,93 @@
 #pragma once
 #include <Types/Base.h>
+#include <Utils/Instrumentation.h>
 #include <Utils/NonCopyable.h>
 
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
 namespace CustomSTL
 {
-  // Power of 2 for N only
-  template <typename T, size_t N>
+  // Taken by RingBuffer::GetStats
+  struct RingBufferStats
+  {
+    u64 enqueued = 0;      // Items accepted, including by EnqueueOverwrite
+    u64 dequeued = 0;
+    u64 fullEvents = 0;    // Enqueues refused because the ring was full
+    u64 overwrites = 0;    // Items EnqueueOverwrite dropped
+    u64 emptyEvents = 0;   // Dequeues that found nothing
+    u64 cleared = 0;       // Items discarded by Clear
+    size_t count = 0;      // Items held when the stats were taken
+    size_t highWater = 0;  // Most items held at once
+    size_t capacity = 0;
+    u64 nanoseconds = 0;   // Steady clock when the stats were taken
+
+    // Items dequeued per second since the earlier stats
+    double Throughput(const RingBufferStats &earlier) const
+    {
+      if (nanoseconds <= earlier.nanoseconds)
+        return 0.0;
+      return static_cast<double>(dequeued - earlier.dequeued) * 1e9 /
+             static_cast<double>(nanoseconds - earlier.nanoseconds);
+    }
+  };
+
+  // Power of 2 for N only. With Stats the ring keeps the counters in
+  // RingBufferStats as relaxed atomics, so another thread may call
+  // GetStats while it is in use. Without it they cost nothing.
+  template <typename T, size_t N, bool Stats = false>
   class RingBuffer : NonCopyable
   {
+    struct Counters
+    {
+      std::atomic<u64> enqueued{0};
+      std::atomic<u64> dequeued{0};
+      std::atomic<u64> fullEvents{0};
+      std::atomic<u64> overwrites{0};
+      std::atomic<u64> emptyEvents{0};
+      std::atomic<u64> cleared{0};
+      std::atomic<u64> highWater{0};
+    };
+
+    struct NoCounters
+    {
+    };
+
     UniquePtr<T[]> buffer;
 
     size_t mask;
     unsigned head;
     unsigned tail;
 
+    [[no_unique_address]] std::conditional_t<Stats, Counters, NoCounters> stats;
+
+    // Only the ring's own thread writes the counters
+    void Note(std::atomic<u64> Counters::*counter, u64 amount = 1)
+    {
+      if constexpr (Stats)
+        (stats.*counter).store((stats.*counter).load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void NoteEnqueue()
+    {
+      if constexpr (Stats)
+      {
+        Note(&Counters::enqueued);
+        const u64 count = Count();
+        if (count > stats.highWater.load(std::memory_order_relaxed))
+          stats.highWater.store(count, std::memory_order_relaxed);
+      }
+    }
+
+    // Counts the dequeue that empties the ring rather than every poll that
+    // finds it empty, so a consumer spinning on an idle ring costs nothing
+    void NoteDrained()
+    {
+      if (head == tail)
+        INSTRUMENT_COUNT("RingBuffer.Empty");
+    }
+
   public:
     RingBuffer() : buffer(MakeUnique<T[]>(N + 1)), mask(N), head(0), tail(0) {}
 
@@ -34,14 +108,12 @@ namespace CustomSTL
 
     size_t Count() const
     {
-      size_t count = tail - head;
-      if (count < 0)
-        count += N + 1;
-      return static_cast<size_t>(count);
+      return (tail - head) & mask;
     }
 
     void Clear()
     {
+      Note(&Counters::cleared, Count());
       head = tail;
     }
 
@@ -52,23 +124,65 @@ namespace CustomSTL
       {
         buffer[tail] = data;
         tail = t;
+        NoteEnqueue();
         return true;
       }
+      INSTRUMENT_COUNT("RingBuffer.Full");
+      Note(&Counters::fullEvents);
       return false;
     }
 
-    bool Enqueue(const T &&data)
+    bool Enqueue(T &&data)
     {
       size_t t = (tail + 1) & mask;
       if (t != head)
       {
         buffer[tail] = std::move(data);
         tail = t;
+        NoteEnqueue();
         return true;
       }
+      INSTRUMENT_COUNT("RingBuffer.Full");
+      Note(&Counters::fullEvents);
       return false;
     }
 
+    // Overwrite-oldest mode, never fails. When full the oldest item is
+    // dropped to make room, returns true if that happened.
+    bool EnqueueOverwrite(const T &data)
+    {
+      size_t t = (tail + 1) & mask;
+      bool dropped = t == head;
+      if (dropped)
+      {
+        INSTRUMENT_COUNT("RingBuffer.Overwrite");
+        Note(&Counters::overwrites);
+        head = (head + 1) & mask;
+      }
+
+      buffer[tail] = data;
+      tail = t;
+      NoteEnqueue();
+      return dropped;
+    }
+
+    bool EnqueueOverwrite(T &&data)
+    {
+      size_t t = (tail + 1) & mask;
+      bool dropped = t == head;
+      if (dropped)
+      {
+        INSTRUMENT_COUNT("RingBuffer.Overwrite");
+        Note(&Counters::overwrites);
+        head = (head + 1) & mask;
+      }
+
+      buffer[tail] = std::move(data);
+      tail = t;
+      NoteEnqueue();
+      return dropped;
+    }
+
     bool Peek(T &output) const
     {
       if (head != tail)
@@ -82,7 +196,7 @@ namespace CustomSTL
     const T *Peek() const
     {
       if (head != tail)
-        return buffer[head];
+        return &buffer[head];
       return nullptr;
     }
 
@@ -92,9 +206,11 @@ namespace CustomSTL
       {
         output = std::move(buffer[head]);
         head = (head + 1) & mask;
-
+        Note(&Counters::dequeued);
+        NoteDrained();
         return true;
       }
+      Note(&Counters::emptyEvents);
       return false;
     }
 
@@ -103,10 +219,41 @@ namespace CustomSTL
       if (head != tail)
       {
         head = (head + 1) & mask;
+        Note(&Counters::dequeued);
+        NoteDrained();
         return true;
       }
+      Note(&Counters::emptyEvents);
       return false;
     }
+
+    // Safe from any thread. The count is derived from the counters rather
+    // than the cursors, which only the ring's own thread may read.
+    RingBufferStats GetStats() const requires Stats
+    {
+      RingBufferStats result;
+      result.enqueued = stats.enqueued.load(std::memory_order_relaxed);
+      result.dequeued = stats.dequeued.load(std::memory_order_relaxed);
+      result.fullEvents = stats.fullEvents.load(std::memory_order_relaxed);
+      result.overwrites = stats.overwrites.load(std::memory_order_relaxed);
+      result.emptyEvents = stats.emptyEvents.load(std::memory_order_relaxed);
+      result.cleared = stats.cleared.load(std::memory_order_relaxed);
+      result.highWater = static_cast<size_t>(stats.highWater.load(std::memory_order_relaxed));
+      result.capacity = N;
+      const u64 removed = result.dequeued + result.overwrites + result.cleared;
+      result.count = result.enqueued > removed ? static_cast<size_t>(result.enqueued - removed) : 0;
+      result.nanoseconds = static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                std::chrono::steady_clock::now().time_since_epoch())
+                                                .count());
+      return result;
+    }
+
+    // Starts a new high-water mark from the current fill, e.g. once per
+    // reporting interval. Ring thread only.
+    void ResetHighWater() requires Stats
+    {
+      stats.highWater.store(Count(), std::memory_order_relaxed);
+    }
   };
 
 }
\ No newline at end of file
@@ -0,0 +1,298 @@
+/**********************************************************************************
+* \brief  Single-producer single-consumer ring buffer that lives in POSIX shared
+*         memory, to pass messages between processes without a socket. It has
+*         the same Enqueue/Dequeue/Peek shape as RingBuffer.
+*
+*         The segment starts with a header holding the cursors, followed by the
+*         slots. Everything is located by offsets from the start of the segment,
+*         so each process may map it at a different address.
+*
+*         Cursors only move after the slot is fully written or read. If either
+*         side dies mid-operation, the half-written item is never published and
+*         the half-read item is read again by whoever reopens the ring.
+*
+*         The consumer can sleep in Wait() on a futex in the header that the
+*         producer wakes, only when the consumer is actually asleep.
+*
+*         Linux only, T must be trivially copyable.
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+#include <Utils/NonCopyable.h>
+
+#if !defined(__linux__)
+#error "SharedRingBuffer requires Linux (shm_open and futex)"
+#endif
+
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <ctime>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace CustomSTL
+{
+  template <typename T>
+  class SharedRingBuffer : NonCopyable
+  {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "SharedRingBuffer copies raw bytes between processes, T must be trivially copyable");
+    static_assert(std::atomic<u64>::is_always_lock_free && std::atomic<u32>::is_always_lock_free,
+                  "Cursors in shared memory must be lock free");
+
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr u64 MAGIC = 0x474E495244524853ULL; // "SHRDRING"
+    static constexpr u32 VERSION = 1;
+
+    struct Header
+    {
+      std::atomic<u64> magic;  // Written last by Create, Open checks it
+      u32 version;
+      u32 slotSize;
+      u64 capacity;
+      u64 slotsOffset;         // From the start of the segment
+
+      alignas(CACHE_LINE) std::atomic<u64> head;
+      alignas(CACHE_LINE) std::atomic<u64> tail;
+      alignas(CACHE_LINE) std::atomic<u32> signal;   // Futex word
+      std::atomic<u32> sleeping;
+    };
+
+    Header *header = nullptr;
+    T *slots = nullptr;
+    u64 mask = 0;
+    size_t mappedBytes = 0;
+
+    SharedRingBuffer() = default;
+
+    [[noreturn]] static void Fail(const std::string &what)
+    {
+      throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static size_t SlotsOffset()
+    {
+      return (sizeof(Header) + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+    }
+
+    void MapSegment(int fd, size_t bytes, const std::string &name)
+    {
+      void *base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      int error = errno;
+      close(fd);
+      if (base == MAP_FAILED)
+      {
+        errno = error;
+        Fail("SharedRingBuffer: mmap " + name);
+      }
+      header = static_cast<Header *>(base);
+      mappedBytes = bytes;
+    }
+
+    void Attach()
+    {
+      slots = reinterpret_cast<T *>(reinterpret_cast<byte *>(header) + header->slotsOffset);
+      mask = header->capacity - 1;
+    }
+
+    static long Futex(std::atomic<u32> *word, int op, u32 value, const timespec *timeout)
+    {
+      return syscall(SYS_futex, reinterpret_cast<u32 *>(word), op, value, timeout, nullptr, 0);
+    }
+
+  public:
+    ~SharedRingBuffer()
+    {
+      if (header)
+        munmap(header, mappedBytes);
+    }
+
+    // Creates (or resets) the segment. Capacity is rounded up to a power of 2.
+    static UniquePtr<SharedRingBuffer> Create(const std::string &name, size_t minCapacity)
+    {
+      u64 capacity = 1;
+      while (capacity < minCapacity)
+        capacity <<= 1;
+      size_t bytes = SlotsOffset() + capacity * sizeof(T);
+
+      int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+      if (fd < 0)
+        Fail("SharedRingBuffer: shm_open " + name);
+      if (ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+      {
+        int error = errno;
+        close(fd);
+        errno = error;
+        Fail("SharedRingBuffer: ftruncate " + name);
+      }
+
+      UniquePtr<SharedRingBuffer> ring(new SharedRingBuffer());
+      ring->MapSegment(fd, bytes, name);
+
+      Header *h = ring->header;
+      h->magic.store(0, std::memory_order_relaxed);
+      h->version = VERSION;
+      h->slotSize = sizeof(T);
+      h->capacity = capacity;
+      h->slotsOffset = SlotsOffset();
+      h->head.store(0, std::memory_order_relaxed);
+      h->tail.store(0, std::memory_order_relaxed);
+      h->signal.store(0, std::memory_order_relaxed);
+      h->sleeping.store(0, std::memory_order_relaxed);
+      h->magic.store(MAGIC, std::memory_order_release);
+
+      ring->Attach();
+      return ring;
+    }
+
+    // Attaches to a segment made by Create, keeping its cursors
+    static UniquePtr<SharedRingBuffer> Open(const std::string &name)
+    {
+      int fd = shm_open(name.c_str(), O_RDWR, 0);
+      if (fd < 0)
+        Fail("SharedRingBuffer: shm_open " + name);
+
+      struct stat info;
+      int statResult = fstat(fd, &info);
+      if (statResult != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+      {
+        int error = statResult != 0 ? errno : EINVAL;
+        close(fd);
+        errno = error;
+        Fail("SharedRingBuffer: bad segment " + name);
+      }
+
+      UniquePtr<SharedRingBuffer> ring(new SharedRingBuffer());
+      ring->MapSegment(fd, static_cast<size_t>(info.st_size), name);
+
+      // The header comes from another process, so the sizes in it are
+      // checked without any multiplication that could wrap
+      const Header *h = ring->header;
+      const bool fits = h->slotsOffset >= sizeof(Header) && h->slotsOffset <= ring->mappedBytes &&
+                        h->slotsOffset % alignof(T) == 0 &&
+                        h->capacity <= (ring->mappedBytes - h->slotsOffset) / sizeof(T);
+      if (h->magic.load(std::memory_order_acquire) != MAGIC || h->version != VERSION ||
+          h->slotSize != sizeof(T) || !std::has_single_bit(h->capacity) || !fits)
+      {
+        errno = EINVAL;
+        Fail("SharedRingBuffer: incompatible segment " + name);
+      }
+
+      ring->Attach();
+      return ring;
+    }
+
+    // Removes the name, mappings that are still open stay valid
+    static void Unlink(const std::string &name)
+    {
+      shm_unlink(name.c_str());
+    }
+
+    bool IsFull() const
+    {
+      return Count() == header->capacity;
+    }
+
+    bool IsEmpty() const
+    {
+      return header->head.load(std::memory_order_acquire) == header->tail.load(std::memory_order_acquire);
+    }
+
+    size_t Capacity() const
+    {
+      return static_cast<size_t>(header->capacity);
+    }
+
+    size_t Count() const
+    {
+      return static_cast<size_t>(header->tail.load(std::memory_order_acquire) - header->head.load(std::memory_order_acquire));
+    }
+
+    // Producer only
+    bool Enqueue(const T &data)
+    {
+      u64 t = header->tail.load(std::memory_order_relaxed);
+      if (t - header->head.load(std::memory_order_acquire) == header->capacity)
+        return false;
+
+      slots[t & mask] = data;
+      header->tail.store(t + 1, std::memory_order_release);
+
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (header->sleeping.load(std::memory_order_relaxed))
+      {
+        header->signal.fetch_add(1, std::memory_order_release);
+        Futex(&header->signal, FUTEX_WAKE, 1, nullptr);
+      }
+      return true;
+    }
+
+    // Consumer only
+    bool Peek(T &output) const
+    {
+      u64 h = header->head.load(std::memory_order_relaxed);
+      if (h == header->tail.load(std::memory_order_acquire))
+        return false;
+
+      output = slots[h & mask];
+      return true;
+    }
+
+    // Consumer only
+    const T *Peek() const
+    {
+      u64 h = header->head.load(std::memory_order_relaxed);
+      if (h == header->tail.load(std::memory_order_acquire))
+        return nullptr;
+      return &slots[h & mask];
+    }
+
+    // Consumer only
+    bool Dequeue(T &output)
+    {
+      if (!Peek(output))
+        return false;
+      header->head.fetch_add(1, std::memory_order_release);
+      return true;
+    }
+
+    // Consumer only
+    bool Dequeue()
+    {
+      if (IsEmpty())
+        return false;
+      header->head.fetch_add(1, std::memory_order_release);
+      return true;
+    }
+
+    // Consumer only. Sleeps until an item is available or the timeout in
+    // milliseconds passes, a negative timeout waits forever. Returns true if
+    // the ring is not empty.
+    bool Wait(long timeoutMs = -1)
+    {
+      if (!IsEmpty())
+        return true;
+
+      u32 ticket = header->signal.load(std::memory_order_acquire);
+      header->sleeping.store(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (IsEmpty())
+      {
+        timespec timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000000};
+        Futex(&header->signal, FUTEX_WAIT, ticket, timeoutMs < 0 ? nullptr : &timeout);
+      }
+      header->sleeping.store(0, std::memory_order_relaxed);
+      return !IsEmpty();
+    }
+  };
+}
@@ -1,47 +1,400 @@
 /**********************************************************************************
 * \brief  This file contains a thread-safe queue meant to be used for threading
 *         operations
+*
+*         Consumers spin briefly before blocking on the condition variable, so
+*         bursty traffic is picked up without a wake-up. Close() releases every
+*         waiter, which lets a worker pool drain and exit without poison pills.
+*         A non-zero capacity bounds the queue and makes Enqueue block while
+*         it is full.
+*
+*         Every blocking wait is counted and timed under the Queue.ConsumerWait*
+*         and Queue.ProducerWait* metrics, see Utils/Instrumentation.h. With
+*         Stats set the queue also keeps its own QueueStats, to tell which of
+*         several queues is backing up.
 **********************************************************************************/
 
 #pragma once
 
-#include <queue>
-#include <mutex>
+#include <Types/Base.h>
+#include <Utils/CpuRelax.h>
+#include <Utils/Instrumentation.h>
+
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <queue>
+#include <type_traits>
 
 namespace CustomSTL
 {
-  template <typename T>
+  // Taken by Queue::GetStats
+  struct QueueStats
+  {
+    u64 enqueued = 0;
+    u64 dequeued = 0;
+    u64 enqueueFailures = 0;          // Enqueues refused because the queue was full or closed
+    u64 producerWaits = 0;            // Enqueues that blocked on a full queue
+    u64 consumerWaits = 0;            // Dequeues that blocked on an empty queue
+    u64 producerBlockedNanoseconds = 0;
+    u64 consumerBlockedNanoseconds = 0;
+    u64 lockContentions = 0;          // Lock acquisitions that found the mutex held
+    size_t count = 0;                 // Items queued when the stats were taken
+    size_t highWater = 0;             // Most items queued at once
+    size_t capacity = 0;              // 0 if unbounded
+    u64 nanoseconds = 0;              // Steady clock when the stats were taken
+
+    // Items dequeued per second since the earlier stats
+    double Throughput(const QueueStats &earlier) const
+    {
+      if (nanoseconds <= earlier.nanoseconds)
+        return 0.0;
+      return static_cast<double>(dequeued - earlier.dequeued) * 1e9 /
+             static_cast<double>(nanoseconds - earlier.nanoseconds);
+    }
+  };
+
+  // With Stats the queue fills in QueueStats using relaxed atomics. Without
+  // it the counters, the clock reads and the contention check are compiled
+  // out.
+  template <typename T, bool Stats = false>
   class Queue
   {
+    static constexpr unsigned SPIN_COUNT = 256;
+
+    struct Counters
+    {
+      std::atomic<u64> enqueued{0};
+      std::atomic<u64> dequeued{0};
+      std::atomic<u64> enqueueFailures{0};
+      std::atomic<u64> producerWaits{0};
+      std::atomic<u64> consumerWaits{0};
+      std::atomic<u64> producerBlockedNanoseconds{0};
+      std::atomic<u64> consumerBlockedNanoseconds{0};
+      std::atomic<u64> lockContentions{0};
+      std::atomic<size_t> highWater{0};
+    };
+
+    struct NoCounters
+    {
+    };
+
     std::queue<T> queue;
     mutable std::mutex m;
-    std::condition_variable c;
+    std::condition_variable c;     // Signalled when an item is added
+    std::condition_variable space; // Signalled when an item is removed
+
+    const size_t capacity;
+    unsigned consumersWaiting = 0;
+    unsigned producersWaiting = 0;
+    bool closed = false;
+
+    // Mirrors of queue.size() and closed that can be read without the lock
+    // while spinning
+    std::atomic<size_t> count{0};
+    std::atomic<bool> closedFlag{false};
+
+    [[no_unique_address]] mutable std::conditional_t<Stats, Counters, NoCounters> stats;
+
+    static u64 Now()
+    {
+      return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now().time_since_epoch())
+                                  .count());
+    }
+
+    // Counters other than lockContentions only change under the lock
+    void Note(std::atomic<u64> Counters::*counter, u64 amount = 1) const
+    {
+      if constexpr (Stats)
+        (stats.*counter).store((stats.*counter).load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Start of a blocking wait, 0 without Stats
+    u64 WaitStart() const
+    {
+      if constexpr (Stats)
+        return Now();
+      else
+        return 0;
+    }
+
+    void NoteWait(std::atomic<u64> Counters::*waits, std::atomic<u64> Counters::*blocked, u64 start) const
+    {
+      if constexpr (Stats)
+      {
+        Note(waits);
+        Note(blocked, Now() - start);
+      }
+    }
+
+    // With Stats, tries the lock first to count contended acquisitions
+    std::unique_lock<std::mutex> Lock() const
+    {
+      if constexpr (Stats)
+      {
+        std::unique_lock<std::mutex> lock(m, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+          stats.lockContentions.fetch_add(1, std::memory_order_relaxed);
+          lock.lock();
+        }
+        return lock;
+      }
+      else
+        return std::unique_lock<std::mutex>(m);
+    }
+
+    bool IsFull() const
+    {
+      return capacity && queue.size() >= capacity;
+    }
+
+    void SpinForItem() const
+    {
+      for (unsigned i = 0; i < SPIN_COUNT; ++i)
+      {
+        if (count.load(std::memory_order_relaxed) || closedFlag.load(std::memory_order_relaxed))
+          return;
+        CpuRelax();
+      }
+    }
+
+    void Push(T &&data)
+    {
+      queue.push(std::move(data));
+      count.store(queue.size(), std::memory_order_relaxed);
+      if constexpr (Stats)
+      {
+        Note(&Counters::enqueued);
+        if (queue.size() > stats.highWater.load(std::memory_order_relaxed))
+          stats.highWater.store(queue.size(), std::memory_order_relaxed);
+      }
+      if (consumersWaiting)
+        c.notify_one();
+    }
+
+    T Pop()
+    {
+      T data = std::move(queue.front());
+      queue.pop();
+      count.store(queue.size(), std::memory_order_relaxed);
+      Note(&Counters::dequeued);
+      if (producersWaiting)
+        space.notify_one();
+      return data;
+    }
+
+    // Blocks until there is an item or the queue is closed
+    bool WaitForItem(std::unique_lock<std::mutex> &lock)
+    {
+      if (queue.empty() && !closed)
+      {
+        INSTRUMENT_COUNT("Queue.ConsumerWaits");
+        INSTRUMENT_SCOPE("Queue.ConsumerWaitTime");
+        const u64 start = WaitStart();
+        lock.unlock();
+        SpinForItem();
+        lock.lock();
+
+        ++consumersWaiting;
+        c.wait(lock, [this] { return !queue.empty() || closed; });
+        --consumersWaiting;
+        NoteWait(&Counters::consumerWaits, &Counters::consumerBlockedNanoseconds, start);
+      }
+      return !queue.empty();
+    }
 
   public:
+    // A capacity of 0 means unbounded
+    explicit Queue(size_t capacity = 0) : capacity(capacity) {}
+
+    Queue(const Queue &) = delete;
+    Queue &operator=(const Queue &) = delete;
 
-    // Race condition
-    bool Empty()
+    bool Empty() const
     {
+      auto lock = Lock();
       return queue.empty();
     }
 
-    void Enqueue(T data)
+    size_t Size() const
+    {
+      auto lock = Lock();
+      return queue.size();
+    }
+
+    size_t Capacity() const
+    {
+      return capacity;
+    }
+
+    bool IsClosed() const
     {
-      std::lock_guard<std::mutex> lock(m);
-      queue.push(data);
-      c.notify_one();
+      return closedFlag.load(std::memory_order_acquire);
     }
 
+    // Blocks while the queue is full. Returns false if the queue is closed.
+    bool Enqueue(T data)
+    {
+      auto lock = Lock();
+      if (IsFull() && !closed)
+      {
+        INSTRUMENT_COUNT("Queue.ProducerWaits");
+        INSTRUMENT_SCOPE("Queue.ProducerWaitTime");
+        const u64 start = WaitStart();
+        ++producersWaiting;
+        space.wait(lock, [this] { return !IsFull() || closed; });
+        --producersWaiting;
+        NoteWait(&Counters::producerWaits, &Counters::producerBlockedNanoseconds, start);
+      }
+      if (closed)
+      {
+        Note(&Counters::enqueueFailures);
+        return false;
+      }
+
+      Push(std::move(data));
+      return true;
+    }
+
+    // Returns false instead of blocking if the queue is full or closed
+    bool TryEnqueue(T data)
+    {
+      auto lock = Lock();
+      if (closed || IsFull())
+      {
+        Note(&Counters::enqueueFailures);
+        return false;
+      }
+
+      Push(std::move(data));
+      return true;
+    }
+
+    // Blocks until an item is available. Returns a default constructed T if
+    // the queue was closed and drained, prefer Dequeue(T &) when using Close.
     T Dequeue()
     {
-      std::unique_lock<std::mutex> lock(m);
-      while (queue.empty())
-        c.wait(lock);
+      auto lock = Lock();
+      if (!WaitForItem(lock))
+        return T{};
+      return Pop();
+    }
 
-      T data = queue.front();
-      queue.pop();
-      return data;
+    // Blocks until an item is available. Returns false once the queue is
+    // closed and drained.
+    bool Dequeue(T &output)
+    {
+      auto lock = Lock();
+      if (!WaitForItem(lock))
+        return false;
+
+      output = Pop();
+      return true;
+    }
+
+    bool TryDequeue(T &output)
+    {
+      auto lock = Lock();
+      if (queue.empty())
+        return false;
+
+      output = Pop();
+      return true;
+    }
+
+    // Returns false if nothing arrived within the timeout or the queue is
+    // closed and drained
+    template <typename Rep, typename Period>
+    bool DequeueFor(T &output, const std::chrono::duration<Rep, Period> &timeout)
+    {
+      auto deadline = std::chrono::steady_clock::now() + timeout;
+      auto lock = Lock();
+      if (queue.empty() && !closed)
+      {
+        INSTRUMENT_COUNT("Queue.ConsumerWaits");
+        INSTRUMENT_SCOPE("Queue.ConsumerWaitTime");
+        const u64 start = WaitStart();
+        lock.unlock();
+        SpinForItem();
+        lock.lock();
+
+        ++consumersWaiting;
+        c.wait_until(lock, deadline, [this] { return !queue.empty() || closed; });
+        --consumersWaiting;
+        NoteWait(&Counters::consumerWaits, &Counters::consumerBlockedNanoseconds, start);
+      }
+      if (queue.empty())
+        return false;
+
+      output = Pop();
+      return true;
+    }
+
+    // Blocks until at least one item is available, then moves up to max
+    // items to out under a single lock. Returns the number of items moved,
+    // 0 once the queue is closed and drained.
+    template <typename OutputIt>
+    size_t DequeueBatch(OutputIt out, size_t max)
+    {
+      auto lock = Lock();
+      if (!max || !WaitForItem(lock))
+        return 0;
+
+      size_t moved = 0;
+      for (; moved < max && !queue.empty(); ++moved)
+      {
+        *out++ = std::move(queue.front());
+        queue.pop();
+      }
+      count.store(queue.size(), std::memory_order_relaxed);
+      Note(&Counters::dequeued, moved);
+      if (producersWaiting)
+        space.notify_all();
+      return moved;
+    }
+
+    // Lock free, safe to poll from a monitoring thread
+    QueueStats GetStats() const requires Stats
+    {
+      QueueStats result;
+      result.enqueued = stats.enqueued.load(std::memory_order_relaxed);
+      result.dequeued = stats.dequeued.load(std::memory_order_relaxed);
+      result.enqueueFailures = stats.enqueueFailures.load(std::memory_order_relaxed);
+      result.producerWaits = stats.producerWaits.load(std::memory_order_relaxed);
+      result.consumerWaits = stats.consumerWaits.load(std::memory_order_relaxed);
+      result.producerBlockedNanoseconds = stats.producerBlockedNanoseconds.load(std::memory_order_relaxed);
+      result.consumerBlockedNanoseconds = stats.consumerBlockedNanoseconds.load(std::memory_order_relaxed);
+      result.lockContentions = stats.lockContentions.load(std::memory_order_relaxed);
+      result.count = count.load(std::memory_order_relaxed);
+      result.highWater = stats.highWater.load(std::memory_order_relaxed);
+      result.capacity = capacity;
+      result.nanoseconds = Now();
+      return result;
+    }
+
+    // Starts a new high-water mark from the current size, e.g. once per
+    // reporting interval
+    void ResetHighWater() requires Stats
+    {
+      auto lock = Lock();
+      stats.highWater.store(queue.size(), std::memory_order_relaxed);
+    }
+
+    // Rejects further Enqueues and wakes every waiting thread. Items already
+    // in the queue can still be dequeued.
+    void Close()
+    {
+      {
+        auto lock = Lock();
+        closed = true;
+        closedFlag.store(true, std::memory_order_release);
+      }
+      c.notify_all();
+      space.notify_all();
     }
-  }
+  };
 }
@@ -634,6 +634,8 @@ typename BList<T, Size>::BNode* BList<T, Size>::SplitNode(BNode* node)
   if(node->count != Size)
     throw(std::exception());
 
+  INSTRUMENT_COUNT("BList.SplitNode");
+
   //Inserting a new node
   BNode* temp = CreateNewNode();
   temp->next = node->next;
@@ -815,3 +817,215 @@ void BList<T, Size>::RemoveNode(BNode* temp)
   delete temp2;
   --stats_.NodeCount;
 }
+
+/*************************************************************************/
+/*!
+ \fn BList<T, Size>::lower_bound(const T& value) const
+ 
+ \brief Returns the index of the first item that is not less than value.
+        Nodes whose last item is less than value are skipped whole, the
+        remaining node is binary searched. The BList must be sorted.
+        Returns size() if every item is less than value.
+ 
+ \param value
+*/ 
+/*************************************************************************/
+template <typename T, unsigned Size>
+int BList<T, Size>::lower_bound(const T& value) const
+{
+  int counter = 0;
+  for(const BNode* node = head_; node != nullptr; node = node->next)
+  {
+    if(node->values[node->count - 1] < value)
+    {
+      counter += node->count;
+      continue;
+    }
+    return counter + static_cast<int>(LowerBoundInNode(node, value));
+  }
+  return counter;
+}
+
+/*************************************************************************/
+/*!
+ \fn BList<T, Size>::upper_bound(const T& value) const
+ 
+ \brief Returns the index of the first item that is greater than value.
+        The BList must be sorted.
+        Returns size() if no item is greater than value.
+ 
+ \param value
+*/ 
+/*************************************************************************/
+template <typename T, unsigned Size>
+int BList<T, Size>::upper_bound(const T& value) const
+{
+  int counter = 0;
+  for(const BNode* node = head_; node != nullptr; node = node->next)
+  {
+    if(!(value < node->values[node->count - 1]))
+    {
+      counter += node->count;
+      continue;
+    }
+    return counter + static_cast<int>(UpperBoundInNode(node, value));
+  }
+  return counter;
+}
+
+/*************************************************************************/
+/*!
+ \fn BList<T, Size>::equal_range(const T& value) const
+ 
+ \brief Returns the half-open index range [first, second) of the items
+        that are equal to value. The BList must be sorted.
+ 
+ \param value
+*/ 
+/*************************************************************************/
+template <typename T, unsigned Size>
+std::pair<int, int> BList<T, Size>::equal_range(const T& value) const
+{
+  int counter = 0;
+  const BNode* node = head_;
+  
+  //Skip to the node holding the first equal item
+  for(; node != nullptr; node = node->next)
+  {
+    if(!(node->values[node->count - 1] < value))
+      break;
+    counter += node->count;
+  }
+  if(node == nullptr)
+    return {counter, counter};
+
+  unsigned first = LowerBoundInNode(node, value);
+  int lower = counter + static_cast<int>(first);
+  
+  //Carry on from the same node, equal items may span several nodes
+  for(; node != nullptr; node = node->next)
+  {
+    if(!(value < node->values[node->count - 1]))
+    {
+      counter += node->count;
+      continue;
+    }
+    return {lower, counter + static_cast<int>(UpperBoundInNode(node, value))};
+  }
+  return {lower, counter};
+}
+
+/*************************************************************************/
+/*!
+ \fn BList<T, Size>::count_range(const T& lo, const T& hi) const
+ 
+ \brief Returns the number of items in the half-open range [lo, hi).
+        The BList must be sorted.
+ 
+ \param lo
+ 
+ \param hi
+*/ 
+/*************************************************************************/
+template <typename T, unsigned Size>
+int BList<T, Size>::count_range(const T& lo, const T& hi) const
+{
+  int count = 0;
+  for_each_in_range(lo, hi, [&count](const T*, unsigned n) { count += n; });
+  return count;
+}
+
+/*************************************************************************/
+/*!
+ \fn BList<T, Size>::for_each_in_range(const T& lo, const T& hi, Func func) const
+ 
+ \brief Calls func(const T* first, unsigned count) once for every
+        contiguous run of items in the half-open range [lo, hi).
+        Each run lies inside a single node. The BList must be sorted.
+ 
+ \param lo
+ 
+ \param hi
+ 
+ \param func
+*/ 
+/*************************************************************************/
+template <typename T, unsigned Size>
+template <typename Func>
+void BList<T, Size>::for_each_in_range(const T& lo, const T& hi, Func func) const
+{
+  if(!(lo < hi))
+    return;
+  
+  const BNode* node = head_;
+  while(node != nullptr && node->values[node->count - 1] < lo)
+    node = node->next;
+  if(node == nullptr)
+    return;
+
+  unsigned first = LowerBoundInNode(node, lo);
+  for(; node != nullptr; node = node->next, first = 0)
+  {
+    //Whole remainder of the node is inside the range
+    if(node->values[node->count - 1] < hi)
+    {
+      func(node->values + first, node->count - first);
+      continue;
+    }
+    
+    unsigned last = LowerBoundInNode(node, hi);
+    if(first < last)
+      func(node->values + first, last - first);
+    return;
+  }
+}
+
+/*************************************************************************/
+/*!
+ \fn BList<T, Size>::LowerBoundInNode(const BNode* node, const T& value)
+ 
+ \brief Binary searches a node for the first item not less than value
+ 
+ \return unsigned
+*/ 
+/*************************************************************************/
+template <typename T, unsigned Size>
+unsigned BList<T, Size>::LowerBoundInNode(const BNode* node, const T& value)
+{
+  unsigned low = 0;
+  unsigned high = node->count;
+  while(low < high)
+  {
+    unsigned mid = low + (high - low) / 2;
+    if(node->values[mid] < value)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return low;
+}
+
+/*************************************************************************/
+/*!
+ \fn BList<T, Size>::UpperBoundInNode(const BNode* node, const T& value)
+ 
+ \brief Binary searches a node for the first item greater than value
+ 
+ \return unsigned
+*/ 
+/*************************************************************************/
+template <typename T, unsigned Size>
+unsigned BList<T, Size>::UpperBoundInNode(const BNode* node, const T& value)
+{
+  unsigned low = 0;
+  unsigned high = node->count;
+  while(low < high)
+  {
+    unsigned mid = low + (high - low) / 2;
+    if(value < node->values[mid])
+      high = mid;
+    else
+      low = mid + 1;
+  }
+  return low;
+}
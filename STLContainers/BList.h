@@ -17,6 +17,9 @@ The BList class will also have the capability to maintain a sort order when usin
 #define BLIST_H
 
 #include <string> // error strings
+#include <utility> // std::pair
+
+#include <Utils/Instrumentation.h> // INSTRUMENT_COUNT
 
 /*!
   The exception class for BList
@@ -310,6 +313,77 @@ class BList
     /*************************************************************************/
     BListStats GetStats() const;
 
+    /*************************************************************************/
+    /*!
+    \fn lower_bound(const T& value) const
+    
+    \brief Returns the index of the first item that is not less than value.
+           Nodes whose last item is less than value are skipped whole, the
+           remaining node is binary searched. The BList must be sorted.
+           Returns size() if every item is less than value.
+    
+    \param value
+    */ 
+    /*************************************************************************/
+    int lower_bound(const T& value) const;
+
+    /*************************************************************************/
+    /*!
+    \fn upper_bound(const T& value) const
+    
+    \brief Returns the index of the first item that is greater than value.
+           The BList must be sorted.
+           Returns size() if no item is greater than value.
+    
+    \param value
+    */ 
+    /*************************************************************************/
+    int upper_bound(const T& value) const;
+
+    /*************************************************************************/
+    /*!
+    \fn equal_range(const T& value) const
+    
+    \brief Returns the half-open index range [first, second) of the items
+           that are equal to value. The BList must be sorted.
+    
+    \param value
+    */ 
+    /*************************************************************************/
+    std::pair<int, int> equal_range(const T& value) const;
+
+    /*************************************************************************/
+    /*!
+    \fn count_range(const T& lo, const T& hi) const
+    
+    \brief Returns the number of items in the half-open range [lo, hi).
+           The BList must be sorted.
+    
+    \param lo
+    
+    \param hi
+    */ 
+    /*************************************************************************/
+    int count_range(const T& lo, const T& hi) const;
+
+    /*************************************************************************/
+    /*!
+    \fn for_each_in_range(const T& lo, const T& hi, Func func) const
+    
+    \brief Calls func(const T* first, unsigned count) once for every
+           contiguous run of items in the half-open range [lo, hi).
+           Each run lies inside a single node. The BList must be sorted.
+    
+    \param lo
+    
+    \param hi
+    
+    \param func
+    */ 
+    /*************************************************************************/
+    template <typename Func>
+    void for_each_in_range(const T& lo, const T& hi, Func func) const;
+
   private:
     BNode *head_; //!< points to the first node
     BNode *tail_; //!< points to the last node
@@ -393,6 +467,28 @@ class BList
     */ 
     /*************************************************************************/
     void RemoveNode(BNode* temp);
+
+    /*************************************************************************/
+    /*!
+    \fn LowerBoundInNode(const BNode* node, const T& value)
+    
+    \brief Binary searches a node for the first item not less than value
+    
+    \return unsigned
+    */ 
+    /*************************************************************************/
+    static unsigned LowerBoundInNode(const BNode* node, const T& value);
+
+    /*************************************************************************/
+    /*!
+    \fn UpperBoundInNode(const BNode* node, const T& value)
+    
+    \brief Binary searches a node for the first item greater than value
+    
+    \return unsigned
+    */ 
+    /*************************************************************************/
+    static unsigned UpperBoundInNode(const BNode* node, const T& value);
 };
 
 #include "BList.cpp"
@@ -1,106 +1,250 @@
+/*************************************************************************/
+/*!
+\brief  Fixed size array. Everything is constexpr, so an array can be
+        built and read at compile time, e.g. as a lookup table:
+
+          constexpr CustomSTL::array<u8, 4> table = {1, 2, 4, 8};
+          static_assert(table[2] == 4);
+
+        Bounds is the check done by operator[]: bounds_checked throws,
+        bounds_debug asserts in debug builds only and bounds_unchecked
+        does nothing. at() always throws. Align raises the alignment of
+        the storage, e.g. to 32 so SIMD loads of the whole array are
+        aligned.
+*/
+/*************************************************************************/
 #ifndef _ARRAY_H_
+#define _ARRAY_H_
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <utility>
 
 namespace CustomSTL
 {
-  template<typename T, size_t N> 
+  // Throws std::out_of_range on a bad index, in every build
+  struct bounds_checked
+  {
+    static constexpr void check(size_t index, size_t size)
+    {
+      if (index >= size)
+        throw std::out_of_range("array index out of range");
+    }
+  };
+
+  // Asserts on a bad index, free when NDEBUG is defined
+  struct bounds_debug
+  {
+    static constexpr void check([[maybe_unused]] size_t index, [[maybe_unused]] size_t size)
+    {
+      assert(index < size && "array index out of range");
+    }
+  };
+
+  struct bounds_unchecked
+  {
+    static constexpr void check(size_t, size_t) {}
+  };
+
+  template<typename T, size_t N, typename Bounds = bounds_debug, size_t Align = alignof(T)>
   class array
   {
-  private:
-    T _array[N];
- 
+    static_assert(N > 0, "array must hold at least one element");
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0,
+                  "Align must be a power of 2 no smaller than alignof(T)");
+
   public:
     typedef T value_type;
+    typedef size_t size_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    // Public only so the array is an aggregate and can be brace
+    // initialised like a built-in array, use data() instead
+    alignas(Align) T _array[N];
+
     /*********************************************************************/
     /*!
-    \fn T* array<T, N>::begin()
-    
+    \fn T* array<T, N, Bounds, Align>::begin()
+
     \brief This function returns the value of the beginning of the array
-    
+
     \return T*
             Pointer to the element
-    */ 
+    */
     /*********************************************************************/
-    T* begin();
+    constexpr T* begin();
+    constexpr const T* begin() const;
     /*********************************************************************/
     /*!
-    \fn const T* array<T, N>::cbegin() const
-    
-    \brief This function returns the const value of the 
+    \fn const T* array<T, N, Bounds, Align>::cbegin() const
+
+    \brief This function returns the const value of the
            beginning of the array
-    
+
     \return const T*
             Pointer to the element which is read only
-    */ 
-    /*********************************************************************/ 
-    const T* cbegin() const;
+    */
+    /*********************************************************************/
+    constexpr const T* cbegin() const;
     /*********************************************************************/
     /*!
-    \fn T* array<T, N>::end()
-    
+    \fn T* array<T, N, Bounds, Align>::end()
+
     \brief This function returns the value of the end of the array
-    
+
     \return T*
             Pointer to the element
-    */ 
-    /*********************************************************************/     
-    T* end();
+    */
+    /*********************************************************************/
+    constexpr T* end();
+    constexpr const T* end() const;
     /*********************************************************************/
     /*!
-    \fn const T* array<T, N>::cend() const
-    
+    \fn const T* array<T, N, Bounds, Align>::cend() const
+
     \brief This function returns the const value of the end of the array
-    
+
     \return const T*
             Pointer to the element which is read only
-    */ 
-    /*********************************************************************/  
-    const T* cend() const;
+    */
+    /*********************************************************************/
+    constexpr const T* cend() const;
+    /*********************************************************************/
+    /*!
+    \fn const T& array<T, N, Bounds, Align>::operator[](size_t index) const
+
+    \brief This function returns a read only reference to the element in
+          the specified index, checked as Bounds says
+
+    \param index
+            To access a specific element in the array
+
+    \return const T&
+            Element of the specific index which is read only
+    */
+    /*********************************************************************/
+    constexpr const T& operator[](size_t index) const;
     /*********************************************************************/
     /*!
-    \fn T array<T, N>::operator[](size_t index) const
-    
-    \brief This function returns the copy of the value of the 
-          element in the specified index
-    
+    \fn T& array<T, N, Bounds, Align>::operator[](size_t index)
+
+    \brief This function returns the value of the element in the specified
+          index, checked as Bounds says
+
     \param index
             To access a specific element in the array
-    
-    \return T
-            Copy of the element of the specific index
-    */ 
-    /*********************************************************************/  
-    T operator[](size_t index) const;
+
+    \return T&
+            Element of the specific index
+    */
+    /*********************************************************************/
+    constexpr T& operator[](size_t index);
     /*********************************************************************/
     /*!
-    \fn T& array<T, N>::operator[](size_t index)
-    
-    \brief This function returns the value of the element in the specified 
-          index
-    
+    \fn T& array<T, N, Bounds, Align>::at(size_t index)
+
+    \brief This function returns the element in the specified index and
+          throws std::out_of_range if there is none, whatever Bounds is
+
     \param index
             To access a specific element in the array
-    
+
     \return T&
             Element of the specific index
-    */ 
-    /*********************************************************************/ 
-    T& operator[](size_t index);
+    */
+    /*********************************************************************/
+    constexpr T& at(size_t index);
+    constexpr const T& at(size_t index) const;
+    /*********************************************************************/
+    /*!
+    \fn T& array<T, N, Bounds, Align>::front()
+
+    \brief This function returns the first element of the array
+
+    \return T&
+            First element
+    */
+    /*********************************************************************/
+    constexpr T& front();
+    constexpr const T& front() const;
+    /*********************************************************************/
+    /*!
+    \fn T& array<T, N, Bounds, Align>::back()
+
+    \brief This function returns the last element of the array
+
+    \return T&
+            Last element
+    */
+    /*********************************************************************/
+    constexpr T& back();
+    constexpr const T& back() const;
+    /*********************************************************************/
+    /*!
+    \fn T* array<T, N, Bounds, Align>::data()
+
+    \brief This function returns the underlying storage, aligned to Align
+
+    \return T*
+            Pointer to the first element
+    */
+    /*********************************************************************/
+    constexpr T* data();
+    constexpr const T* data() const;
     /*********************************************************************/
     /*!
-    \fn size_t array<T, N>::size() const
-    
+    \fn size_t array<T, N, Bounds, Align>::size() const
+
     \brief This function returns the size of the array
-    
+
     \return size_t
             size of array
-    */ 
-    /*********************************************************************/  
-    size_t size() const;
-  
+    */
+    /*********************************************************************/
+    constexpr size_t size() const;
+    /*********************************************************************/
+    /*!
+    \fn void array<T, N, Bounds, Align>::fill(const T& value)
+
+    \brief This function assigns value to every element
+
+    \param value
+            Value to copy into every element
+    */
+    /*********************************************************************/
+    constexpr void fill(const T& value);
+    /*********************************************************************/
+    /*!
+    \fn void array<T, N, Bounds, Align>::swap(array& other)
+
+    \brief This function swaps the elements with those of other
+
+    \param other
+            Array to swap with
+    */
+    /*********************************************************************/
+    constexpr void swap(array& other);
+    /*********************************************************************/
+    /*!
+    \fn array<T, N, Bounds, Align>::operator std::span<T, N>()
+
+    \brief This function views the array as a fixed size span
+
+    \return std::span<T, N>
+            Span over every element
+    */
+    /*********************************************************************/
+    constexpr operator std::span<T, N>();
+    constexpr operator std::span<const T, N>() const;
   };
 }
 #include "array.tpp"
 
 #endif
-
-
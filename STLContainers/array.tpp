@@ -1,130 +1,296 @@
 /*************************************************************************/
-/*!  
-\brief  
-This file contains the template class definitions of
-a static array container
-/*************************************************************************/ 
+/*!
+\brief  This file contains the template class definitions of
+        a static array container
+*/
+/*************************************************************************/
+#include "array.h"
 
 namespace CustomSTL
 {
   /***********************************************************************/
   /*!
-  \fn T* array<T, N>::begin()
-  
+  \fn T* array<T, N, Bounds, Align>::begin()
+
   \brief This function returns the value of the beginning of the array
-  
+
   \return T*
           Pointer to the element
-  */ 
+  */
   /***********************************************************************/
-  template<typename T, size_t N>
-  T* array<T, N>::begin()
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr T* array<T, N, Bounds, Align>::begin()
+  {
+    return _array;
+  }
+
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T* array<T, N, Bounds, Align>::begin() const
   {
     return _array;
   }
 
   /***********************************************************************/
   /*!
-  \fn const T* array<T, N>::cbegin() const
-  
+  \fn const T* array<T, N, Bounds, Align>::cbegin() const
+
   \brief This function returns the const value of the beginning of the array
-  
+
   \return const T*
           Pointer to the element which is read only
-  */ 
-  /***********************************************************************/ 
-  template<typename T, size_t N>
-  const T* array<T, N>::cbegin() const
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T* array<T, N, Bounds, Align>::cbegin() const
   {
     return _array;
   }
- 
+
   /***********************************************************************/
   /*!
-  \fn T* array<T, N>::end()
-  
+  \fn T* array<T, N, Bounds, Align>::end()
+
   \brief This function returns the value of the end of the array
-  
+
   \return T*
           Pointer to the element
-  */ 
-  /***********************************************************************/ 
-  template<typename T, size_t N>
-  T* array<T, N>::end()
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr T* array<T, N, Bounds, Align>::end()
+  {
+    return _array+N;
+  }
+
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T* array<T, N, Bounds, Align>::end() const
   {
     return _array+N;
   }
 
   /***********************************************************************/
   /*!
-  \fn const T* array<T, N>::cend() const
-  
+  \fn const T* array<T, N, Bounds, Align>::cend() const
+
   \brief This function returns the const value of the end of the array
-  
+
   \return const T*
           Pointer to the element which is read only
-  */ 
-  /***********************************************************************/   
-  template<typename T, size_t N>
-  const T* array<T, N>::cend() const
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T* array<T, N, Bounds, Align>::cend() const
   {
     return _array+N;
   }
 
   /***********************************************************************/
   /*!
-  \fn T array<T, N>::operator[](size_t index) const
-  
-  \brief This function returns the copy of the value of the 
-         element in the specified index
-  
+  \fn const T& array<T, N, Bounds, Align>::operator[](size_t index) const
+
+  \brief This function returns a read only reference to the element in
+         the specified index, checked as Bounds says
+
+  \param index
+          To access a specific element in the array
+
+  \return const T&
+          Element of the specific index which is read only
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T& array<T, N, Bounds, Align>::operator[](size_t index) const
+  {
+    Bounds::check(index, N);
+    return _array[index];
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn T& array<T, N, Bounds, Align>::operator[](size_t index)
+
+  \brief This function returns the value of the element in the specified
+         index, checked as Bounds says
+
   \param index
           To access a specific element in the array
-  
-  \return T
-          Copy of the element of the specific index
-  */ 
-  /***********************************************************************/  
-  template<typename T, size_t N>
-  T array<T, N>::operator[](size_t index) const
+
+  \return T&
+          Element of the specific index
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr T& array<T, N, Bounds, Align>::operator[](size_t index)
   {
+    Bounds::check(index, N);
     return _array[index];
   }
 
   /***********************************************************************/
   /*!
-  \fn T& array<T, N>::operator[](size_t index)
-  
-  \brief This function returns the value of the element in the specified 
-         index
-  
+  \fn T& array<T, N, Bounds, Align>::at(size_t index)
+
+  \brief This function returns the element in the specified index and
+         throws std::out_of_range if there is none, whatever Bounds is
+
   \param index
           To access a specific element in the array
-  
+
   \return T&
           Element of the specific index
-  */ 
-  /***********************************************************************/   
-  template<typename T, size_t N>
-  T& array<T, N>::operator[](size_t index)
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr T& array<T, N, Bounds, Align>::at(size_t index)
   {
+    bounds_checked::check(index, N);
     return _array[index];
   }
 
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T& array<T, N, Bounds, Align>::at(size_t index) const
+  {
+    bounds_checked::check(index, N);
+    return _array[index];
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn T& array<T, N, Bounds, Align>::front()
+
+  \brief This function returns the first element of the array
+
+  \return T&
+          First element
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr T& array<T, N, Bounds, Align>::front()
+  {
+    return _array[0];
+  }
+
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T& array<T, N, Bounds, Align>::front() const
+  {
+    return _array[0];
+  }
+
   /***********************************************************************/
   /*!
-  \fn size_t array<T, N>::size() const
-  
+  \fn T& array<T, N, Bounds, Align>::back()
+
+  \brief This function returns the last element of the array
+
+  \return T&
+          Last element
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr T& array<T, N, Bounds, Align>::back()
+  {
+    return _array[N - 1];
+  }
+
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T& array<T, N, Bounds, Align>::back() const
+  {
+    return _array[N - 1];
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn T* array<T, N, Bounds, Align>::data()
+
+  \brief This function returns the underlying storage, aligned to Align
+
+  \return T*
+          Pointer to the first element
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr T* array<T, N, Bounds, Align>::data()
+  {
+    return _array;
+  }
+
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr const T* array<T, N, Bounds, Align>::data() const
+  {
+    return _array;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn size_t array<T, N, Bounds, Align>::size() const
+
   \brief This function returns the size of the array
-  
+
   \return size_t
           size of array
-  */ 
-  /***********************************************************************/     
-  template<typename T, size_t N>  
-  size_t array<T, N>::size() const
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr size_t array<T, N, Bounds, Align>::size() const
   {
     return N;
   }
-  
+
+  /***********************************************************************/
+  /*!
+  \fn void array<T, N, Bounds, Align>::fill(const T& value)
+
+  \brief This function assigns value to every element
+
+  \param value
+          Value to copy into every element
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr void array<T, N, Bounds, Align>::fill(const T& value)
+  {
+    for (T& element : _array)
+      element = value;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void array<T, N, Bounds, Align>::swap(array& other)
+
+  \brief This function swaps the elements with those of other
+
+  \param other
+          Array to swap with
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr void array<T, N, Bounds, Align>::swap(array& other)
+  {
+    using std::swap;
+    for (size_t i = 0; i < N; ++i)
+      swap(_array[i], other._array[i]);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn array<T, N, Bounds, Align>::operator std::span<T, N>()
+
+  \brief This function views the array as a fixed size span
+
+  \return std::span<T, N>
+          Span over every element
+  */
+  /***********************************************************************/
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr array<T, N, Bounds, Align>::operator std::span<T, N>()
+  {
+    return std::span<T, N>(_array);
+  }
+
+  template<typename T, size_t N, typename Bounds, size_t Align>
+  constexpr array<T, N, Bounds, Align>::operator std::span<const T, N>() const
+  {
+    return std::span<const T, N>(_array);
+  }
+
 }
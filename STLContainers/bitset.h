@@ -10,6 +10,8 @@
 
 #include <string>
 #include <array>
+#include <climits>
+#include <ostream>
 
 namespace CustomSTL
 {
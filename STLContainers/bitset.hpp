@@ -10,10 +10,9 @@ namespace CustomSTL
   {}
 
   template<size_t N>
-  bitset<N>::bitset(const bitset& rhs)
-  {
-      rhs.data = bitset_array.data;
-  }
+  bitset<N>::bitset(const bitset& rhs) :
+    bitset_array(rhs.bitset_array)
+  {}
   
   template<size_t N>
   void bitset<N>::set(size_t index,bool flag)
@@ -83,6 +82,7 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
    Returns true if any of the bit is toggled.
+  */
   /*************************************************************************/
   template<size_t N>
   bitset<N>::operator bool() const noexcept
@@ -93,6 +93,7 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
     Returns the value to the bit at position pos.
+  */
   /*************************************************************************/
   template<size_t N>  
   bool bitset<N>::operator[](size_t index) const
@@ -104,6 +105,7 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
     Returns the reference to the bit at position pos.
+  */
   /*************************************************************************/
   //template<size_t N>
   //bit_proxy<N>& bitset<N>::operator[](size_t index)
@@ -115,6 +117,7 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
    Performs the AND operation
+  */
   /*************************************************************************/
   template<size_t N>
   bitset<N>& bitset<N>::operator&=(const bitset& rhs) noexcept
@@ -130,6 +133,7 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
    Performs the OR operation
+  */
   /*************************************************************************/
   template<size_t N>
   bitset<N>& bitset<N>::operator|=(const bitset& rhs) noexcept
@@ -145,6 +149,7 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
    Performs the XOR operation
+  */
   /*************************************************************************/
   template<size_t N>
   bitset<N>& bitset<N>::operator^=(const bitset& rhs) noexcept
@@ -160,23 +165,31 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
    Return a new bitset with all the bits flipped
+  */
   /*************************************************************************/
   template<size_t N>
   bitset<N> bitset<N>::operator~() const noexcept
   {
-      return bitset(*this).flip();
+      bitset result(*this);
+      for (size_t i = 0; i < bitset_array.size(); ++i)
+      {
+          result.bitset_array[i] = static_cast<char>(~bitset_array[i]);
+      }
+
+      return result;
   }
 
   /*************************************************************************/
   /*!
    Copy assignment operator
+  */
   /*************************************************************************/
   template<size_t N>
   const bitset<N>& bitset<N>::operator=(const bitset& rhs)
   {
-      if (this != rhs)
+      if (this != &rhs)
       {
-          rhs(*this);
+          bitset_array = rhs.bitset_array;
       }
 
       return *this;
@@ -185,6 +198,7 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
    Returns number of toggled bit
+  */
   /*************************************************************************/
   template<size_t N>  
   size_t bitset<N>::count() const
@@ -202,6 +216,7 @@ namespace CustomSTL
   /*************************************************************************/
   /*!
    Returns the maximum capactiy of the bitset
+  */
   /*************************************************************************/
   template<size_t N>  
   constexpr size_t bitset<N>::size() const
@@ -50,7 +50,7 @@ namespace CustomSTL
       virtual std::string to_string(const char first = '0',const char second = '1') const;
       virtual bool operator[](size_t x) const;  
     };
-    bitset_tep(std::unique_ptr<IConcept>&& concept);
+    bitset_tep(std::unique_ptr<IConcept>&& impl);
 
   public:
     void set(size_t x,bool flag = true);
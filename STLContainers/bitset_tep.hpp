@@ -68,10 +68,10 @@ namespace CustomSTL
     return _instance[x];
   }    
 
-  bitset_tep::bitset_tep(std::unique_ptr<IConcept>&& concept) : 
+  bitset_tep::bitset_tep(std::unique_ptr<IConcept>&& impl) : 
     _concept_ptr
     {
-      std::move(concept)
+      std::move(impl)
     } 
   {
     
@@ -0,0 +1,361 @@
+/***************************************************************************/
+/*!
+\brief  An unrolled variant of CustomSTL::list.
+        Elements are packed into blocks of BLOCK_BYTES (8 cache lines,
+        aligned to a cache line) instead of one heap node per element. Each
+        block keeps an occupancy bitmap, removals only clear a bit and leave
+        a hole behind. Only the free slots at either end of the list are
+        reused, by push_front/push_back, since filling a hole in the middle
+        would put the new element out of order. A hole in the middle of a
+        block is reclaimed when its block empties, so erasing scattered
+        elements can leave blocks sparsely filled.
+        Elements are never moved once constructed, so references and
+        iterators stay valid until the element itself is removed.
+        Inserting in the middle is not supported since it would need to move
+        elements, use CustomSTL::list for that.
+*/
+/***************************************************************************/
+#ifndef _CHUNKED_LIST_H_
+#define _CHUNKED_LIST_H_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+namespace CustomSTL
+{
+  template <typename T>
+  class chunked_list
+  {
+  public:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t BLOCK_BYTES = CACHE_LINE * 8;
+    static constexpr size_t BLOCK_CAPACITY =
+      sizeof(T) >= BLOCK_BYTES ? 1 :
+      (BLOCK_BYTES / sizeof(T) > 64 ? 64 : BLOCK_BYTES / sizeof(T));
+
+  private:
+    struct alignas(CACHE_LINE) block
+    {
+      alignas(T) unsigned char _storage[sizeof(T) * BLOCK_CAPACITY];
+      block* _prev;
+      block* _next;
+      uint64_t _occupied;
+
+      block() : _prev{nullptr}, _next{nullptr}, _occupied{0} {}
+
+      // Raw memory of a slot, to construct an element in
+      void* storage(unsigned index)
+      {
+        return _storage + sizeof(T) * index;
+      }
+
+      // Only for slots that hold a constructed element
+      T* slot(unsigned index)
+      {
+        return std::launder(reinterpret_cast<T*>(_storage + sizeof(T) * index));
+      }
+
+      const T* slot(unsigned index) const
+      {
+        return std::launder(reinterpret_cast<const T*>(_storage + sizeof(T) * index));
+      }
+
+      unsigned lowest() const
+      {
+        return static_cast<unsigned>(std::countr_zero(_occupied));
+      }
+
+      unsigned highest() const
+      {
+        return 63u - static_cast<unsigned>(std::countl_zero(_occupied));
+      }
+    };
+
+    block* _first;
+    block* _last;
+    block* _spare; //!< One emptied block kept around to avoid allocator churn
+    size_t _size;
+
+  public:
+
+    template <bool IsConst>
+    class iterator_impl
+    {
+      using block_ptr = std::conditional_t<IsConst, const block*, block*>;
+
+      block_ptr _curr;
+      block* const* _last; //!< Owner's tail, so end() can be decremented
+      unsigned _slot;
+
+      friend class chunked_list;
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = T;
+      using difference_type = ptrdiff_t;
+      using pointer = std::conditional_t<IsConst, const T*, T*>;
+      using reference = std::conditional_t<IsConst, const T&, T&>;
+
+      /**********************************************************************/
+      /*!
+      \fn iterator_impl::iterator_impl(block_ptr curr, unsigned slot, block* const* last)
+      \brief Conversion constructor for iterator_impl
+      */
+      /**********************************************************************/
+      iterator_impl(block_ptr curr, unsigned slot, block* const* last);
+
+      /**********************************************************************/
+      /*!
+      \fn iterator_impl::operator iterator_impl<true>() const
+      \brief Allows an iterator to be used where a const_iterator is expected
+      */
+      /**********************************************************************/
+      operator iterator_impl<true>() const;
+
+      bool operator!=(const iterator_impl& rhs) const;
+
+      bool operator==(const iterator_impl& rhs) const;
+
+      /**********************************************************************/
+      /*!
+      \fn iterator_impl& iterator_impl::operator++()
+      \brief Pre-increment. Skips holes using the block's occupancy bitmap
+      \return Returns the current reference of the iterator
+      */
+      /**********************************************************************/
+      iterator_impl& operator++();
+
+      /**********************************************************************/
+      /*!
+      \fn iterator_impl& iterator_impl::operator--()
+      \brief Pre-decrement. Decrementing end() moves to the last element
+      \return Returns the current reference of the iterator
+      */
+      /**********************************************************************/
+      iterator_impl& operator--();
+
+      iterator_impl operator++(int);
+
+      iterator_impl operator--(int);
+
+      reference operator*() const;
+
+      pointer operator->() const;
+    };
+
+    using size_type = size_t;
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
+    using difference_type = typename iterator::difference_type;
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+
+    /**********************************************************************/
+    /*!
+    \fn chunked_list<T>::chunked_list()
+    \brief Default constructor for chunked_list
+    */
+    /**********************************************************************/
+    chunked_list();
+
+    /**********************************************************************/
+    /*!
+    \fn chunked_list<T>::chunked_list(TInputIterator begin, TInputIterator end)
+    \brief For Range Loop Constructor
+    */
+    /**********************************************************************/
+    template <typename TInputIterator>
+    chunked_list(TInputIterator begin, TInputIterator end);
+
+    /**********************************************************************/
+    /*!
+    \fn chunked_list<T>::chunked_list(std::initializer_list<T> values)
+    \brief Initializer list Constructor
+    */
+    /**********************************************************************/
+    chunked_list(std::initializer_list<T> values);
+
+    /**********************************************************************/
+    /*!
+    \fn chunked_list<T>::chunked_list(const chunked_list& rhs)
+    \brief Copy constructor. The copy is packed, holes are not copied
+    */
+    /**********************************************************************/
+    chunked_list(const chunked_list& rhs);
+
+    /**********************************************************************/
+    /*!
+    \fn chunked_list<T>::chunked_list(chunked_list&& rhs)
+    \brief Move constructor. Takes the blocks, rhs is left empty. Elements
+           and iterators to them stay valid, except end() iterators.
+    */
+    /**********************************************************************/
+    chunked_list(chunked_list&& rhs) noexcept;
+
+    /**********************************************************************/
+    /*!
+    \fn chunked_list<T>::~chunked_list()
+    \brief Destroys every element and frees every block
+    */
+    /**********************************************************************/
+    ~chunked_list();
+
+    /**********************************************************************/
+    /*!
+    \fn chunked_list<T>& chunked_list<T>::operator=(const chunked_list& rhs)
+    \brief Copy assignment operator overload
+    \param rhs
+              Reference of the list being copied to this list
+    \returns Reference to this list
+    */
+    /**********************************************************************/
+    chunked_list& operator=(const chunked_list& rhs);
+
+    /**********************************************************************/
+    /*!
+    \fn chunked_list<T>& chunked_list<T>::operator=(chunked_list&& rhs)
+    \brief Move assignment operator overload. Takes the blocks of rhs,
+           rhs is left empty.
+    \param rhs
+              List whose elements are moved to this list
+    \returns Reference to this list
+    */
+    /**********************************************************************/
+    chunked_list& operator=(chunked_list&& rhs) noexcept;
+
+    /**********************************************************************/
+    /*!
+    \fn reference chunked_list<T>::front()
+    \brief Returns a reference to the first value
+    */
+    /**********************************************************************/
+    reference front();
+    const_reference front() const;
+
+    /**********************************************************************/
+    /*!
+    \fn reference chunked_list<T>::back()
+    \brief Returns a reference to the last value
+    */
+    /**********************************************************************/
+    reference back();
+    const_reference back() const;
+
+    /**********************************************************************/
+    /*!
+    \fn void chunked_list<T>::push_back(const value_type& value)
+    \brief  Adds an element at the back of the list. Reuses the free slots
+            after the last element of the tail block before allocating.
+    \param  value
+            value of the element to be added
+    */
+    /**********************************************************************/
+    void push_back(const value_type& value);
+
+    /**********************************************************************/
+    /*!
+    \fn void chunked_list<T>::push_front(const value_type& value)
+    \brief  Adds an element at the front of the list. Reuses the free slots
+            before the first element of the head block before allocating.
+    \param  value
+            value of the element to be added
+    */
+    /**********************************************************************/
+    void push_front(const value_type& value);
+
+    /**********************************************************************/
+    /*!
+    \fn void chunked_list<T>::pop_front()
+    \brief  Removes the element at the front of the list.
+    */
+    /**********************************************************************/
+    void pop_front();
+
+    /**********************************************************************/
+    /*!
+    \fn void chunked_list<T>::pop_back()
+    \brief  Removes the element at the back of the list.
+    */
+    /**********************************************************************/
+    void pop_back();
+
+    /**********************************************************************/
+    /*!
+    \fn iterator chunked_list<T>::erase(const_iterator pos)
+    \brief  Removes the element at pos, leaving a hole in its block.
+            Only iterators to the erased element are invalidated.
+    \return Iterator to the element after the erased one
+    */
+    /**********************************************************************/
+    iterator erase(const_iterator pos);
+
+    /**********************************************************************/
+    /*!
+    \fn void chunked_list<T>::clear()
+    \brief  Removes every element
+    */
+    /**********************************************************************/
+    void clear();
+
+    /**********************************************************************/
+    /*!
+    \fn bool chunked_list<T>::empty() const
+    \brief Check if list is empty
+    \return true if list is empty.
+    */
+    /**********************************************************************/
+    bool empty() const;
+
+    /**********************************************************************/
+    /*!
+    \fn size_type chunked_list<T>::size() const
+    \brief Returns the number of elements in the list
+    */
+    /**********************************************************************/
+    size_type size() const;
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    iterator begin();
+    iterator end();
+
+  private:
+    /**********************************************************************/
+    /*!
+    \fn block* chunked_list<T>::AcquireBlock()
+    \brief Returns the spare block if there is one, otherwise allocates
+    */
+    /**********************************************************************/
+    block* AcquireBlock();
+
+    /**********************************************************************/
+    /*!
+    \fn void chunked_list<T>::ReleaseBlock(block* node)
+    \brief Unlinks an empty block, keeping it as the spare if there is none
+    */
+    /**********************************************************************/
+    void ReleaseBlock(block* node);
+
+    /**********************************************************************/
+    /*!
+    \fn void chunked_list<T>::RemoveSlot(block* node, unsigned slot)
+    \brief Destroys the element in the given slot and releases the block
+           if it became empty
+    */
+    /**********************************************************************/
+    void RemoveSlot(block* node, unsigned slot);
+  };
+}
+
+#include "chunked_list.tpp"
+
+#endif
@@ -0,0 +1,593 @@
+#include "chunked_list.h"
+
+namespace CustomSTL
+{
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>::chunked_list()
+  \brief Default constructor for chunked_list
+  */
+  /***********************************************************************/
+  template <typename T>
+  chunked_list<T>::chunked_list() :
+    _first{nullptr},
+    _last{nullptr},
+    _spare{nullptr},
+    _size{0}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>::chunked_list(TInputIterator current, TInputIterator end)
+  \brief For Range Loop Constructor
+  */
+  /***********************************************************************/
+  template <typename T>
+  template <typename TInputIterator>
+  chunked_list<T>::chunked_list(TInputIterator current, TInputIterator end) :
+    chunked_list{}
+  {
+    while (current != end)
+    {
+      push_back(*current++);
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>::chunked_list(std::initializer_list<T> values)
+  \brief Initializer list Constructor
+  */
+  /***********************************************************************/
+  template <typename T>
+  chunked_list<T>::chunked_list(std::initializer_list<T> values) :
+    chunked_list(values.begin(), values.end())
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>::chunked_list(const chunked_list& rhs)
+  \brief Copy constructor. The copy is packed, holes are not copied
+  */
+  /***********************************************************************/
+  template <typename T>
+  chunked_list<T>::chunked_list(const chunked_list& rhs) :
+    chunked_list(rhs.begin(), rhs.end())
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>::chunked_list(chunked_list&& rhs)
+  \brief Move constructor. Takes the blocks, rhs is left empty
+  */
+  /***********************************************************************/
+  template <typename T>
+  chunked_list<T>::chunked_list(chunked_list&& rhs) noexcept :
+    _first{rhs._first},
+    _last{rhs._last},
+    _spare{rhs._spare},
+    _size{rhs._size}
+  {
+    rhs._first = nullptr;
+    rhs._last = nullptr;
+    rhs._spare = nullptr;
+    rhs._size = 0;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>::~chunked_list()
+  \brief Destroys every element and frees every block
+  */
+  /***********************************************************************/
+  template <typename T>
+  chunked_list<T>::~chunked_list()
+  {
+    clear();
+    delete _spare;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>& chunked_list<T>::operator=(const chunked_list& rhs)
+  \brief Copy assignment operator overload
+  \param rhs
+            Reference of the list being copied to this list
+  \returns Reference to this list
+  */
+  /***********************************************************************/
+  template <typename T>
+  chunked_list<T>& chunked_list<T>::operator=(const chunked_list& rhs)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      for (const_iterator current = rhs.begin(); current != rhs.end(); ++current)
+      {
+        push_back(*current);
+      }
+    }
+    return *this;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>& chunked_list<T>::operator=(chunked_list&& rhs)
+  \brief Move assignment operator overload
+  \param rhs
+            List whose elements are moved to this list
+  \returns Reference to this list
+  */
+  /***********************************************************************/
+  template <typename T>
+  chunked_list<T>& chunked_list<T>::operator=(chunked_list&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      clear();
+      delete _spare;
+      _first = rhs._first;
+      _last = rhs._last;
+      _spare = rhs._spare;
+      _size = rhs._size;
+      rhs._first = nullptr;
+      rhs._last = nullptr;
+      rhs._spare = nullptr;
+      rhs._size = 0;
+    }
+    return *this;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename chunked_list<T>::reference chunked_list<T>::front()
+  \brief Returns a reference to the first value
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename chunked_list<T>::reference chunked_list<T>::front()
+  {
+    return *_first->slot(_first->lowest());
+  }
+
+  template <typename T>
+  typename chunked_list<T>::const_reference chunked_list<T>::front() const
+  {
+    return *_first->slot(_first->lowest());
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename chunked_list<T>::reference chunked_list<T>::back()
+  \brief Returns a reference to the last value
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename chunked_list<T>::reference chunked_list<T>::back()
+  {
+    return *_last->slot(_last->highest());
+  }
+
+  template <typename T>
+  typename chunked_list<T>::const_reference chunked_list<T>::back() const
+  {
+    return *_last->slot(_last->highest());
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void chunked_list<T>::push_back(const value_type& value)
+  \brief  Adds an element at the back of the list. Reuses the free slots
+          after the last element of the tail block before allocating.
+  \param  value
+          value of the element to be added
+  */
+  /***********************************************************************/
+  template <typename T>
+  void chunked_list<T>::push_back(const value_type& value)
+  {
+    unsigned slot = 0;
+    if (_last && _last->highest() + 1 < BLOCK_CAPACITY)
+    {
+      slot = _last->highest() + 1;
+    }
+    else
+    {
+      block* node = AcquireBlock();
+      node->_prev = _last;
+      if (_last)
+      {
+        _last->_next = node;
+      }
+      else
+      {
+        _first = node;
+      }
+      _last = node;
+    }
+
+    ::new (_last->storage(slot)) T(value);
+    _last->_occupied |= (uint64_t{1} << slot);
+    ++_size;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void chunked_list<T>::push_front(const value_type& value)
+  \brief  Adds an element at the front of the list. Reuses the free slots
+          before the first element of the head block before allocating.
+  \param  value
+          value of the element to be added
+  */
+  /***********************************************************************/
+  template <typename T>
+  void chunked_list<T>::push_front(const value_type& value)
+  {
+    // A fresh head block is filled from its top slot down, so further
+    // push_fronts keep landing in the same block
+    unsigned slot = BLOCK_CAPACITY - 1;
+    if (_first && _first->lowest() > 0)
+    {
+      slot = _first->lowest() - 1;
+    }
+    else
+    {
+      block* node = AcquireBlock();
+      node->_next = _first;
+      if (_first)
+      {
+        _first->_prev = node;
+      }
+      else
+      {
+        _last = node;
+      }
+      _first = node;
+    }
+
+    ::new (_first->storage(slot)) T(value);
+    _first->_occupied |= (uint64_t{1} << slot);
+    ++_size;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void chunked_list<T>::pop_front()
+  \brief  Removes the element at the front of the list.
+  */
+  /***********************************************************************/
+  template <typename T>
+  void chunked_list<T>::pop_front()
+  {
+    RemoveSlot(_first, _first->lowest());
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void chunked_list<T>::pop_back()
+  \brief  Removes the element at the back of the list.
+  */
+  /***********************************************************************/
+  template <typename T>
+  void chunked_list<T>::pop_back()
+  {
+    RemoveSlot(_last, _last->highest());
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename chunked_list<T>::iterator chunked_list<T>::erase(const_iterator pos)
+  \brief  Removes the element at pos, leaving a hole in its block.
+          Only iterators to the erased element are invalidated.
+  \return Iterator to the element after the erased one
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename chunked_list<T>::iterator chunked_list<T>::erase(const_iterator pos)
+  {
+    block* node = const_cast<block*>(pos._curr);
+    iterator next{node, pos._slot, &_last};
+    ++next;
+    RemoveSlot(node, pos._slot);
+    return next;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void chunked_list<T>::clear()
+  \brief  Removes every element
+  */
+  /***********************************************************************/
+  template <typename T>
+  void chunked_list<T>::clear()
+  {
+    while (_first)
+    {
+      block* node = _first;
+      _first = _first->_next;
+      if constexpr (!std::is_trivially_destructible_v<T>)
+      {
+        for (uint64_t bits = node->_occupied; bits; bits &= bits - 1)
+        {
+          node->slot(static_cast<unsigned>(std::countr_zero(bits)))->~T();
+        }
+      }
+      delete node;
+    }
+    _last = nullptr;
+    _size = 0;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn bool chunked_list<T>::empty() const
+  \brief Check if list is empty
+  \return true if list is empty.
+  */
+  /***********************************************************************/
+  template <typename T>
+  bool chunked_list<T>::empty() const
+  {
+    return (!_first);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename chunked_list<T>::size_type chunked_list<T>::size() const
+  \brief Returns the number of elements in the list
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename chunked_list<T>::size_type chunked_list<T>::size() const
+  {
+    return _size;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn block* chunked_list<T>::AcquireBlock()
+  \brief Returns the spare block if there is one, otherwise allocates
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename chunked_list<T>::block* chunked_list<T>::AcquireBlock()
+  {
+    if (_spare)
+    {
+      block* node = _spare;
+      _spare = nullptr;
+      return node;
+    }
+    return new block{};
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void chunked_list<T>::ReleaseBlock(block* node)
+  \brief Unlinks an empty block, keeping it as the spare if there is none
+  */
+  /***********************************************************************/
+  template <typename T>
+  void chunked_list<T>::ReleaseBlock(block* node)
+  {
+    if (node->_prev)
+    {
+      node->_prev->_next = node->_next;
+    }
+    else
+    {
+      _first = node->_next;
+    }
+
+    if (node->_next)
+    {
+      node->_next->_prev = node->_prev;
+    }
+    else
+    {
+      _last = node->_prev;
+    }
+
+    if (_spare)
+    {
+      delete node;
+      return;
+    }
+    node->_prev = nullptr;
+    node->_next = nullptr;
+    _spare = node;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void chunked_list<T>::RemoveSlot(block* node, unsigned slot)
+  \brief Destroys the element in the given slot and releases the block
+         if it became empty
+  */
+  /***********************************************************************/
+  template <typename T>
+  void chunked_list<T>::RemoveSlot(block* node, unsigned slot)
+  {
+    node->slot(slot)->~T();
+    node->_occupied &= ~(uint64_t{1} << slot);
+    --_size;
+    if (!node->_occupied)
+    {
+      ReleaseBlock(node);
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>::iterator_impl<IsConst>::iterator_impl(block_ptr curr, unsigned slot, block* const* last)
+  \brief Conversion constructor for iterator_impl
+  */
+  /***********************************************************************/
+  template <typename T>
+  template <bool IsConst>
+  chunked_list<T>::iterator_impl<IsConst>::iterator_impl(block_ptr curr,
+                                                          unsigned slot,
+                                                          block* const* last) :
+    _curr{curr},
+    _last{last},
+    _slot{slot}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn chunked_list<T>::iterator_impl<IsConst>::operator iterator_impl<true>() const
+  \brief Allows an iterator to be used where a const_iterator is expected
+  */
+  /***********************************************************************/
+  template <typename T>
+  template <bool IsConst>
+  chunked_list<T>::iterator_impl<IsConst>::operator iterator_impl<true>() const
+  {
+    return {_curr, _slot, _last};
+  }
+
+  template <typename T>
+  template <bool IsConst>
+  bool chunked_list<T>::iterator_impl<IsConst>::operator!=(const iterator_impl& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  template <typename T>
+  template <bool IsConst>
+  bool chunked_list<T>::iterator_impl<IsConst>::operator==(const iterator_impl& rhs) const
+  {
+    return (_curr == rhs._curr && _slot == rhs._slot);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn iterator_impl& chunked_list<T>::iterator_impl<IsConst>::operator++()
+  \brief Pre-increment. Skips holes using the block's occupancy bitmap
+  \return Returns the current reference of the iterator
+  */
+  /***********************************************************************/
+  template <typename T>
+  template <bool IsConst>
+  typename chunked_list<T>::template iterator_impl<IsConst>&
+           chunked_list<T>::iterator_impl<IsConst>::operator++()
+  {
+    uint64_t remaining = _slot < 63 ? _curr->_occupied & (~uint64_t{0} << (_slot + 1)) : 0;
+    if (remaining)
+    {
+      _slot = static_cast<unsigned>(std::countr_zero(remaining));
+      return *this;
+    }
+
+    _curr = _curr->_next;
+    _slot = _curr ? _curr->lowest() : 0;
+    return *this;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn iterator_impl& chunked_list<T>::iterator_impl<IsConst>::operator--()
+  \brief Pre-decrement. Decrementing end() moves to the last element
+  \return Returns the current reference of the iterator
+  */
+  /***********************************************************************/
+  template <typename T>
+  template <bool IsConst>
+  typename chunked_list<T>::template iterator_impl<IsConst>&
+           chunked_list<T>::iterator_impl<IsConst>::operator--()
+  {
+    if (!_curr)
+    {
+      _curr = *_last;
+      _slot = _curr->highest();
+      return *this;
+    }
+
+    uint64_t remaining = _curr->_occupied & ((uint64_t{1} << _slot) - 1);
+    if (remaining)
+    {
+      _slot = 63u - static_cast<unsigned>(std::countl_zero(remaining));
+      return *this;
+    }
+
+    _curr = _curr->_prev;
+    _slot = _curr->highest();
+    return *this;
+  }
+
+  template <typename T>
+  template <bool IsConst>
+  typename chunked_list<T>::template iterator_impl<IsConst>
+           chunked_list<T>::iterator_impl<IsConst>::operator++(int)
+  {
+    iterator_impl temp = *this;
+    ++(*this);
+    return temp;
+  }
+
+  template <typename T>
+  template <bool IsConst>
+  typename chunked_list<T>::template iterator_impl<IsConst>
+           chunked_list<T>::iterator_impl<IsConst>::operator--(int)
+  {
+    iterator_impl temp = *this;
+    --(*this);
+    return temp;
+  }
+
+  template <typename T>
+  template <bool IsConst>
+  typename chunked_list<T>::template iterator_impl<IsConst>::reference
+           chunked_list<T>::iterator_impl<IsConst>::operator*() const
+  {
+    return *_curr->slot(_slot);
+  }
+
+  template <typename T>
+  template <bool IsConst>
+  typename chunked_list<T>::template iterator_impl<IsConst>::pointer
+           chunked_list<T>::iterator_impl<IsConst>::operator->() const
+  {
+    return _curr->slot(_slot);
+  }
+
+  template <typename T>
+  typename chunked_list<T>::const_iterator chunked_list<T>::cbegin() const
+  {
+    return {_first, _first ? _first->lowest() : 0, &_last};
+  }
+
+  template <typename T>
+  typename chunked_list<T>::const_iterator chunked_list<T>::cend() const
+  {
+    return {nullptr, 0, &_last};
+  }
+
+  template <typename T>
+  typename chunked_list<T>::const_iterator chunked_list<T>::begin() const
+  {
+    return cbegin();
+  }
+
+  template <typename T>
+  typename chunked_list<T>::const_iterator chunked_list<T>::end() const
+  {
+    return cend();
+  }
+
+  template <typename T>
+  typename chunked_list<T>::iterator chunked_list<T>::begin()
+  {
+    return {_first, _first ? _first->lowest() : 0, &_last};
+  }
+
+  template <typename T>
+  typename chunked_list<T>::iterator chunked_list<T>::end()
+  {
+    return {nullptr, 0, &_last};
+  }
+}
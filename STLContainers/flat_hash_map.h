@@ -0,0 +1,134 @@
+/***************************************************************************/
+/*!
+\brief  Open-addressing hash map, see flat_hash_table.h for the layout.
+        Unlike std::unordered_map there is no node per element, so
+        references and iterators are invalidated by any insert that grows
+        the table. std::string keys can be looked up by std::string_view
+        or const char* without building a std::string.
+*/
+/***************************************************************************/
+#ifndef _FLAT_HASH_MAP_H_
+#define _FLAT_HASH_MAP_H_
+
+#include "flat_hash_table.h"
+
+#include <tuple>
+
+namespace CustomSTL
+{
+  template <typename Key, typename T>
+  struct flat_map_policy
+  {
+    using key_type = Key;
+    using value_type = std::pair<const Key, T>;
+
+    static constexpr bool CONSTANT_ITERATORS = false;
+
+    static const Key& key(const value_type& value)
+    {
+      return value.first;
+    }
+
+    // The key is moved out despite being const, the source is destroyed
+    // right after and nothing can observe it
+    template <typename Alloc>
+    static void transfer(Alloc& alloc, value_type* dst, value_type* src)
+    {
+      using traits = std::allocator_traits<Alloc>;
+      traits::construct(alloc, dst, std::move(const_cast<Key&>(src->first)), std::move(src->second));
+      traits::destroy(alloc, src);
+    }
+  };
+
+  template <typename Key, typename T, typename Hash = flat_hash<Key>, typename KeyEqual = flat_equal<Key>,
+            typename Allocator = std::allocator<std::pair<const Key, T>>>
+  class flat_hash_map : public flat_hash_table<flat_map_policy<Key, T>, Hash, KeyEqual, Allocator>
+  {
+    using base = flat_hash_table<flat_map_policy<Key, T>, Hash, KeyEqual, Allocator>;
+
+    template <typename K>
+    using key_arg = typename base::template key_arg<K>;
+
+  public:
+    using mapped_type = T;
+    using typename base::key_type;
+    using typename base::value_type;
+    using typename base::iterator;
+    using typename base::const_iterator;
+
+    using base::base;
+    using base::insert;
+
+    flat_hash_map() = default;
+
+    /**********************************************************************/
+    /*!
+    \fn std::pair<iterator, bool> flat_hash_map::insert(P&& value)
+    \brief Inserts anything a value_type can be built from, a pair of a
+           key and a mapped value for instance
+    */
+    /**********************************************************************/
+    template <typename P>
+      requires std::is_constructible_v<value_type, P&&>
+    std::pair<iterator, bool> insert(P&& value)
+    {
+      return this->emplace(std::forward<P>(value));
+    }
+
+    /**********************************************************************/
+    /*!
+    \fn std::pair<iterator, bool> flat_hash_map::try_emplace(const key_type& key, Args&&... args)
+    \brief  Constructs the mapped value from args if the key is absent.
+            Nothing is constructed, moved or copied if it is present.
+    */
+    /**********************************************************************/
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args);
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args);
+
+    /**********************************************************************/
+    /*!
+    \fn std::pair<iterator, bool> flat_hash_map::insert_or_assign(const key_type& key, M&& value)
+    \brief  Inserts the value, or assigns it to the existing mapped value
+    */
+    /**********************************************************************/
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value);
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& value);
+
+    /**********************************************************************/
+    /*!
+    \fn T& flat_hash_map::operator[](const key_type& key)
+    \brief Returns the mapped value, value-initialising it if the key is
+           absent
+    */
+    /**********************************************************************/
+    T& operator[](const key_type& key);
+    T& operator[](key_type&& key);
+
+    /**********************************************************************/
+    /*!
+    \fn T& flat_hash_map::at(const key_arg<K>& key)
+    \brief Returns the mapped value, throws std::out_of_range if the key
+           is absent
+    */
+    /**********************************************************************/
+    template <typename K = key_type>
+    T& at(const key_arg<K>& key);
+
+    template <typename K = key_type>
+    const T& at(const key_arg<K>& key) const;
+
+  private:
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> TryEmplace(K&& key, Args&&... args);
+  };
+}
+
+#include "flat_hash_map.tpp"
+
+#endif
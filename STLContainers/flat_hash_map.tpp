@@ -0,0 +1,134 @@
+#include "flat_hash_map.h"
+
+#include <stdexcept>
+
+namespace CustomSTL
+{
+  /***********************************************************************/
+  /*!
+  \fn std::pair<iterator, bool> flat_hash_map::try_emplace(const key_type& key, Args&&... args)
+  \brief  Constructs the mapped value from args if the key is absent.
+          Nothing is constructed, moved or copied if it is present.
+  */
+  /***********************************************************************/
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename... Args>
+  std::pair<typename flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::iterator, bool>
+  flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::try_emplace(const key_type& key, Args&&... args)
+  {
+    return TryEmplace(key, std::forward<Args>(args)...);
+  }
+
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename... Args>
+  std::pair<typename flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::iterator, bool>
+  flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::try_emplace(key_type&& key, Args&&... args)
+  {
+    return TryEmplace(std::move(key), std::forward<Args>(args)...);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn std::pair<iterator, bool> flat_hash_map::insert_or_assign(const key_type& key, M&& value)
+  \brief  Inserts the value, or assigns it to the existing mapped value
+  */
+  /***********************************************************************/
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename M>
+  std::pair<typename flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::iterator, bool>
+  flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::insert_or_assign(const key_type& key, M&& value)
+  {
+    std::pair<iterator, bool> result = TryEmplace(key, std::forward<M>(value));
+    if (!result.second)
+    {
+      result.first->second = std::forward<M>(value);
+    }
+    return result;
+  }
+
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename M>
+  std::pair<typename flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::iterator, bool>
+  flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::insert_or_assign(key_type&& key, M&& value)
+  {
+    std::pair<iterator, bool> result = TryEmplace(std::move(key), std::forward<M>(value));
+    if (!result.second)
+    {
+      result.first->second = std::forward<M>(value);
+    }
+    return result;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn T& flat_hash_map::operator[](const key_type& key)
+  \brief Returns the mapped value, value-initialising it if the key is
+         absent
+  */
+  /***********************************************************************/
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  T& flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::operator[](const key_type& key)
+  {
+    return TryEmplace(key).first->second;
+  }
+
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  T& flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::operator[](key_type&& key)
+  {
+    return TryEmplace(std::move(key)).first->second;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn T& flat_hash_map::at(const key_arg<K>& key)
+  \brief Returns the mapped value, throws std::out_of_range if the key
+         is absent
+  */
+  /***********************************************************************/
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  T& flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::at(const key_arg<K>& key)
+  {
+    iterator found = this->template find<K>(key);
+    if (found == this->end())
+    {
+      throw std::out_of_range{"flat_hash_map: key not found"};
+    }
+    return found->second;
+  }
+
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  const T& flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::at(const key_arg<K>& key) const
+  {
+    const_iterator found = this->template find<K>(key);
+    if (found == this->end())
+    {
+      throw std::out_of_range{"flat_hash_map: key not found"};
+    }
+    return found->second;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn std::pair<iterator, bool> flat_hash_map::TryEmplace(K&& key, Args&&... args)
+  \brief  Looks the key up first and only builds the element in its slot
+          when the key is absent
+  */
+  /***********************************************************************/
+  template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K, typename... Args>
+  std::pair<typename flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::iterator, bool>
+  flat_hash_map<Key, T, Hash, KeyEqual, Allocator>::TryEmplace(K&& key, Args&&... args)
+  {
+    const size_t hash = this->HashOf(key);
+    const typename base::insert_position position = this->FindOrPrepareInsert(key, hash);
+    if (position.inserted)
+    {
+      this->ConstructAt(position.index, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+      this->CommitInsert(position.index, hash);
+    }
+    return {this->IteratorAt(position.index), position.inserted};
+  }
+}
@@ -0,0 +1,51 @@
+/***************************************************************************/
+/*!
+\brief  Open-addressing hash set, see flat_hash_table.h for the layout.
+        Iterators are always const since an element is its own key.
+        References and iterators are invalidated by any insert that grows
+        the table.
+*/
+/***************************************************************************/
+#ifndef _FLAT_HASH_SET_H_
+#define _FLAT_HASH_SET_H_
+
+#include "flat_hash_table.h"
+
+namespace CustomSTL
+{
+  template <typename Key>
+  struct flat_set_policy
+  {
+    using key_type = Key;
+    using value_type = Key;
+
+    static constexpr bool CONSTANT_ITERATORS = true;
+
+    static const Key& key(const value_type& value)
+    {
+      return value;
+    }
+
+    template <typename Alloc>
+    static void transfer(Alloc& alloc, value_type* dst, value_type* src)
+    {
+      using traits = std::allocator_traits<Alloc>;
+      traits::construct(alloc, dst, std::move(*src));
+      traits::destroy(alloc, src);
+    }
+  };
+
+  template <typename Key, typename Hash = flat_hash<Key>, typename KeyEqual = flat_equal<Key>,
+            typename Allocator = std::allocator<Key>>
+  class flat_hash_set : public flat_hash_table<flat_set_policy<Key>, Hash, KeyEqual, Allocator>
+  {
+    using base = flat_hash_table<flat_set_policy<Key>, Hash, KeyEqual, Allocator>;
+
+  public:
+    using base::base;
+
+    flat_hash_set() = default;
+  };
+}
+
+#endif
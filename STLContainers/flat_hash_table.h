@@ -0,0 +1,549 @@
+/***************************************************************************/
+/*!
+\brief  Open-addressing hash table shared by flat_hash_map and flat_hash_set.
+        Elements live directly in one slot array, next to a parallel array
+        of one control byte per slot. A control byte is either empty,
+        deleted, or the low 7 bits of the element's hash, so a probe loads
+        16 control bytes at once and compares all of them with one SSE2
+        instruction, and only touches the slots whose 7 bits matched.
+        The capacity is a power of two and the table grows at 7/8 full.
+        Erasing leaves a tombstone only when a probe could have passed over
+        the slot, otherwise the slot goes straight back to empty.
+        Inserting and rehashing invalidate iterators and references.
+*/
+/***************************************************************************/
+#ifndef _FLAT_HASH_TABLE_H_
+#define _FLAT_HASH_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CUSTOMSTL_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace CustomSTL
+{
+  /*!
+    Hash for std::string keys that also accepts std::string_view and
+    C strings, so lookups do not have to build a std::string
+  */
+  struct string_hash
+  {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view value) const noexcept
+    {
+      return std::hash<std::string_view>{}(value);
+    }
+  };
+
+  template <typename Key>
+  struct flat_hash_defaults
+  {
+    using hash = std::hash<Key>;
+    using key_equal = std::equal_to<Key>;
+  };
+
+  template <>
+  struct flat_hash_defaults<std::string>
+  {
+    using hash = string_hash;
+    using key_equal = std::equal_to<>;
+  };
+
+  // Default Hash and KeyEqual of flat_hash_map and flat_hash_set
+  template <typename Key>
+  using flat_hash = typename flat_hash_defaults<Key>::hash;
+
+  template <typename Key>
+  using flat_equal = typename flat_hash_defaults<Key>::key_equal;
+
+  namespace detail
+  {
+    using ctrl_t = int8_t;
+
+    static constexpr ctrl_t CTRL_EMPTY = -128;
+    static constexpr ctrl_t CTRL_DELETED = -2;
+    static constexpr size_t GROUP_WIDTH = 16;
+
+    // key_arg<K> is K when lookups are transparent, key_type otherwise.
+    // Going through a non-dependent member alias keeps K deducible.
+    template <bool Transparent>
+    struct key_arg_impl
+    {
+      template <typename K, typename Key>
+      using type = Key;
+    };
+
+    template <>
+    struct key_arg_impl<true>
+    {
+      template <typename K, typename Key>
+      using type = K;
+    };
+
+    /*!
+      16 control bytes loaded at once. Each match returns a bitmask with
+      bit i set if byte i matched.
+    */
+    class ctrl_group
+    {
+#ifdef CUSTOMSTL_FLAT_HASH_SSE2
+      __m128i _ctrl;
+#else
+      const ctrl_t* _ctrl;
+#endif
+
+    public:
+      explicit ctrl_group(const ctrl_t* pos);
+
+      uint32_t match(ctrl_t h2) const;
+      uint32_t match_empty() const;
+      uint32_t match_empty_or_deleted() const;
+      uint32_t match_full() const;
+    };
+
+    /*!
+      Iteration state of a probe: groups are visited at triangular
+      offsets, which reaches every group once when the capacity is a power
+      of two
+    */
+    class probe_seq
+    {
+      size_t _mask;
+      size_t _offset;
+      size_t _index;
+
+    public:
+      probe_seq(size_t hash, size_t mask) : _mask{mask}, _offset{hash & mask}, _index{0} {}
+
+      size_t offset() const { return _offset; }
+      size_t offset(unsigned i) const { return (_offset + i) & _mask; }
+
+      void next()
+      {
+        _index += GROUP_WIDTH;
+        _offset = (_offset + _index) & _mask;
+      }
+    };
+  }
+
+  /*!
+    Policy describes what a slot holds:
+      key_type, value_type
+      CONSTANT_ITERATORS         true if elements must not be modified
+      key(value)                 the key of an element
+      transfer(alloc, dst, src)  moves an element to another slot and
+                                 destroys the source
+  */
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  class flat_hash_table
+  {
+  public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+  protected:
+    using ctrl_t = detail::ctrl_t;
+    using slot_traits = std::allocator_traits<Allocator>;
+    using ctrl_allocator = typename slot_traits::template rebind_alloc<ctrl_t>;
+    using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+
+    static constexpr size_t NPOS = SIZE_MAX;
+
+    static constexpr bool TRANSPARENT = requires {
+      typename Hash::is_transparent;
+      typename KeyEqual::is_transparent;
+    };
+
+    // find and friends take any key type only when both the hash and the
+    // equality are transparent, otherwise K is pinned to key_type
+    template <typename K>
+    using key_arg = typename detail::key_arg_impl<TRANSPARENT>::template type<K, key_type>;
+
+  public:
+
+    template <bool IsConst>
+    class iterator_impl
+    {
+      using slot_ptr = std::conditional_t<IsConst, const typename Policy::value_type*, typename Policy::value_type*>;
+
+      const ctrl_t* _ctrl;
+      slot_ptr _slot;
+      const ctrl_t* _end;
+
+      friend class flat_hash_table;
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = typename Policy::value_type;
+      using difference_type = ptrdiff_t;
+      using pointer = slot_ptr;
+      using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+      iterator_impl();
+
+      /**********************************************************************/
+      /*!
+      \fn iterator_impl::iterator_impl(const ctrl_t* ctrl, slot_ptr slot, const ctrl_t* end)
+      \brief Conversion constructor for iterator_impl. Does not skip empty
+             slots.
+      */
+      /**********************************************************************/
+      iterator_impl(const ctrl_t* ctrl, slot_ptr slot, const ctrl_t* end);
+
+      /**********************************************************************/
+      /*!
+      \fn iterator_impl::operator iterator_impl<true>() const
+      \brief Allows an iterator to be used where a const_iterator is expected
+      */
+      /**********************************************************************/
+      operator iterator_impl<true>() const;
+
+      bool operator!=(const iterator_impl& rhs) const;
+
+      bool operator==(const iterator_impl& rhs) const;
+
+      /**********************************************************************/
+      /*!
+      \fn iterator_impl& iterator_impl::operator++()
+      \brief Pre-increment. Checks the next control byte, and past a hole
+             skips a group of empty slots at a time
+      \return Returns the current reference of the iterator
+      */
+      /**********************************************************************/
+      iterator_impl& operator++();
+
+      iterator_impl operator++(int);
+
+      reference operator*() const;
+
+      pointer operator->() const;
+
+    private:
+      void SkipEmpty();
+    };
+
+    // A set's elements are its keys, so its iterators are always const
+    using iterator = iterator_impl<Policy::CONSTANT_ITERATORS>;
+    using const_iterator = iterator_impl<true>;
+
+    /**********************************************************************/
+    /*!
+    \fn flat_hash_table::flat_hash_table()
+    \brief Default constructor. Allocates nothing until the first insert
+    */
+    /**********************************************************************/
+    flat_hash_table();
+
+    /**********************************************************************/
+    /*!
+    \fn flat_hash_table::flat_hash_table(size_type count, const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+    \brief Constructor reserving room for count elements
+    */
+    /**********************************************************************/
+    explicit flat_hash_table(size_type count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                             const Allocator& alloc = Allocator());
+
+    explicit flat_hash_table(const Allocator& alloc);
+
+    /**********************************************************************/
+    /*!
+    \fn flat_hash_table::flat_hash_table(TInputIterator begin, TInputIterator end, size_type count, const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+    \brief For Range Loop Constructor
+    */
+    /**********************************************************************/
+    template <typename TInputIterator>
+    flat_hash_table(TInputIterator begin, TInputIterator end, size_type count = 0, const Hash& hash = Hash(),
+                    const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator());
+
+    /**********************************************************************/
+    /*!
+    \fn flat_hash_table::flat_hash_table(std::initializer_list<value_type> values, size_type count, const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+    \brief Initializer list Constructor
+    */
+    /**********************************************************************/
+    flat_hash_table(std::initializer_list<value_type> values, size_type count = 0, const Hash& hash = Hash(),
+                    const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator());
+
+    /**********************************************************************/
+    /*!
+    \fn flat_hash_table::flat_hash_table(const flat_hash_table& rhs)
+    \brief Copy constructor. The copy is sized for rhs.size() and has no
+           tombstones
+    */
+    /**********************************************************************/
+    flat_hash_table(const flat_hash_table& rhs);
+
+    /**********************************************************************/
+    /*!
+    \fn flat_hash_table::flat_hash_table(flat_hash_table&& rhs)
+    \brief Move constructor. Takes rhs's arrays, rhs is left empty
+    */
+    /**********************************************************************/
+    flat_hash_table(flat_hash_table&& rhs) noexcept;
+
+    ~flat_hash_table();
+
+    flat_hash_table& operator=(const flat_hash_table& rhs);
+    flat_hash_table& operator=(flat_hash_table&& rhs) noexcept;
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    iterator begin();
+    iterator end();
+
+    bool empty() const;
+    size_type size() const;
+
+    /**********************************************************************/
+    /*!
+    \fn size_type flat_hash_table::capacity() const
+    \brief Returns the number of slots, a power of two or 0
+    */
+    /**********************************************************************/
+    size_type capacity() const;
+
+    float load_factor() const;
+
+    /**********************************************************************/
+    /*!
+    \fn void flat_hash_table::clear()
+    \brief Destroys every element and keeps the slot arrays
+    */
+    /**********************************************************************/
+    void clear();
+
+    /**********************************************************************/
+    /*!
+    \fn void flat_hash_table::reserve(size_type count)
+    \brief  Makes room for count elements. Inserting until size() reaches
+            count is then guaranteed not to rehash, as long as nothing is
+            erased in between.
+    */
+    /**********************************************************************/
+    void reserve(size_type count);
+
+    /**********************************************************************/
+    /*!
+    \fn void flat_hash_table::rehash(size_type count)
+    \brief  Rebuilds the table with at least count slots, or the fewest
+            that hold size() elements, which also drops every tombstone
+    */
+    /**********************************************************************/
+    void rehash(size_type count);
+
+    /**********************************************************************/
+    /*!
+    \fn std::pair<iterator, bool> flat_hash_table::insert(const value_type& value)
+    \brief  Inserts value if its key is not present
+    \return Iterator to the element with that key, and whether it was
+            inserted
+    */
+    /**********************************************************************/
+    std::pair<iterator, bool> insert(const value_type& value);
+    std::pair<iterator, bool> insert(value_type&& value);
+
+    template <typename TInputIterator>
+    void insert(TInputIterator begin, TInputIterator end);
+
+    void insert(std::initializer_list<value_type> values);
+
+    /**********************************************************************/
+    /*!
+    \fn std::pair<iterator, bool> flat_hash_table::emplace(Args&&... args)
+    \brief  Constructs an element and keeps it if its key is not present.
+            The element is built before the lookup, use try_emplace on a
+            map to avoid that.
+    */
+    /**********************************************************************/
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args);
+
+    /**********************************************************************/
+    /*!
+    \fn iterator flat_hash_table::find(const key_arg<K>& key)
+    \brief Looks up a key
+    \return Iterator to the element, end() if absent
+    */
+    /**********************************************************************/
+    template <typename K = key_type>
+    iterator find(const key_arg<K>& key);
+
+    template <typename K = key_type>
+    const_iterator find(const key_arg<K>& key) const;
+
+    template <typename K = key_type>
+    bool contains(const key_arg<K>& key) const;
+
+    template <typename K = key_type>
+    size_type count(const key_arg<K>& key) const;
+
+    /**********************************************************************/
+    /*!
+    \fn size_type flat_hash_table::erase(const key_arg<K>& key)
+    \brief  Removes the element with the key if there is one
+    \return The number of elements removed, 0 or 1
+    */
+    /**********************************************************************/
+    template <typename K = key_type>
+    size_type erase(const key_arg<K>& key);
+
+    /**********************************************************************/
+    /*!
+    \fn iterator flat_hash_table::erase(const_iterator pos)
+    \brief  Removes the element at pos. Only iterators to it are
+            invalidated.
+    \return Iterator to the element after the erased one
+    */
+    /**********************************************************************/
+    iterator erase(const_iterator pos);
+    iterator erase(iterator pos) requires (!Policy::CONSTANT_ITERATORS);
+
+    void swap(flat_hash_table& rhs) noexcept;
+
+    hasher hash_function() const;
+    key_equal key_eq() const;
+    allocator_type get_allocator() const;
+
+  protected:
+    // Result of FindOrPrepareInsert: the slot holding the key, or the free
+    // slot to construct it in
+    struct insert_position
+    {
+      size_t index;
+      bool inserted;
+    };
+
+    /**********************************************************************/
+    /*!
+    \fn insert_position flat_hash_table::FindOrPrepareInsert(const K& key, size_t hash)
+    \brief  Finds the key, or picks the slot it would be inserted in,
+            growing the table first if needed. The slot is not marked
+            full until CommitInsert.
+    */
+    /**********************************************************************/
+    template <typename K>
+    insert_position FindOrPrepareInsert(const K& key, size_t hash);
+
+    /**********************************************************************/
+    /*!
+    \fn void flat_hash_table::CommitInsert(size_t index, size_t hash)
+    \brief Marks the slot full once the element has been constructed in it
+    */
+    /**********************************************************************/
+    void CommitInsert(size_t index, size_t hash);
+
+    /**********************************************************************/
+    /*!
+    \fn size_t flat_hash_table::HashOf(const K& key) const
+    \brief  Hashes a key and mixes the bits, so a weak hash such as the
+            identity std::hash of integers still spreads over the 7 bits
+            kept in the control byte and the bits used for the position
+    */
+    /**********************************************************************/
+    template <typename K>
+    size_t HashOf(const K& key) const;
+
+    value_type* SlotAt(size_t index) const;
+    iterator IteratorAt(size_t index);
+    const_iterator IteratorAt(size_t index) const;
+
+    template <typename... Args>
+    void ConstructAt(size_t index, Args&&... args);
+
+  private:
+    ctrl_t* _ctrl;
+    value_type* _slots;
+    size_t _capacity;
+    size_t _size;
+    size_t _growth_left; //!< Empty slots that can be filled before growing
+    [[no_unique_address]] Hash _hash;
+    [[no_unique_address]] KeyEqual _equal;
+    [[no_unique_address]] Allocator _alloc;
+
+    /**********************************************************************/
+    /*!
+    \fn size_t flat_hash_table::FindIndex(const K& key, size_t hash) const
+    \brief Returns the slot holding the key, NPOS if absent
+    */
+    /**********************************************************************/
+    template <typename K>
+    size_t FindIndex(const K& key, size_t hash) const;
+
+    /**********************************************************************/
+    /*!
+    \fn size_t flat_hash_table::FindFirstNonFull(size_t hash) const
+    \brief Returns the first empty or deleted slot on the probe sequence
+    */
+    /**********************************************************************/
+    size_t FindFirstNonFull(size_t hash) const;
+
+    /**********************************************************************/
+    /*!
+    \fn void flat_hash_table::SetCtrl(size_t index, ctrl_t value)
+    \brief  Sets a control byte, and its copy past the end when it is one
+            of the first GROUP_WIDTH bytes so a group load near the end
+            wraps around
+    */
+    /**********************************************************************/
+    void SetCtrl(size_t index, ctrl_t value);
+
+    /**********************************************************************/
+    /*!
+    \fn void flat_hash_table::EraseAt(size_t index)
+    \brief  Destroys the element in the slot and marks it empty if no
+            probe could have passed over it while it was full, deleted
+            otherwise
+    */
+    /**********************************************************************/
+    void EraseAt(size_t index);
+
+    /**********************************************************************/
+    /*!
+    \fn void flat_hash_table::Resize(size_t capacity)
+    \brief  Moves every element into fresh arrays of the given capacity
+    */
+    /**********************************************************************/
+    void Resize(size_t capacity);
+
+    /**********************************************************************/
+    /*!
+    \fn void flat_hash_table::GrowOrCompact()
+    \brief  Called when no empty slot is left to fill. Rebuilds at the same
+            capacity if tombstones are what filled it, doubles otherwise
+    */
+    /**********************************************************************/
+    void GrowOrCompact();
+
+    void DestroyElements();
+    void Deallocate();
+
+    static size_t MaxLoad(size_t capacity);
+    static size_t CapacityFor(size_t count);
+  };
+}
+
+#include "flat_hash_table.tpp"
+
+#endif
@@ -0,0 +1,1088 @@
+#include "flat_hash_table.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace CustomSTL
+{
+  namespace detail
+  {
+    inline size_t H1(size_t hash)
+    {
+      return hash >> 7;
+    }
+
+    inline ctrl_t H2(size_t hash)
+    {
+      return static_cast<ctrl_t>(hash & 0x7F);
+    }
+
+#ifdef CUSTOMSTL_FLAT_HASH_SSE2
+    inline ctrl_group::ctrl_group(const ctrl_t* pos) :
+      _ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))}
+    {
+    }
+
+    inline uint32_t ctrl_group::match(ctrl_t h2) const
+    {
+      return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+    }
+
+    inline uint32_t ctrl_group::match_empty() const
+    {
+      return match(CTRL_EMPTY);
+    }
+
+    // Empty and deleted are the control bytes below -1
+    inline uint32_t ctrl_group::match_empty_or_deleted() const
+    {
+      return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl)));
+    }
+
+    // Full control bytes are the ones with the sign bit clear
+    inline uint32_t ctrl_group::match_full() const
+    {
+      return static_cast<uint32_t>(_mm_movemask_epi8(_ctrl)) ^ 0xFFFFu;
+    }
+#else
+    inline ctrl_group::ctrl_group(const ctrl_t* pos) :
+      _ctrl{pos}
+    {
+    }
+
+    inline uint32_t ctrl_group::match(ctrl_t h2) const
+    {
+      uint32_t mask = 0;
+      for (unsigned i = 0; i < GROUP_WIDTH; ++i)
+      {
+        mask |= static_cast<uint32_t>(_ctrl[i] == h2) << i;
+      }
+      return mask;
+    }
+
+    inline uint32_t ctrl_group::match_empty() const
+    {
+      return match(CTRL_EMPTY);
+    }
+
+    inline uint32_t ctrl_group::match_empty_or_deleted() const
+    {
+      uint32_t mask = 0;
+      for (unsigned i = 0; i < GROUP_WIDTH; ++i)
+      {
+        mask |= static_cast<uint32_t>(_ctrl[i] < -1) << i;
+      }
+      return mask;
+    }
+
+    inline uint32_t ctrl_group::match_full() const
+    {
+      uint32_t mask = 0;
+      for (unsigned i = 0; i < GROUP_WIDTH; ++i)
+      {
+        mask |= static_cast<uint32_t>(_ctrl[i] >= 0) << i;
+      }
+      return mask;
+    }
+#endif
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::iterator_impl::iterator_impl()
+  \brief Default constructor, a singular iterator
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::iterator_impl() :
+    _ctrl{nullptr},
+    _slot{nullptr},
+    _end{nullptr}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::iterator_impl::iterator_impl(const ctrl_t* ctrl, slot_ptr slot, const ctrl_t* end)
+  \brief Conversion constructor for iterator_impl. Does not skip empty
+         slots.
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::iterator_impl(
+    const ctrl_t* ctrl, slot_ptr slot, const ctrl_t* end) :
+    _ctrl{ctrl},
+    _slot{slot},
+    _end{end}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::iterator_impl::operator iterator_impl<true>() const
+  \brief Allows an iterator to be used where a const_iterator is expected
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::operator iterator_impl<true>() const
+  {
+    return iterator_impl<true>{_ctrl, _slot, _end};
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  bool flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::operator!=(
+    const iterator_impl& rhs) const
+  {
+    return _ctrl != rhs._ctrl;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  bool flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::operator==(
+    const iterator_impl& rhs) const
+  {
+    return _ctrl == rhs._ctrl;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::iterator_impl& flat_hash_table::iterator_impl::operator++()
+  \brief Pre-increment. Checks the next control byte, and past a hole
+             skips a group of empty slots at a time
+  \return Returns the current reference of the iterator
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::template iterator_impl<IsConst>&
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::operator++()
+  {
+    ++_ctrl;
+    ++_slot;
+    if (_ctrl != _end && *_ctrl < 0)
+    {
+      SkipEmpty();
+    }
+    return *this;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::template iterator_impl<IsConst>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::operator++(int)
+  {
+    iterator_impl old = *this;
+    ++(*this);
+    return old;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::template iterator_impl<IsConst>::reference
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::operator*() const
+  {
+    return *_slot;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::template iterator_impl<IsConst>::pointer
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::operator->() const
+  {
+    return _slot;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::iterator_impl::SkipEmpty()
+  \brief  Moves to the next full slot at or after the current one, or to
+          the end. The group load may read the wrapped copy of the first
+          control bytes, matches past the end are masked off.
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <bool IsConst>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator_impl<IsConst>::SkipEmpty()
+  {
+    while (_ctrl != _end)
+    {
+      const size_t remaining = static_cast<size_t>(_end - _ctrl);
+      uint32_t full = detail::ctrl_group(_ctrl).match_full();
+      if (remaining < detail::GROUP_WIDTH)
+      {
+        full &= (1u << remaining) - 1;
+      }
+
+      const size_t step = full ? static_cast<size_t>(std::countr_zero(full))
+                               : std::min(detail::GROUP_WIDTH, remaining);
+      _ctrl += step;
+      _slot += step;
+      if (full)
+      {
+        return;
+      }
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::flat_hash_table()
+  \brief Default constructor. Allocates nothing until the first insert
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::flat_hash_table() :
+    flat_hash_table(Allocator())
+  {
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::flat_hash_table(const Allocator& alloc) :
+    _ctrl{nullptr},
+    _slots{nullptr},
+    _capacity{0},
+    _size{0},
+    _growth_left{0},
+    _hash{},
+    _equal{},
+    _alloc{alloc}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::flat_hash_table(size_type count, const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+  \brief Constructor reserving room for count elements
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::flat_hash_table(size_type count, const Hash& hash,
+                                                                       const KeyEqual& equal,
+                                                                       const Allocator& alloc) :
+    _ctrl{nullptr},
+    _slots{nullptr},
+    _capacity{0},
+    _size{0},
+    _growth_left{0},
+    _hash{hash},
+    _equal{equal},
+    _alloc{alloc}
+  {
+    reserve(count);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::flat_hash_table(TInputIterator begin, TInputIterator end, size_type count, const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+  \brief For Range Loop Constructor
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename TInputIterator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::flat_hash_table(TInputIterator begin, TInputIterator end,
+                                                                       size_type count, const Hash& hash,
+                                                                       const KeyEqual& equal,
+                                                                       const Allocator& alloc) :
+    flat_hash_table(count, hash, equal, alloc)
+  {
+    insert(begin, end);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::flat_hash_table(std::initializer_list<value_type> values, size_type count, const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+  \brief Initializer list Constructor
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::flat_hash_table(std::initializer_list<value_type> values,
+                                                                       size_type count, const Hash& hash,
+                                                                       const KeyEqual& equal,
+                                                                       const Allocator& alloc) :
+    flat_hash_table(std::max(count, values.size()), hash, equal, alloc)
+  {
+    insert(values.begin(), values.end());
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::flat_hash_table(const flat_hash_table& rhs)
+  \brief Copy constructor. The copy is sized for rhs.size() and has no
+         tombstones
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::flat_hash_table(const flat_hash_table& rhs) :
+    flat_hash_table(rhs._size, rhs._hash, rhs._equal,
+                    slot_traits::select_on_container_copy_construction(rhs._alloc))
+  {
+    // The keys are known to be distinct, so no lookup is needed. If a copy
+    // throws, the delegated constructor has finished and the destructor
+    // cleans up.
+    for (const value_type& value : rhs)
+    {
+      const size_t hash = HashOf(Policy::key(value));
+      const size_t index = FindFirstNonFull(hash);
+      ConstructAt(index, value);
+      CommitInsert(index, hash);
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn flat_hash_table::flat_hash_table(flat_hash_table&& rhs)
+  \brief Move constructor. Takes rhs's arrays, rhs is left empty
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::flat_hash_table(flat_hash_table&& rhs) noexcept :
+    _ctrl{std::exchange(rhs._ctrl, nullptr)},
+    _slots{std::exchange(rhs._slots, nullptr)},
+    _capacity{std::exchange(rhs._capacity, 0)},
+    _size{std::exchange(rhs._size, 0)},
+    _growth_left{std::exchange(rhs._growth_left, 0)},
+    _hash{std::move(rhs._hash)},
+    _equal{std::move(rhs._equal)},
+    _alloc{std::move(rhs._alloc)}
+  {
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::~flat_hash_table()
+  {
+    DestroyElements();
+    Deallocate();
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>&
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::operator=(const flat_hash_table& rhs)
+  {
+    if (this != &rhs)
+    {
+      flat_hash_table copy(rhs);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>&
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::operator=(flat_hash_table&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      DestroyElements();
+      Deallocate();
+      _ctrl = std::exchange(rhs._ctrl, nullptr);
+      _slots = std::exchange(rhs._slots, nullptr);
+      _capacity = std::exchange(rhs._capacity, 0);
+      _size = std::exchange(rhs._size, 0);
+      _growth_left = std::exchange(rhs._growth_left, 0);
+      _hash = std::move(rhs._hash);
+      _equal = std::move(rhs._equal);
+      _alloc = std::move(rhs._alloc);
+    }
+    return *this;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::const_iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::cbegin() const
+  {
+    const_iterator first{_ctrl, _slots, _ctrl + _capacity};
+    first.SkipEmpty();
+    return first;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::const_iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::cend() const
+  {
+    return const_iterator{_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity};
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::const_iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::begin() const
+  {
+    return cbegin();
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::const_iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::end() const
+  {
+    return cend();
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::begin()
+  {
+    iterator first{_ctrl, _slots, _ctrl + _capacity};
+    first.SkipEmpty();
+    return first;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::end()
+  {
+    return iterator{_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity};
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  bool flat_hash_table<Policy, Hash, KeyEqual, Allocator>::empty() const
+  {
+    return _size == 0;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::size_type
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::size() const
+  {
+    return _size;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn size_type flat_hash_table::capacity() const
+  \brief Returns the number of slots, a power of two or 0
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::size_type
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::capacity() const
+  {
+    return _capacity;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  float flat_hash_table<Policy, Hash, KeyEqual, Allocator>::load_factor() const
+  {
+    return _capacity ? static_cast<float>(_size) / static_cast<float>(_capacity) : 0.0f;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::clear()
+  \brief Destroys every element and keeps the slot arrays
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::clear()
+  {
+    DestroyElements();
+    if (_capacity)
+    {
+      std::memset(_ctrl, static_cast<unsigned char>(detail::CTRL_EMPTY), _capacity + detail::GROUP_WIDTH);
+    }
+    _size = 0;
+    _growth_left = MaxLoad(_capacity);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::reserve(size_type count)
+  \brief  Makes room for count elements. Inserting until size() reaches
+          count is then guaranteed not to rehash, as long as nothing is
+          erased in between.
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::reserve(size_type count)
+  {
+    if (count > _size + _growth_left)
+    {
+      Resize(std::max(CapacityFor(count), _capacity));
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::rehash(size_type count)
+  \brief  Rebuilds the table with at least count slots, or the fewest
+          that hold size() elements, which also drops every tombstone
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::rehash(size_type count)
+  {
+    size_t capacity = CapacityFor(_size);
+    if (count)
+    {
+      capacity = std::max({capacity, std::bit_ceil(count), detail::GROUP_WIDTH});
+    }
+
+    if (capacity == 0)
+    {
+      Deallocate();
+      _growth_left = 0;
+    }
+    else
+    {
+      Resize(capacity);
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn std::pair<iterator, bool> flat_hash_table::insert(const value_type& value)
+  \brief  Inserts value if its key is not present
+  \return Iterator to the element with that key, and whether it was
+          inserted
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  std::pair<typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator, bool>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::insert(const value_type& value)
+  {
+    const size_t hash = HashOf(Policy::key(value));
+    const insert_position position = FindOrPrepareInsert(Policy::key(value), hash);
+    if (position.inserted)
+    {
+      ConstructAt(position.index, value);
+      CommitInsert(position.index, hash);
+    }
+    return {IteratorAt(position.index), position.inserted};
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  std::pair<typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator, bool>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::insert(value_type&& value)
+  {
+    const size_t hash = HashOf(Policy::key(value));
+    const insert_position position = FindOrPrepareInsert(Policy::key(value), hash);
+    if (position.inserted)
+    {
+      ConstructAt(position.index, std::move(value));
+      CommitInsert(position.index, hash);
+    }
+    return {IteratorAt(position.index), position.inserted};
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename TInputIterator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::insert(TInputIterator begin, TInputIterator end)
+  {
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                    typename std::iterator_traits<TInputIterator>::iterator_category>)
+    {
+      reserve(_size + static_cast<size_t>(std::distance(begin, end)));
+    }
+
+    while (begin != end)
+    {
+      emplace(*begin++);
+    }
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::insert(std::initializer_list<value_type> values)
+  {
+    insert(values.begin(), values.end());
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn std::pair<iterator, bool> flat_hash_table::emplace(Args&&... args)
+  \brief  Constructs an element and keeps it if its key is not present.
+          The element is built before the lookup, use try_emplace on a
+          map to avoid that.
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename... Args>
+  std::pair<typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator, bool>
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::emplace(Args&&... args)
+  {
+    alignas(value_type) unsigned char buffer[sizeof(value_type)];
+    value_type* element = reinterpret_cast<value_type*>(buffer);
+    slot_traits::construct(_alloc, element, std::forward<Args>(args)...);
+
+    size_t hash = 0;
+    insert_position position{};
+    try
+    {
+      hash = HashOf(Policy::key(*element));
+      position = FindOrPrepareInsert(Policy::key(*element), hash);
+    }
+    catch (...)
+    {
+      slot_traits::destroy(_alloc, element);
+      throw;
+    }
+
+    if (position.inserted)
+    {
+      Policy::transfer(_alloc, SlotAt(position.index), element);
+      CommitInsert(position.index, hash);
+    }
+    else
+    {
+      slot_traits::destroy(_alloc, element);
+    }
+    return {IteratorAt(position.index), position.inserted};
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn iterator flat_hash_table::find(const key_arg<K>& key)
+  \brief Looks up a key
+  \return Iterator to the element, end() if absent
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::find(const key_arg<K>& key)
+  {
+    const size_t index = FindIndex(key, HashOf(key));
+    return index == NPOS ? end() : IteratorAt(index);
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::const_iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::find(const key_arg<K>& key) const
+  {
+    const size_t index = FindIndex(key, HashOf(key));
+    return index == NPOS ? end() : IteratorAt(index);
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  bool flat_hash_table<Policy, Hash, KeyEqual, Allocator>::contains(const key_arg<K>& key) const
+  {
+    return FindIndex(key, HashOf(key)) != NPOS;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::size_type
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::count(const key_arg<K>& key) const
+  {
+    return contains<K>(key) ? 1 : 0;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn size_type flat_hash_table::erase(const key_arg<K>& key)
+  \brief  Removes the element with the key if there is one
+  \return The number of elements removed, 0 or 1
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::size_type
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::erase(const key_arg<K>& key)
+  {
+    const size_t index = FindIndex(key, HashOf(key));
+    if (index == NPOS)
+    {
+      return 0;
+    }
+
+    EraseAt(index);
+    return 1;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn iterator flat_hash_table::erase(const_iterator pos)
+  \brief  Removes the element at pos. Only iterators to it are
+          invalidated.
+  \return Iterator to the element after the erased one
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::erase(const_iterator pos)
+  {
+    const size_t index = static_cast<size_t>(pos._ctrl - _ctrl);
+    EraseAt(index);
+
+    iterator next{_ctrl + index + 1, _slots + index + 1, _ctrl + _capacity};
+    next.SkipEmpty();
+    return next;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::erase(iterator pos) requires (!Policy::CONSTANT_ITERATORS)
+  {
+    return erase(const_iterator{pos});
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::swap(flat_hash_table& rhs) noexcept
+  {
+    using std::swap;
+    swap(_ctrl, rhs._ctrl);
+    swap(_slots, rhs._slots);
+    swap(_capacity, rhs._capacity);
+    swap(_size, rhs._size);
+    swap(_growth_left, rhs._growth_left);
+    swap(_hash, rhs._hash);
+    swap(_equal, rhs._equal);
+    swap(_alloc, rhs._alloc);
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::hasher
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::hash_function() const
+  {
+    return _hash;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::key_equal
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::key_eq() const
+  {
+    return _equal;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::allocator_type
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::get_allocator() const
+  {
+    return _alloc;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn insert_position flat_hash_table::FindOrPrepareInsert(const K& key, size_t hash)
+  \brief  Finds the key, or picks the slot it would be inserted in,
+          growing the table first if needed. The slot is not marked
+          full until CommitInsert.
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::insert_position
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::FindOrPrepareInsert(const K& key, size_t hash)
+  {
+    size_t index = FindIndex(key, hash);
+    if (index != NPOS)
+    {
+      return {index, false};
+    }
+
+    // Reusing a tombstone does not use up an empty slot, so it is allowed
+    // even when the table is due to grow
+    if (_capacity)
+    {
+      index = FindFirstNonFull(hash);
+      if (_growth_left || _ctrl[index] == detail::CTRL_DELETED)
+      {
+        return {index, true};
+      }
+    }
+
+    GrowOrCompact();
+    return {FindFirstNonFull(hash), true};
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::CommitInsert(size_t index, size_t hash)
+  \brief Marks the slot full once the element has been constructed in it
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::CommitInsert(size_t index, size_t hash)
+  {
+    if (_ctrl[index] == detail::CTRL_EMPTY)
+    {
+      --_growth_left;
+    }
+    SetCtrl(index, detail::H2(hash));
+    ++_size;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn size_t flat_hash_table::HashOf(const K& key) const
+  \brief  Hashes a key and mixes the bits, so a weak hash such as the
+          identity std::hash of integers still spreads over the 7 bits
+          kept in the control byte and the bits used for the position
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  size_t flat_hash_table<Policy, Hash, KeyEqual, Allocator>::HashOf(const K& key) const
+  {
+    uint64_t hash = static_cast<uint64_t>(_hash(key));
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return static_cast<size_t>(hash);
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::value_type*
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::SlotAt(size_t index) const
+  {
+    return _slots + index;
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::IteratorAt(size_t index)
+  {
+    return iterator{_ctrl + index, _slots + index, _ctrl + _capacity};
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  typename flat_hash_table<Policy, Hash, KeyEqual, Allocator>::const_iterator
+  flat_hash_table<Policy, Hash, KeyEqual, Allocator>::IteratorAt(size_t index) const
+  {
+    return const_iterator{_ctrl + index, _slots + index, _ctrl + _capacity};
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename... Args>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::ConstructAt(size_t index, Args&&... args)
+  {
+    slot_traits::construct(_alloc, _slots + index, std::forward<Args>(args)...);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn size_t flat_hash_table::FindIndex(const K& key, size_t hash) const
+  \brief Returns the slot holding the key, NPOS if absent
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  template <typename K>
+  size_t flat_hash_table<Policy, Hash, KeyEqual, Allocator>::FindIndex(const K& key, size_t hash) const
+  {
+    if (!_capacity)
+    {
+      return NPOS;
+    }
+
+    const ctrl_t h2 = detail::H2(hash);
+    detail::probe_seq sequence(detail::H1(hash), _capacity - 1);
+    while (true)
+    {
+      const detail::ctrl_group group(_ctrl + sequence.offset());
+      for (uint32_t match = group.match(h2); match; match &= match - 1)
+      {
+        const size_t index = sequence.offset(static_cast<unsigned>(std::countr_zero(match)));
+        if (_equal(Policy::key(_slots[index]), key))
+        {
+          return index;
+        }
+      }
+
+      // An empty slot ends the probe, the key would have been placed there
+      if (group.match_empty())
+      {
+        return NPOS;
+      }
+      sequence.next();
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn size_t flat_hash_table::FindFirstNonFull(size_t hash) const
+  \brief Returns the first empty or deleted slot on the probe sequence
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  size_t flat_hash_table<Policy, Hash, KeyEqual, Allocator>::FindFirstNonFull(size_t hash) const
+  {
+    detail::probe_seq sequence(detail::H1(hash), _capacity - 1);
+    while (true)
+    {
+      const uint32_t match = detail::ctrl_group(_ctrl + sequence.offset()).match_empty_or_deleted();
+      if (match)
+      {
+        return sequence.offset(static_cast<unsigned>(std::countr_zero(match)));
+      }
+      sequence.next();
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::SetCtrl(size_t index, ctrl_t value)
+  \brief  Sets a control byte, and its copy past the end when it is one
+          of the first GROUP_WIDTH bytes so a group load near the end
+          wraps around
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::SetCtrl(size_t index, ctrl_t value)
+  {
+    _ctrl[index] = value;
+    if (index < detail::GROUP_WIDTH)
+    {
+      _ctrl[_capacity + index] = value;
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::EraseAt(size_t index)
+  \brief  Destroys the element in the slot and marks it empty if no
+          probe could have passed over it while it was full, deleted
+          otherwise
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::EraseAt(size_t index)
+  {
+    slot_traits::destroy(_alloc, _slots + index);
+    --_size;
+
+    // A probe only moves past a group with no empty slot. If the run of
+    // non-empty slots through this one is shorter than a group, no group
+    // containing it was ever without an empty slot.
+    const size_t before = (index - detail::GROUP_WIDTH) & (_capacity - 1);
+    const uint32_t emptyAfter = detail::ctrl_group(_ctrl + index).match_empty();
+    const uint32_t emptyBefore = detail::ctrl_group(_ctrl + before).match_empty();
+    const bool wasNeverFull =
+      emptyBefore && emptyAfter &&
+      static_cast<size_t>(std::countl_zero(static_cast<uint16_t>(emptyBefore)) + std::countr_zero(emptyAfter)) <
+        detail::GROUP_WIDTH;
+
+    if (wasNeverFull)
+    {
+      SetCtrl(index, detail::CTRL_EMPTY);
+      ++_growth_left;
+    }
+    else
+    {
+      SetCtrl(index, detail::CTRL_DELETED);
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::Resize(size_t capacity)
+  \brief  Moves every element into fresh arrays of the given capacity
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::Resize(size_t capacity)
+  {
+    ctrl_allocator ctrlAlloc(_alloc);
+    ctrl_t* ctrl = ctrl_traits::allocate(ctrlAlloc, capacity + detail::GROUP_WIDTH);
+    value_type* slots = nullptr;
+    try
+    {
+      slots = slot_traits::allocate(_alloc, capacity);
+    }
+    catch (...)
+    {
+      ctrl_traits::deallocate(ctrlAlloc, ctrl, capacity + detail::GROUP_WIDTH);
+      throw;
+    }
+    std::memset(ctrl, static_cast<unsigned char>(detail::CTRL_EMPTY), capacity + detail::GROUP_WIDTH);
+
+    ctrl_t* const oldCtrl = std::exchange(_ctrl, ctrl);
+    value_type* const oldSlots = std::exchange(_slots, slots);
+    const size_t oldCapacity = std::exchange(_capacity, capacity);
+
+    for (size_t i = 0; i < oldCapacity; ++i)
+    {
+      if (oldCtrl[i] >= 0)
+      {
+        const size_t hash = HashOf(Policy::key(oldSlots[i]));
+        const size_t index = FindFirstNonFull(hash);
+        Policy::transfer(_alloc, _slots + index, oldSlots + i);
+        SetCtrl(index, detail::H2(hash));
+      }
+    }
+    _growth_left = MaxLoad(_capacity) - _size;
+
+    if (oldCapacity)
+    {
+      ctrl_traits::deallocate(ctrlAlloc, oldCtrl, oldCapacity + detail::GROUP_WIDTH);
+      slot_traits::deallocate(_alloc, oldSlots, oldCapacity);
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void flat_hash_table::GrowOrCompact()
+  \brief  Called when no empty slot is left to fill. Rebuilds at the same
+          capacity if tombstones are what filled it, doubles otherwise
+  */
+  /***********************************************************************/
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::GrowOrCompact()
+  {
+    if (_capacity && _size * 32 <= _capacity * 25)
+    {
+      Resize(_capacity);
+    }
+    else
+    {
+      Resize(_capacity ? _capacity * 2 : detail::GROUP_WIDTH);
+    }
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::DestroyElements()
+  {
+    if constexpr (!std::is_trivially_destructible_v<value_type>)
+    {
+      for (size_t i = 0; i < _capacity; ++i)
+      {
+        if (_ctrl[i] >= 0)
+        {
+          slot_traits::destroy(_alloc, _slots + i);
+        }
+      }
+    }
+  }
+
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  void flat_hash_table<Policy, Hash, KeyEqual, Allocator>::Deallocate()
+  {
+    if (_capacity)
+    {
+      ctrl_allocator ctrlAlloc(_alloc);
+      ctrl_traits::deallocate(ctrlAlloc, _ctrl, _capacity + detail::GROUP_WIDTH);
+      slot_traits::deallocate(_alloc, _slots, _capacity);
+    }
+    _ctrl = nullptr;
+    _slots = nullptr;
+    _capacity = 0;
+    _size = 0;
+  }
+
+  // Largest size before the table grows, 7/8 of the capacity
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  size_t flat_hash_table<Policy, Hash, KeyEqual, Allocator>::MaxLoad(size_t capacity)
+  {
+    return capacity - capacity / 8;
+  }
+
+  // Smallest capacity that holds count elements without growing
+  template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+  size_t flat_hash_table<Policy, Hash, KeyEqual, Allocator>::CapacityFor(size_t count)
+  {
+    if (count == 0)
+    {
+      return 0;
+    }
+
+    size_t capacity = detail::GROUP_WIDTH;
+    while (MaxLoad(capacity) < count)
+    {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+}
@@ -0,0 +1,321 @@
+/***************************************************************************/
+/*!
+\brief  A doubly-linked list whose links live inside the elements.
+        An element embeds an intrusive_list_hook and the list is told which
+        member it is, intrusive_list<Timer, &Timer::hook>. The list never
+        allocates or copies, it only links objects that are owned elsewhere.
+        The links are circular around a sentinel, so an element can unlink
+        itself in O(1) without knowing which list it is in. Because of that
+        the list does not keep a count, size() walks the list.
+*/
+/***************************************************************************/
+#ifndef _INTRUSIVE_LIST_H_
+#define _INTRUSIVE_LIST_H_
+
+#include <cstddef>
+#include <iterator>
+
+namespace CustomSTL
+{
+  /*!
+    Links to embed in an element of an intrusive_list.
+    Copying an element does not copy its links, and a hook that is
+    destroyed while linked unlinks itself. Linking also records the
+    element that embeds the hook, so the list gets back from a link to
+    its element without pointer arithmetic on T.
+  */
+  class intrusive_list_hook
+  {
+    intrusive_list_hook* _prev;
+    intrusive_list_hook* _next;
+    void* _owner;
+
+    template <typename T, intrusive_list_hook T::*Hook>
+    friend class intrusive_list;
+  public:
+    intrusive_list_hook();
+    intrusive_list_hook(const intrusive_list_hook&);
+    intrusive_list_hook& operator=(const intrusive_list_hook&);
+    ~intrusive_list_hook();
+
+    /**********************************************************************/
+    /*!
+    \fn bool intrusive_list_hook::is_linked() const
+    \brief Checks if the element is currently in a list
+    */
+    /**********************************************************************/
+    bool is_linked() const;
+
+    /**********************************************************************/
+    /*!
+    \fn void intrusive_list_hook::unlink()
+    \brief Removes the element from whichever list it is in. Does nothing
+           if it is not linked.
+    */
+    /**********************************************************************/
+    void unlink();
+
+  private:
+    void link_before(intrusive_list_hook* pos);
+  };
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  class intrusive_list
+  {
+    intrusive_list_hook _sentinel;
+
+  public:
+
+    class const_iterator_impl;
+
+    class iterator_impl
+    {
+      intrusive_list_hook* _curr;
+
+      friend class intrusive_list;
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = T;
+      using difference_type = ptrdiff_t;
+      using pointer = value_type*;
+      using reference = value_type&;
+
+      bool operator!=(const iterator_impl& rhs) const;
+
+      bool operator==(const iterator_impl& rhs) const;
+
+      iterator_impl& operator++();
+
+      iterator_impl& operator--();
+
+      iterator_impl operator++(int);
+
+      iterator_impl operator--(int);
+
+      reference operator*() const;
+
+      pointer operator->() const;
+
+      operator const_iterator_impl() const;
+
+      iterator_impl(intrusive_list_hook* curr = nullptr);
+    };
+
+    class const_iterator_impl
+    {
+      const intrusive_list_hook* _curr;
+
+      friend class intrusive_list;
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = typename iterator_impl::value_type;
+      using difference_type = typename iterator_impl::difference_type;
+      using pointer = const value_type*;
+      using reference = const value_type&;
+
+      bool operator!=(const const_iterator_impl& rhs) const;
+
+      bool operator==(const const_iterator_impl& rhs) const;
+
+      const_iterator_impl& operator++();
+
+      const_iterator_impl& operator--();
+
+      const_iterator_impl operator++(int);
+
+      const_iterator_impl operator--(int);
+
+      reference operator*() const;
+
+      pointer operator->() const;
+
+      const_iterator_impl(const intrusive_list_hook* curr = nullptr);
+    };
+
+    using size_type = size_t;
+    using iterator = iterator_impl;
+    using const_iterator = const_iterator_impl;
+    using difference_type = typename iterator::difference_type;
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+    using const_pointer = const T*;
+    using const_reference = const T&;
+
+    /**********************************************************************/
+    /*!
+    \fn intrusive_list<T, Hook>::intrusive_list()
+    \brief Default constructor for intrusive_list
+    */
+    /**********************************************************************/
+    intrusive_list();
+
+    /**********************************************************************/
+    /*!
+    \fn intrusive_list<T, Hook>::~intrusive_list()
+    \brief Unlinks every element. The elements themselves are untouched.
+    */
+    /**********************************************************************/
+    ~intrusive_list();
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    /**********************************************************************/
+    /*!
+    \fn reference intrusive_list<T, Hook>::front()
+    \brief Returns a reference to the first element
+    */
+    /**********************************************************************/
+    reference front();
+
+    /**********************************************************************/
+    /*!
+    \fn const_reference intrusive_list<T, Hook>::front() const
+    \brief Returns a const reference to the first element
+    */
+    /**********************************************************************/
+    const_reference front() const;
+
+    /**********************************************************************/
+    /*!
+    \fn reference intrusive_list<T, Hook>::back()
+    \brief Returns a reference to the last element
+    */
+    /**********************************************************************/
+    reference back();
+
+    /**********************************************************************/
+    /*!
+    \fn const_reference intrusive_list<T, Hook>::back() const
+    \brief Returns a const reference to the last element
+    */
+    /**********************************************************************/
+    const_reference back() const;
+
+    /**********************************************************************/
+    /*!
+    \fn void intrusive_list<T, Hook>::push_back(T& value)
+    \brief Links value at the back of the list. value must not be linked.
+    */
+    /**********************************************************************/
+    void push_back(T& value);
+
+    /**********************************************************************/
+    /*!
+    \fn void intrusive_list<T, Hook>::push_front(T& value)
+    \brief Links value at the front of the list. value must not be linked.
+    */
+    /**********************************************************************/
+    void push_front(T& value);
+
+    /**********************************************************************/
+    /*!
+    \fn void intrusive_list<T, Hook>::pop_front()
+    \brief Unlinks the first element
+    */
+    /**********************************************************************/
+    void pop_front();
+
+    /**********************************************************************/
+    /*!
+    \fn void intrusive_list<T, Hook>::pop_back()
+    \brief Unlinks the last element
+    */
+    /**********************************************************************/
+    void pop_back();
+
+    /**********************************************************************/
+    /*!
+    \fn iterator intrusive_list<T, Hook>::insert(iterator pos, T& value)
+    \brief Links value before pos. value must not be linked.
+    \return Iterator to value
+    */
+    /**********************************************************************/
+    iterator insert(iterator pos, T& value);
+
+    /**********************************************************************/
+    /*!
+    \fn iterator intrusive_list<T, Hook>::erase(iterator pos)
+    \brief Unlinks the element at pos
+    \return Iterator to the element after the unlinked one
+    */
+    /**********************************************************************/
+    iterator erase(iterator pos);
+
+    /**********************************************************************/
+    /*!
+    \fn void intrusive_list<T, Hook>::splice(iterator pos, intrusive_list& other)
+    \brief Moves every element of other before pos in O(1)
+    */
+    /**********************************************************************/
+    void splice(iterator pos, intrusive_list& other);
+
+    /**********************************************************************/
+    /*!
+    \fn iterator intrusive_list<T, Hook>::iterator_to(T& value)
+    \brief Returns an iterator to an element that is in this list, in O(1)
+    */
+    /**********************************************************************/
+    iterator iterator_to(T& value);
+
+    /**********************************************************************/
+    /*!
+    \fn void intrusive_list<T, Hook>::clear()
+    \brief Unlinks every element
+    */
+    /**********************************************************************/
+    void clear();
+
+    /**********************************************************************/
+    /*!
+    \fn bool intrusive_list<T, Hook>::empty() const
+    \brief Check if list is empty
+    */
+    /**********************************************************************/
+    bool empty() const;
+
+    /**********************************************************************/
+    /*!
+    \fn size_type intrusive_list<T, Hook>::size() const
+    \brief Counts the elements. O(n), since elements may unlink themselves.
+    */
+    /**********************************************************************/
+    size_type size() const;
+
+    iterator begin();
+
+    iterator end();
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    const_iterator cbegin() const;
+
+    const_iterator cend() const;
+
+  private:
+    /**********************************************************************/
+    /*!
+    \fn T* intrusive_list<T, Hook>::to_value(intrusive_list_hook* hook)
+    \brief Gets the element that embeds the given hook
+    */
+    /**********************************************************************/
+    static T* to_value(intrusive_list_hook* hook);
+
+    static const T* to_value(const intrusive_list_hook* hook);
+
+    /**********************************************************************/
+    /*!
+    \fn intrusive_list_hook* intrusive_list<T, Hook>::to_hook(T& value)
+    \brief Gets the hook of value and records value as its owner
+    */
+    /**********************************************************************/
+    static intrusive_list_hook* to_hook(T& value);
+  };
+}
+
+#include "intrusive_list.tpp"
+
+#endif
@@ -0,0 +1,553 @@
+#include "intrusive_list.h"
+
+namespace CustomSTL
+{
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list_hook::intrusive_list_hook()
+  \brief Creates an unlinked hook
+  */
+  /***********************************************************************/
+  inline intrusive_list_hook::intrusive_list_hook() :
+    _prev{nullptr},
+    _next{nullptr},
+    _owner{nullptr}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list_hook::intrusive_list_hook(const intrusive_list_hook&)
+  \brief The copy of an element starts out unlinked
+  */
+  /***********************************************************************/
+  inline intrusive_list_hook::intrusive_list_hook(const intrusive_list_hook&) :
+    intrusive_list_hook{}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list_hook& intrusive_list_hook::operator=(const intrusive_list_hook&)
+  \brief Assigning an element keeps its own links
+  */
+  /***********************************************************************/
+  inline intrusive_list_hook& intrusive_list_hook::operator=(const intrusive_list_hook&)
+  {
+    return *this;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list_hook::~intrusive_list_hook()
+  \brief Unlinks the element so the list never points at a dead object
+  */
+  /***********************************************************************/
+  inline intrusive_list_hook::~intrusive_list_hook()
+  {
+    unlink();
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn bool intrusive_list_hook::is_linked() const
+  \brief Checks if the element is currently in a list
+  */
+  /***********************************************************************/
+  inline bool intrusive_list_hook::is_linked() const
+  {
+    return _next != nullptr;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void intrusive_list_hook::unlink()
+  \brief Removes the element from whichever list it is in. Does nothing
+         if it is not linked.
+  */
+  /***********************************************************************/
+  inline void intrusive_list_hook::unlink()
+  {
+    if (!is_linked())
+    {
+      return;
+    }
+    _prev->_next = _next;
+    _next->_prev = _prev;
+    _prev = nullptr;
+    _next = nullptr;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void intrusive_list_hook::link_before(intrusive_list_hook* pos)
+  \brief Links this hook in front of pos
+  */
+  /***********************************************************************/
+  inline void intrusive_list_hook::link_before(intrusive_list_hook* pos)
+  {
+    _prev = pos->_prev;
+    _next = pos;
+    pos->_prev->_next = this;
+    pos->_prev = this;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list<T, Hook>::intrusive_list()
+  \brief Default constructor for intrusive_list
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  intrusive_list<T, Hook>::intrusive_list()
+  {
+    _sentinel._prev = &_sentinel;
+    _sentinel._next = &_sentinel;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list<T, Hook>::~intrusive_list()
+  \brief Unlinks every element. The elements themselves are untouched.
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  intrusive_list<T, Hook>::~intrusive_list()
+  {
+    clear();
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn reference intrusive_list<T, Hook>::front()
+  \brief Returns a reference to the first element
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::reference intrusive_list<T, Hook>::front()
+  {
+    return *to_value(_sentinel._next);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn const_reference intrusive_list<T, Hook>::front() const
+  \brief Returns a const reference to the first element
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_reference intrusive_list<T, Hook>::front() const
+  {
+    return *to_value(static_cast<const intrusive_list_hook*>(_sentinel._next));
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn reference intrusive_list<T, Hook>::back()
+  \brief Returns a reference to the last element
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::reference intrusive_list<T, Hook>::back()
+  {
+    return *to_value(_sentinel._prev);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn const_reference intrusive_list<T, Hook>::back() const
+  \brief Returns a const reference to the last element
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_reference intrusive_list<T, Hook>::back() const
+  {
+    return *to_value(static_cast<const intrusive_list_hook*>(_sentinel._prev));
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void intrusive_list<T, Hook>::push_back(T& value)
+  \brief Links value at the back of the list. value must not be linked.
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::push_back(T& value)
+  {
+    to_hook(value)->link_before(&_sentinel);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void intrusive_list<T, Hook>::push_front(T& value)
+  \brief Links value at the front of the list. value must not be linked.
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::push_front(T& value)
+  {
+    to_hook(value)->link_before(_sentinel._next);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void intrusive_list<T, Hook>::pop_front()
+  \brief Unlinks the first element
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::pop_front()
+  {
+    _sentinel._next->unlink();
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void intrusive_list<T, Hook>::pop_back()
+  \brief Unlinks the last element
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::pop_back()
+  {
+    _sentinel._prev->unlink();
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn iterator intrusive_list<T, Hook>::insert(iterator pos, T& value)
+  \brief Links value before pos. value must not be linked.
+  \return Iterator to value
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator
+           intrusive_list<T, Hook>::insert(iterator pos, T& value)
+  {
+    intrusive_list_hook* hook = to_hook(value);
+    hook->link_before(pos._curr);
+    return hook;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn iterator intrusive_list<T, Hook>::erase(iterator pos)
+  \brief Unlinks the element at pos
+  \return Iterator to the element after the unlinked one
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator
+           intrusive_list<T, Hook>::erase(iterator pos)
+  {
+    intrusive_list_hook* next = pos._curr->_next;
+    pos._curr->unlink();
+    return next;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void intrusive_list<T, Hook>::splice(iterator pos, intrusive_list& other)
+  \brief Moves every element of other before pos in O(1)
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::splice(iterator pos, intrusive_list& other)
+  {
+    if (this == &other || other.empty())
+    {
+      return;
+    }
+    intrusive_list_hook* first = other._sentinel._next;
+    intrusive_list_hook* last = other._sentinel._prev;
+    other._sentinel._prev = &other._sentinel;
+    other._sentinel._next = &other._sentinel;
+
+    intrusive_list_hook* prev = pos._curr->_prev;
+    prev->_next = first;
+    first->_prev = prev;
+    last->_next = pos._curr;
+    pos._curr->_prev = last;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn iterator intrusive_list<T, Hook>::iterator_to(T& value)
+  \brief Returns an iterator to an element that is in this list, in O(1)
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator
+           intrusive_list<T, Hook>::iterator_to(T& value)
+  {
+    return to_hook(value);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void intrusive_list<T, Hook>::clear()
+  \brief Unlinks every element
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::clear()
+  {
+    while (!empty())
+    {
+      pop_front();
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn bool intrusive_list<T, Hook>::empty() const
+  \brief Check if list is empty
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  bool intrusive_list<T, Hook>::empty() const
+  {
+    return _sentinel._next == &_sentinel;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn size_type intrusive_list<T, Hook>::size() const
+  \brief Counts the elements. O(n), since elements may unlink themselves.
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::size_type intrusive_list<T, Hook>::size() const
+  {
+    size_type count = 0;
+    for (const intrusive_list_hook* hook = _sentinel._next; hook != &_sentinel; hook = hook->_next)
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::begin()
+  {
+    return _sentinel._next;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::end()
+  {
+    return &_sentinel;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator intrusive_list<T, Hook>::begin() const
+  {
+    return _sentinel._next;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator intrusive_list<T, Hook>::end() const
+  {
+    return &_sentinel;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator intrusive_list<T, Hook>::cbegin() const
+  {
+    return begin();
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator intrusive_list<T, Hook>::cend() const
+  {
+    return end();
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn T* intrusive_list<T, Hook>::to_value(intrusive_list_hook* hook)
+  \brief Gets the element that embeds the given hook
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  T* intrusive_list<T, Hook>::to_value(intrusive_list_hook* hook)
+  {
+    return static_cast<T*>(hook->_owner);
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  const T* intrusive_list<T, Hook>::to_value(const intrusive_list_hook* hook)
+  {
+    return static_cast<const T*>(hook->_owner);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list_hook* intrusive_list<T, Hook>::to_hook(T& value)
+  \brief Gets the hook of value and records value as its owner
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  intrusive_list_hook* intrusive_list<T, Hook>::to_hook(T& value)
+  {
+    intrusive_list_hook* hook = &(value.*Hook);
+    hook->_owner = &value;
+    return hook;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  bool intrusive_list<T, Hook>::iterator_impl::operator!=(const iterator_impl& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  bool intrusive_list<T, Hook>::iterator_impl::operator==(const iterator_impl& rhs) const
+  {
+    return (_curr == rhs._curr);
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator_impl&
+           intrusive_list<T, Hook>::iterator_impl::operator++()
+  {
+    _curr = _curr->_next;
+    return *this;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator_impl&
+           intrusive_list<T, Hook>::iterator_impl::operator--()
+  {
+    _curr = _curr->_prev;
+    return *this;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator_impl
+           intrusive_list<T, Hook>::iterator_impl::operator++(int)
+  {
+    iterator_impl temp = *this;
+    ++(*this);
+    return temp;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator_impl
+           intrusive_list<T, Hook>::iterator_impl::operator--(int)
+  {
+    iterator_impl temp = *this;
+    --(*this);
+    return temp;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator_impl::reference
+           intrusive_list<T, Hook>::iterator_impl::operator*() const
+  {
+    return *to_value(_curr);
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator_impl::pointer
+           intrusive_list<T, Hook>::iterator_impl::operator->() const
+  {
+    return to_value(_curr);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list<T, Hook>::iterator_impl::iterator_impl(intrusive_list_hook* curr)
+  \brief Conversion constructor for iterator_impl
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  intrusive_list<T, Hook>::iterator_impl::iterator_impl(intrusive_list_hook* curr) :
+    _curr{curr}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list<T, Hook>::iterator_impl::operator const_iterator_impl() const
+  \brief Converts an iterator to a const_iterator at the same element
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  intrusive_list<T, Hook>::iterator_impl::operator const_iterator_impl() const
+  {
+    return const_iterator_impl(_curr);
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  bool intrusive_list<T, Hook>::const_iterator_impl::operator!=(const const_iterator_impl& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  bool intrusive_list<T, Hook>::const_iterator_impl::operator==(const const_iterator_impl& rhs) const
+  {
+    return (_curr == rhs._curr);
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator_impl&
+           intrusive_list<T, Hook>::const_iterator_impl::operator++()
+  {
+    _curr = _curr->_next;
+    return *this;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator_impl&
+           intrusive_list<T, Hook>::const_iterator_impl::operator--()
+  {
+    _curr = _curr->_prev;
+    return *this;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator_impl
+           intrusive_list<T, Hook>::const_iterator_impl::operator++(int)
+  {
+    const_iterator_impl temp = *this;
+    ++(*this);
+    return temp;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator_impl
+           intrusive_list<T, Hook>::const_iterator_impl::operator--(int)
+  {
+    const_iterator_impl temp = *this;
+    --(*this);
+    return temp;
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator_impl::reference
+           intrusive_list<T, Hook>::const_iterator_impl::operator*() const
+  {
+    return *to_value(_curr);
+  }
+
+  template <typename T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::const_iterator_impl::pointer
+           intrusive_list<T, Hook>::const_iterator_impl::operator->() const
+  {
+    return to_value(_curr);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn intrusive_list<T, Hook>::const_iterator_impl::const_iterator_impl(const intrusive_list_hook* curr)
+  \brief Conversion constructor for const_iterator_impl
+  */
+  /***********************************************************************/
+  template <typename T, intrusive_list_hook T::*Hook>
+  intrusive_list<T, Hook>::const_iterator_impl::const_iterator_impl(const intrusive_list_hook* curr) :
+    _curr{curr}
+  {
+  }
+}
@@ -3,6 +3,7 @@
 
 #include <initializer_list>
 #include <iterator>
+#include <utility>
 
 namespace CustomSTL
 {
@@ -21,6 +22,14 @@ namespace CustomSTL
         _value(value)
       {
       }
+
+      template <typename... Args>
+      node(std::in_place_t, Args&&... args) :
+        _prev(nullptr),
+        _next(nullptr),
+        _value(std::forward<Args>(args)...)
+      {
+      }
     };
 
     node* _first;
@@ -28,10 +37,14 @@ namespace CustomSTL
 
   public:
 
+    class const_iterator_impl;
+
     class iterator_impl
     {
       node* _curr;
       node* _last;
+
+      friend class list;
     public:
       using iterator_category = std::bidirectional_iterator_tag;
       using value_type = T;
@@ -54,12 +67,24 @@ namespace CustomSTL
       reference operator*() const;
 
       iterator_impl(node* last, node* curr = nullptr);
+
+      /**********************************************************************/
+      /*!
+      \fn list<T>::iterator_impl::operator const_iterator_impl() const
+      
+      \brief Allows an iterator to be passed where a const_iterator is 
+             expected
+      */ 
+      /**********************************************************************/
+      operator const_iterator_impl() const;
     };
 
     class const_iterator_impl
     {
       const node* _curr;
       const node* _last;
+
+      friend class list;
     public:
       using iterator_category = std::bidirectional_iterator_tag;
       using value_type = typename iterator_impl::value_type;
@@ -228,7 +253,9 @@ namespace CustomSTL
     /**********************************************************************/
     /*!
     \fn list<T>& list<T>::operator=(const list& rhs)
-    \brief Copy assignment operator overload. Used to copy one list to another
+    \brief Copy assignment operator overload. Used to copy one list to another.
+           Existing nodes are overwritten first, nodes are only allocated 
+           or freed for the difference in length.
     \param rhs 
               Reference of the list being copied to this list
     \returns Reference to the newly copied list
@@ -253,6 +280,24 @@ namespace CustomSTL
     */ 
     /**********************************************************************/  
     const_reference front() const;
+
+    /**********************************************************************/
+    /*!
+    \fn typename list<T>::reference list<T>::back()
+    \brief   Returns a reference to the last value
+    \returns dereferenced to the list
+    */ 
+    /**********************************************************************/ 
+    reference back();
+    
+    /**********************************************************************/
+    /*!
+    \fn typename list<T>::const_reference list<T>::back() const
+    \brief   Returns a reference to the last value
+    \returns dereferenced to the list
+    */ 
+    /**********************************************************************/  
+    const_reference back() const;
     
     /**********************************************************************/
     /*!
@@ -272,6 +317,122 @@ namespace CustomSTL
     /***********************************************************************/  
     void pop_front();
 
+    /**********************************************************************/
+    /*!
+    \fn void list<T>::push_front(const value_type& value)
+    \brief  Adds an element at the front of the list.
+    \param  value 
+            value of the element to be added
+    */ 
+    /**********************************************************************/  
+    void push_front(const value_type& value);
+
+    /**********************************************************************/
+    /*!
+    \fn void list<T>::pop_back()
+    \brief  Removes an element at the back of the list.
+    */ 
+    /***********************************************************************/  
+    void pop_back();
+
+    /**********************************************************************/
+    /*!
+    \fn typename list<T>::iterator 
+                 list<T>::insert(const_iterator pos, const value_type& value)
+    \brief  Inserts a copy of value before pos.
+    \param  pos 
+            Iterator before which the element is inserted
+    \param  value 
+            value of the element to be added
+    \return Iterator to the inserted element
+    */ 
+    /**********************************************************************/  
+    iterator insert(const_iterator pos, const value_type& value);
+
+    /**********************************************************************/
+    /*!
+    \fn typename list<T>::iterator 
+                 list<T>::emplace(const_iterator pos, Args&&... args)
+    \brief  Constructs an element in place before pos.
+    \param  pos 
+            Iterator before which the element is constructed
+    \param  args 
+            Arguments forwarded to the constructor of the element
+    \return Iterator to the new element
+    */ 
+    /**********************************************************************/  
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args);
+
+    /**********************************************************************/
+    /*!
+    \fn typename list<T>::reference list<T>::emplace_back(Args&&... args)
+    \brief  Constructs an element in place at the back of the list.
+    \param  args 
+            Arguments forwarded to the constructor of the element
+    \return Reference to the new element
+    */ 
+    /**********************************************************************/  
+    template <typename... Args>
+    reference emplace_back(Args&&... args);
+
+    /**********************************************************************/
+    /*!
+    \fn typename list<T>::iterator list<T>::erase(const_iterator pos)
+    \brief  Removes the element at pos. Other iterators stay valid.
+    \param  pos 
+            Iterator to the element to remove
+    \return Iterator to the element after the removed one
+    */ 
+    /**********************************************************************/  
+    iterator erase(const_iterator pos);
+
+    /**********************************************************************/
+    /*!
+    \fn void list<T>::splice(const_iterator pos, list& other)
+    \brief  Moves every node of other before pos. No element is copied 
+            and no node is allocated, only the links are changed.
+    \param  pos 
+            Iterator before which the nodes are inserted
+    \param  other 
+            List to take the nodes from, left empty
+    */ 
+    /**********************************************************************/  
+    void splice(const_iterator pos, list& other);
+
+    /**********************************************************************/
+    /*!
+    \fn void list<T>::splice(const_iterator pos, list& other, const_iterator it)
+    \brief  Moves the node at it from other before pos.
+    \param  pos 
+            Iterator before which the node is inserted
+    \param  other 
+            List to take the node from, may be *this
+    \param  it 
+            Iterator to the node to move
+    */ 
+    /**********************************************************************/  
+    void splice(const_iterator pos, list& other, const_iterator it);
+
+    /**********************************************************************/
+    /*!
+    \fn void list<T>::splice(const_iterator pos, list& other, 
+                             const_iterator first, const_iterator last)
+    \brief  Moves the nodes in [first, last) from other before pos.
+            pos must not be inside [first, last).
+    \param  pos 
+            Iterator before which the nodes are inserted
+    \param  other 
+            List to take the nodes from, may be *this
+    \param  first 
+            Iterator to the first node to move
+    \param  last 
+            Iterator past the last node to move
+    */ 
+    /**********************************************************************/  
+    void splice(const_iterator pos, list& other, 
+                const_iterator first, const_iterator last);
+
     /**********************************************************************/
     /*!
     \fn bool list<T>::empty() const
@@ -358,6 +519,26 @@ namespace CustomSTL
     */ 
     /***********************************************************************/  
     iterator end();
+
+  private:
+    /***********************************************************************/
+    /*!
+    \fn void list<T>::link_before(node* pos, node* first, node* last)
+    
+    \brief Links the chain [first, last] in front of pos, nullptr pos 
+           appends to the back
+    */ 
+    /***********************************************************************/  
+    void link_before(node* pos, node* first, node* last);
+
+    /***********************************************************************/
+    /*!
+    \fn void list<T>::unlink(node* first, node* last)
+    
+    \brief Detaches the chain [first, last] without freeing it
+    */ 
+    /***********************************************************************/  
+    void unlink(node* first, node* last);
   };
 }
 
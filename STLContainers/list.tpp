@@ -74,7 +74,9 @@ namespace CustomSTL
   /***********************************************************************/
   /*!
   \fn list<T>& list<T>::operator=(const list& rhs)
-  \brief Copy assignment operator overload. Used to copy one list to another
+  \brief Copy assignment operator overload. Used to copy one list to another.
+         Existing nodes are overwritten first, nodes are only allocated 
+         or freed for the difference in length.
   \param rhs 
             Reference of the list being copied to this list
   \returns Reference to the newly copied list
@@ -85,15 +87,30 @@ namespace CustomSTL
   {
     if (this != &rhs)
     {
-      while (!empty())
+      node* current = _first;
+      const node* source = rhs._first;
+      while (current && source)
       {
-        pop_front();
+        current->_value = source->_value;
+        current = current->_next;
+        source = source->_next;
       }
-      const_iterator current = rhs.begin();
-      const const_iterator end = rhs.end();
-      while (current != end)
+
+      while (source)
       {
-        push_back(*current++);
+        push_back(source->_value);
+        source = source->_next;
+      }
+
+      if (current)
+      {
+        unlink(current, _last);
+        while (current)
+        {
+          node* temp = current;
+          current = current->_next;
+          delete temp;
+        }
       }
     }
     return *this;
@@ -125,6 +142,32 @@ namespace CustomSTL
     return _first->_value;
   }
 
+  /***********************************************************************/
+  /*!
+ \fn typename list<T>::reference list<T>::back()
+ \brief   Returns a reference to the last value
+ \returns dereferenced to the list
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  typename list<T>::reference list<T>::back()
+  {
+    return _last->_value;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename list<T>::const_reference list<T>::back() const
+  \brief   Returns a reference to the last value
+  \returns dereferenced to the list
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  typename list<T>::const_reference list<T>::back() const
+  {
+    return _last->_value;
+  }
+
   /***********************************************************************/
   /*!
   \fn void list<T>::push_back(const value_type& value)
@@ -170,6 +213,258 @@ namespace CustomSTL
     }
   }
 
+  /***********************************************************************/
+  /*!
+  \fn void list<T>::push_front(const value_type& value)
+  \brief  Adds an element at the front of the list.
+  \param  value 
+          value of the element to be added
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  void list<T>::push_front(const value_type& value)
+  {
+    list<T>::node* node = new list<T>::node(value);
+    link_before(_first, node, node);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void list<T>::pop_back()
+  \brief  Removes an element at the back of the list.
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  void list<T>::pop_back()
+  {
+    list<T>::node* temp = _last;
+    unlink(temp, temp);
+    delete temp;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename list<T>::iterator 
+               list<T>::insert(const_iterator pos, const value_type& value)
+  \brief  Inserts a copy of value before pos.
+  \param  pos 
+          Iterator before which the element is inserted
+  \param  value 
+          value of the element to be added
+  \return Iterator to the inserted element
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  typename list<T>::iterator 
+           list<T>::insert(const_iterator pos, const value_type& value)
+  {
+    list<T>::node* node = new list<T>::node(value);
+    link_before(const_cast<list<T>::node*>(pos._curr), node, node);
+    return {_last, node};
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename list<T>::iterator 
+               list<T>::emplace(const_iterator pos, Args&&... args)
+  \brief  Constructs an element in place before pos.
+  \param  pos 
+          Iterator before which the element is constructed
+  \param  args 
+          Arguments forwarded to the constructor of the element
+  \return Iterator to the new element
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  template <typename... Args>
+  typename list<T>::iterator 
+           list<T>::emplace(const_iterator pos, Args&&... args)
+  {
+    list<T>::node* node = 
+      new list<T>::node(std::in_place, std::forward<Args>(args)...);
+    link_before(const_cast<list<T>::node*>(pos._curr), node, node);
+    return {_last, node};
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename list<T>::reference list<T>::emplace_back(Args&&... args)
+  \brief  Constructs an element in place at the back of the list.
+  \param  args 
+          Arguments forwarded to the constructor of the element
+  \return Reference to the new element
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  template <typename... Args>
+  typename list<T>::reference list<T>::emplace_back(Args&&... args)
+  {
+    list<T>::node* node = 
+      new list<T>::node(std::in_place, std::forward<Args>(args)...);
+    link_before(nullptr, node, node);
+    return node->_value;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename list<T>::iterator list<T>::erase(const_iterator pos)
+  \brief  Removes the element at pos. Other iterators stay valid.
+  \param  pos 
+          Iterator to the element to remove
+  \return Iterator to the element after the removed one
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  typename list<T>::iterator list<T>::erase(const_iterator pos)
+  {
+    list<T>::node* temp = const_cast<list<T>::node*>(pos._curr);
+    list<T>::node* next = temp->_next;
+    unlink(temp, temp);
+    delete temp;
+    return {_last, next};
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void list<T>::splice(const_iterator pos, list& other)
+  \brief  Moves every node of other before pos. No element is copied 
+          and no node is allocated, only the links are changed.
+  \param  pos 
+          Iterator before which the nodes are inserted
+  \param  other 
+          List to take the nodes from, left empty
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  void list<T>::splice(const_iterator pos, list& other)
+  {
+    if (this == &other || other.empty())
+    {
+      return;
+    }
+    list<T>::node* first = other._first;
+    list<T>::node* last = other._last;
+    other.unlink(first, last);
+    link_before(const_cast<list<T>::node*>(pos._curr), first, last);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void list<T>::splice(const_iterator pos, list& other, const_iterator it)
+  \brief  Moves the node at it from other before pos.
+  \param  pos 
+          Iterator before which the node is inserted
+  \param  other 
+          List to take the node from, may be *this
+  \param  it 
+          Iterator to the node to move
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  void list<T>::splice(const_iterator pos, list& other, const_iterator it)
+  {
+    list<T>::node* node = const_cast<list<T>::node*>(it._curr);
+    if (this == &other && (node == pos._curr || node->_next == pos._curr))
+    {
+      return;
+    }
+    other.unlink(node, node);
+    link_before(const_cast<list<T>::node*>(pos._curr), node, node);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void list<T>::splice(const_iterator pos, list& other, 
+                           const_iterator first, const_iterator last)
+  \brief  Moves the nodes in [first, last) from other before pos.
+          pos must not be inside [first, last).
+  \param  pos 
+          Iterator before which the nodes are inserted
+  \param  other 
+          List to take the nodes from, may be *this
+  \param  first 
+          Iterator to the first node to move
+  \param  last 
+          Iterator past the last node to move
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  void list<T>::splice(const_iterator pos, list& other, 
+                       const_iterator first, const_iterator last)
+  {
+    if (first == last || (this == &other && last._curr == pos._curr))
+    {
+      return;
+    }
+    list<T>::node* head = const_cast<list<T>::node*>(first._curr);
+    list<T>::node* tail = last._curr ? 
+      const_cast<list<T>::node*>(last._curr->_prev) : other._last;
+    other.unlink(head, tail);
+    link_before(const_cast<list<T>::node*>(pos._curr), head, tail);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void list<T>::link_before(node* pos, node* first, node* last)
+  
+  \brief Links the chain [first, last] in front of pos, nullptr pos 
+         appends to the back
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  void list<T>::link_before(node* pos, node* first, node* last)
+  {
+    list<T>::node* prev = pos ? pos->_prev : _last;
+    first->_prev = prev;
+    last->_next = pos;
+    if (prev)
+    {
+      prev->_next = first;
+    }
+    else
+    {
+      _first = first;
+    }
+    if (pos)
+    {
+      pos->_prev = last;
+    }
+    else
+    {
+      _last = last;
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void list<T>::unlink(node* first, node* last)
+  
+  \brief Detaches the chain [first, last] without freeing it
+  */ 
+  /***********************************************************************/  
+  template <typename T>
+  void list<T>::unlink(node* first, node* last)
+  {
+    if (first->_prev)
+    {
+      first->_prev->_next = last->_next;
+    }
+    else
+    {
+      _first = last->_next;
+    }
+    if (last->_next)
+    {
+      last->_next->_prev = first->_prev;
+    }
+    else
+    {
+      _last = first->_prev;
+    }
+    first->_prev = nullptr;
+    last->_next = nullptr;
+  }
+
   /***********************************************************************/
   /*!
   \fn bool list<T>::empty() const
@@ -277,7 +572,7 @@ namespace CustomSTL
   template<typename T>
   typename list<T>::iterator_impl list<T>::iterator_impl::operator++(int)
   {
-    const_iterator_impl temp = *this;
+    iterator_impl temp = *this;
     ++(*this);
     return temp;
   }
@@ -296,7 +591,7 @@ namespace CustomSTL
   template<typename T>
   typename list<T>::iterator_impl list<T>::iterator_impl::operator--(int)
   {
-    const_iterator_impl temp = *this;
+    iterator_impl temp = *this;
     --(*this);
     return temp;
   }
@@ -332,6 +627,20 @@ namespace CustomSTL
     _curr{curr},
     _last{last}  
   {}
+
+  /***********************************************************************/
+  /*!
+  \fn list<T>::iterator_impl::operator const_iterator_impl() const
+  
+  \brief Allows an iterator to be passed where a const_iterator is 
+         expected
+  */ 
+  /***********************************************************************/
+  template<typename T>
+  list<T>::iterator_impl::operator const_iterator_impl() const
+  {
+    return {_last, _curr};
+  }
   
   /***********************************************************************/
   /*!
@@ -414,7 +723,8 @@ namespace CustomSTL
     }
     else
     {
-      return _last;
+      _curr = _last;
+      return *this;
     }
   }
 
@@ -456,7 +766,7 @@ namespace CustomSTL
            list<T>::const_iterator_impl::operator--(int)
   {
     const_iterator_impl temp = *this;
-    ++(*this);
+    --(*this);
     return temp;
   }
 
@@ -0,0 +1,273 @@
+/***************************************************************************/
+/*!
+\brief  A generational slot map. insert hands out a 64-bit key made of a
+        slot index and the slot's generation, lookups and erases through a
+        key are O(1) and a key stops resolving once its element is erased,
+        even after the slot has been reused.
+        Values are kept densely packed in one contiguous array so a full
+        scan is a plain array walk. erase moves the last value into the
+        erased one's place, so iteration order is not insertion order and
+        erasing invalidates pointers to the moved value, keys stay valid.
+        Freed slots are reused through a free list, a slot whose generation
+        would wrap is retired instead so an old key can never alias a new
+        element.
+*/
+/***************************************************************************/
+#ifndef _SLOT_MAP_H_
+#define _SLOT_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace CustomSTL
+{
+  /*************************************************************************/
+  /*!
+  \brief  Handle to an element of a slot_map. The low 32 bits are the slot
+          index and the high 32 bits its generation. A default constructed
+          key is null and never resolves.
+  */
+  /*************************************************************************/
+  class slot_map_key
+  {
+    uint64_t _value;
+
+  public:
+    constexpr slot_map_key() : _value{0} {}
+
+    constexpr slot_map_key(uint32_t index, uint32_t generation) :
+      _value{(uint64_t{generation} << 32) | index}
+    {
+    }
+
+    // Rebuilds a key from raw(), e.g. after passing it through a C API
+    static constexpr slot_map_key from_raw(uint64_t value)
+    {
+      slot_map_key key;
+      key._value = value;
+      return key;
+    }
+
+    constexpr uint64_t raw() const { return _value; }
+    constexpr uint32_t index() const { return static_cast<uint32_t>(_value); }
+    constexpr uint32_t generation() const { return static_cast<uint32_t>(_value >> 32); }
+
+    // Generations of live elements are odd, so the null key is never live
+    constexpr explicit operator bool() const { return _value != 0; }
+
+    friend constexpr bool operator==(slot_map_key lhs, slot_map_key rhs)
+    {
+      return lhs._value == rhs._value;
+    }
+
+    friend constexpr bool operator!=(slot_map_key lhs, slot_map_key rhs)
+    {
+      return lhs._value != rhs._value;
+    }
+  };
+
+  template <typename T>
+  class slot_map
+  {
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    struct slot
+    {
+      uint32_t _generation; //!< Odd while the slot holds a value
+      uint32_t _link;       //!< Dense position if occupied, next free slot otherwise
+    };
+
+    std::vector<T> _values;
+    std::vector<uint32_t> _owners; //!< Slot index of each dense value
+    std::vector<slot> _slots;
+    uint32_t _free_head;
+    uint32_t _free_tail;
+
+  public:
+    using key_type = slot_map_key;
+    using size_type = size_t;
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /**********************************************************************/
+    /*!
+    \fn slot_map<T>::slot_map()
+    \brief Default constructor for slot_map
+    */
+    /**********************************************************************/
+    slot_map();
+
+    /**********************************************************************/
+    /*!
+    \fn key_type slot_map<T>::insert(const value_type& value)
+    \brief  Adds a value, reusing the oldest free slot if there is one
+    \return Key of the new element
+    */
+    /**********************************************************************/
+    key_type insert(const value_type& value);
+    key_type insert(value_type&& value);
+
+    /**********************************************************************/
+    /*!
+    \fn key_type slot_map<T>::emplace(Args&&... args)
+    \brief  Constructs a value in place at the end of the dense array
+    \return Key of the new element
+    */
+    /**********************************************************************/
+    template <typename... Args>
+    key_type emplace(Args&&... args);
+
+    /**********************************************************************/
+    /*!
+    \fn bool slot_map<T>::erase(key_type key)
+    \brief  Removes the element the key refers to. The last value is moved
+            into its place in the dense array.
+    \return false if the key was stale or null
+    */
+    /**********************************************************************/
+    bool erase(key_type key);
+
+    /**********************************************************************/
+    /*!
+    \fn iterator slot_map<T>::erase(const_iterator pos)
+    \brief  Removes the element at pos, for erasing while scanning
+    \return Iterator to the value moved into pos, or end()
+    */
+    /**********************************************************************/
+    iterator erase(const_iterator pos);
+
+    /**********************************************************************/
+    /*!
+    \fn pointer slot_map<T>::find(key_type key)
+    \brief  Looks up a key
+    \return Pointer to the element, nullptr if the key is stale or null.
+            Valid until the next insert or erase.
+    */
+    /**********************************************************************/
+    pointer find(key_type key);
+    const_pointer find(key_type key) const;
+
+    /**********************************************************************/
+    /*!
+    \fn bool slot_map<T>::contains(key_type key) const
+    \brief Check if the key still refers to an element
+    */
+    /**********************************************************************/
+    bool contains(key_type key) const;
+
+    /**********************************************************************/
+    /*!
+    \fn reference slot_map<T>::at(key_type key)
+    \brief  Looks up a key, throws std::out_of_range if it is stale or null
+    */
+    /**********************************************************************/
+    reference at(key_type key);
+    const_reference at(key_type key) const;
+
+    /**********************************************************************/
+    /*!
+    \fn reference slot_map<T>::operator[](key_type key)
+    \brief  Looks up a key that is known to be live, without checking
+    */
+    /**********************************************************************/
+    reference operator[](key_type key);
+    const_reference operator[](key_type key) const;
+
+    /**********************************************************************/
+    /*!
+    \fn key_type slot_map<T>::key_of(const_iterator pos) const
+    \brief  Returns the key of the element at pos, for scans that need to
+            hand out keys
+    */
+    /**********************************************************************/
+    key_type key_of(const_iterator pos) const;
+
+    /**********************************************************************/
+    /*!
+    \fn void slot_map<T>::clear()
+    \brief  Removes every element. Every outstanding key becomes stale.
+    */
+    /**********************************************************************/
+    void clear();
+
+    /**********************************************************************/
+    /*!
+    \fn void slot_map<T>::reserve(size_type count)
+    \brief  Reserves room for count elements so inserts up to it do not
+            reallocate
+    */
+    /**********************************************************************/
+    void reserve(size_type count);
+
+    bool empty() const;
+    size_type size() const;
+    size_type capacity() const;
+
+    // The dense values, in no particular order
+    pointer data();
+    const_pointer data() const;
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    iterator begin();
+    iterator end();
+
+  private:
+    /**********************************************************************/
+    /*!
+    \fn key_type slot_map<T>::AcquireSlot()
+    \brief  Pops the free list or appends a new slot, and points the slot
+            at the value just appended to the dense array
+    */
+    /**********************************************************************/
+    key_type AcquireSlot();
+
+    /**********************************************************************/
+    /*!
+    \fn void slot_map<T>::RemoveAt(uint32_t position)
+    \brief  Removes the dense value at position and frees its slot
+    */
+    /**********************************************************************/
+    void RemoveAt(uint32_t position);
+
+    /**********************************************************************/
+    /*!
+    \fn void slot_map<T>::ReleaseSlot(uint32_t index)
+    \brief  Bumps the slot's generation and appends it to the free list,
+            or retires it if the generation would wrap
+    */
+    /**********************************************************************/
+    void ReleaseSlot(uint32_t index);
+
+    /**********************************************************************/
+    /*!
+    \fn uint32_t slot_map<T>::Resolve(key_type key) const
+    \brief  Returns the dense position of a live key, NO_SLOT otherwise
+    */
+    /**********************************************************************/
+    uint32_t Resolve(key_type key) const;
+  };
+}
+
+template <>
+struct std::hash<CustomSTL::slot_map_key>
+{
+  size_t operator()(CustomSTL::slot_map_key key) const noexcept
+  {
+    return std::hash<uint64_t>{}(key.raw());
+  }
+};
+
+#include "slot_map.tpp"
+
+#endif
@@ -0,0 +1,409 @@
+#include "slot_map.h"
+
+#include <stdexcept>
+
+namespace CustomSTL
+{
+  /***********************************************************************/
+  /*!
+  \fn slot_map<T>::slot_map()
+  \brief Default constructor for slot_map
+  */
+  /***********************************************************************/
+  template <typename T>
+  slot_map<T>::slot_map() :
+    _free_head{NO_SLOT},
+    _free_tail{NO_SLOT}
+  {
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename slot_map<T>::key_type slot_map<T>::insert(const value_type& value)
+  \brief  Adds a value, reusing the oldest free slot if there is one
+  \return Key of the new element
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename slot_map<T>::key_type slot_map<T>::insert(const value_type& value)
+  {
+    return emplace(value);
+  }
+
+  template <typename T>
+  typename slot_map<T>::key_type slot_map<T>::insert(value_type&& value)
+  {
+    return emplace(std::move(value));
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename slot_map<T>::key_type slot_map<T>::emplace(Args&&... args)
+  \brief  Constructs a value in place at the end of the dense array
+  \return Key of the new element
+  */
+  /***********************************************************************/
+  template <typename T>
+  template <typename... Args>
+  typename slot_map<T>::key_type slot_map<T>::emplace(Args&&... args)
+  {
+    if (_values.size() >= NO_SLOT)
+    {
+      throw std::length_error("slot_map: too many elements");
+    }
+
+    _values.emplace_back(std::forward<Args>(args)...);
+    try
+    {
+      return AcquireSlot();
+    }
+    catch (...)
+    {
+      _values.pop_back();
+      throw;
+    }
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn bool slot_map<T>::erase(key_type key)
+  \brief  Removes the element the key refers to. The last value is moved
+          into its place in the dense array.
+  \return false if the key was stale or null
+  */
+  /***********************************************************************/
+  template <typename T>
+  bool slot_map<T>::erase(key_type key)
+  {
+    const uint32_t position = Resolve(key);
+    if (position == NO_SLOT)
+    {
+      return false;
+    }
+
+    RemoveAt(position);
+    return true;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename slot_map<T>::iterator slot_map<T>::erase(const_iterator pos)
+  \brief  Removes the element at pos, for erasing while scanning
+  \return Iterator to the value moved into pos, or end()
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename slot_map<T>::iterator slot_map<T>::erase(const_iterator pos)
+  {
+    const uint32_t position = static_cast<uint32_t>(pos - _values.cbegin());
+    RemoveAt(position);
+    return _values.begin() + position;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename slot_map<T>::pointer slot_map<T>::find(key_type key)
+  \brief  Looks up a key
+  \return Pointer to the element, nullptr if the key is stale or null.
+          Valid until the next insert or erase.
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename slot_map<T>::pointer slot_map<T>::find(key_type key)
+  {
+    const uint32_t position = Resolve(key);
+    return position == NO_SLOT ? nullptr : &_values[position];
+  }
+
+  template <typename T>
+  typename slot_map<T>::const_pointer slot_map<T>::find(key_type key) const
+  {
+    const uint32_t position = Resolve(key);
+    return position == NO_SLOT ? nullptr : &_values[position];
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn bool slot_map<T>::contains(key_type key) const
+  \brief Check if the key still refers to an element
+  */
+  /***********************************************************************/
+  template <typename T>
+  bool slot_map<T>::contains(key_type key) const
+  {
+    return Resolve(key) != NO_SLOT;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename slot_map<T>::reference slot_map<T>::at(key_type key)
+  \brief  Looks up a key, throws std::out_of_range if it is stale or null
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename slot_map<T>::reference slot_map<T>::at(key_type key)
+  {
+    const uint32_t position = Resolve(key);
+    if (position == NO_SLOT)
+    {
+      throw std::out_of_range{"slot_map: stale key"};
+    }
+    return _values[position];
+  }
+
+  template <typename T>
+  typename slot_map<T>::const_reference slot_map<T>::at(key_type key) const
+  {
+    const uint32_t position = Resolve(key);
+    if (position == NO_SLOT)
+    {
+      throw std::out_of_range{"slot_map: stale key"};
+    }
+    return _values[position];
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename slot_map<T>::reference slot_map<T>::operator[](key_type key)
+  \brief  Looks up a key that is known to be live, without checking
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename slot_map<T>::reference slot_map<T>::operator[](key_type key)
+  {
+    return _values[_slots[key.index()]._link];
+  }
+
+  template <typename T>
+  typename slot_map<T>::const_reference slot_map<T>::operator[](key_type key) const
+  {
+    return _values[_slots[key.index()]._link];
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename slot_map<T>::key_type slot_map<T>::key_of(const_iterator pos) const
+  \brief  Returns the key of the element at pos, for scans that need to
+          hand out keys
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename slot_map<T>::key_type slot_map<T>::key_of(const_iterator pos) const
+  {
+    const uint32_t index = _owners[static_cast<size_t>(pos - _values.cbegin())];
+    return key_type{index, _slots[index]._generation};
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void slot_map<T>::clear()
+  \brief  Removes every element. Every outstanding key becomes stale.
+  */
+  /***********************************************************************/
+  template <typename T>
+  void slot_map<T>::clear()
+  {
+    for (uint32_t index : _owners)
+    {
+      ReleaseSlot(index);
+    }
+    _values.clear();
+    _owners.clear();
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void slot_map<T>::reserve(size_type count)
+  \brief  Reserves room for count elements so inserts up to it do not
+          reallocate
+  */
+  /***********************************************************************/
+  template <typename T>
+  void slot_map<T>::reserve(size_type count)
+  {
+    _values.reserve(count);
+    _owners.reserve(count);
+    _slots.reserve(count);
+  }
+
+  template <typename T>
+  bool slot_map<T>::empty() const
+  {
+    return _values.empty();
+  }
+
+  template <typename T>
+  typename slot_map<T>::size_type slot_map<T>::size() const
+  {
+    return _values.size();
+  }
+
+  template <typename T>
+  typename slot_map<T>::size_type slot_map<T>::capacity() const
+  {
+    return _values.capacity();
+  }
+
+  template <typename T>
+  typename slot_map<T>::pointer slot_map<T>::data()
+  {
+    return _values.data();
+  }
+
+  template <typename T>
+  typename slot_map<T>::const_pointer slot_map<T>::data() const
+  {
+    return _values.data();
+  }
+
+  template <typename T>
+  typename slot_map<T>::const_iterator slot_map<T>::cbegin() const
+  {
+    return _values.cbegin();
+  }
+
+  template <typename T>
+  typename slot_map<T>::const_iterator slot_map<T>::cend() const
+  {
+    return _values.cend();
+  }
+
+  template <typename T>
+  typename slot_map<T>::const_iterator slot_map<T>::begin() const
+  {
+    return _values.begin();
+  }
+
+  template <typename T>
+  typename slot_map<T>::const_iterator slot_map<T>::end() const
+  {
+    return _values.end();
+  }
+
+  template <typename T>
+  typename slot_map<T>::iterator slot_map<T>::begin()
+  {
+    return _values.begin();
+  }
+
+  template <typename T>
+  typename slot_map<T>::iterator slot_map<T>::end()
+  {
+    return _values.end();
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn typename slot_map<T>::key_type slot_map<T>::AcquireSlot()
+  \brief  Pops the free list or appends a new slot, and points the slot
+          at the value just appended to the dense array
+  */
+  /***********************************************************************/
+  template <typename T>
+  typename slot_map<T>::key_type slot_map<T>::AcquireSlot()
+  {
+    const uint32_t position = static_cast<uint32_t>(_values.size() - 1);
+
+    // Grow _owners along with _values so nothing below can throw once the
+    // free list is touched
+    _owners.reserve(_values.capacity());
+    uint32_t index = _free_head;
+    if (index == NO_SLOT)
+    {
+      if (_slots.size() >= NO_SLOT)
+      {
+        throw std::length_error("slot_map: out of slots");
+      }
+      index = static_cast<uint32_t>(_slots.size());
+      _slots.push_back(slot{0, NO_SLOT});
+    }
+    else
+    {
+      _free_head = _slots[index]._link;
+      if (_free_head == NO_SLOT)
+      {
+        _free_tail = NO_SLOT;
+      }
+    }
+
+    slot& current = _slots[index];
+    ++current._generation;
+    current._link = position;
+    _owners.push_back(index);
+    return key_type{index, current._generation};
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void slot_map<T>::RemoveAt(uint32_t position)
+  \brief  Removes the dense value at position and frees its slot
+  */
+  /***********************************************************************/
+  template <typename T>
+  void slot_map<T>::RemoveAt(uint32_t position)
+  {
+    const uint32_t index = _owners[position];
+    const uint32_t last = static_cast<uint32_t>(_values.size() - 1);
+    if (position != last)
+    {
+      _values[position] = std::move(_values[last]);
+      _owners[position] = _owners[last];
+      _slots[_owners[position]]._link = position;
+    }
+    _values.pop_back();
+    _owners.pop_back();
+    ReleaseSlot(index);
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn void slot_map<T>::ReleaseSlot(uint32_t index)
+  \brief  Bumps the slot's generation and appends it to the free list,
+          or retires it if the generation would wrap
+  */
+  /***********************************************************************/
+  template <typename T>
+  void slot_map<T>::ReleaseSlot(uint32_t index)
+  {
+    slot& current = _slots[index];
+    ++current._generation;
+    current._link = NO_SLOT;
+
+    // The generation wrapped, reusing the slot would revive keys handed out
+    // 2^31 uses ago so it is retired instead
+    if (current._generation == 0)
+    {
+      return;
+    }
+
+    // Reusing the oldest free slot spreads generation bumps over every slot
+    if (_free_tail == NO_SLOT)
+    {
+      _free_head = index;
+    }
+    else
+    {
+      _slots[_free_tail]._link = index;
+    }
+    _free_tail = index;
+  }
+
+  /***********************************************************************/
+  /*!
+  \fn uint32_t slot_map<T>::Resolve(key_type key) const
+  \brief  Returns the dense position of a live key, NO_SLOT otherwise
+  */
+  /***********************************************************************/
+  template <typename T>
+  uint32_t slot_map<T>::Resolve(key_type key) const
+  {
+    const uint32_t index = key.index();
+    if (index >= _slots.size())
+    {
+      return NO_SLOT;
+    }
+
+    const slot& current = _slots[index];
+    return current._generation == key.generation() && (current._generation & 1u) ? current._link : NO_SLOT;
+  }
+}
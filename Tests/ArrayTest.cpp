@@ -0,0 +1,116 @@
+// CustomSTL::array: everything it offers works at compile time, which the
+// static_asserts below prove just by compiling, and the bounds policies
+// decide what operator[] does with a bad index at run time. Returns
+// non-zero on failure.
+
+#include <Types/Base.h>
+#include <STLContainers/array.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+  using CustomSTL::array;
+  using CustomSTL::bounds_checked;
+  using CustomSTL::bounds_unchecked;
+
+  int s_Failures = 0;
+
+  void Check(bool condition, const char *what)
+  {
+    if (!condition)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++s_Failures;
+    }
+  }
+
+  constexpr array<u8, 4, bounds_checked> TABLE = {1, 2, 4, 8};
+
+  static_assert(TABLE[2] == 4 && TABLE.at(3) == 8);
+  static_assert(TABLE.front() == 1 && TABLE.back() == 8 && TABLE.size() == 4);
+  static_assert(*TABLE.data() == 1 && TABLE.end() - TABLE.begin() == 4 && TABLE.cend() - TABLE.cbegin() == 4);
+
+  constexpr u32 Sum(std::span<const u8, 4> values)
+  {
+    u32 sum = 0;
+    for (u8 value : values)
+      sum += value;
+    return sum;
+  }
+  static_assert(Sum(TABLE) == 15);
+
+  // Builds a table through the mutating members
+  constexpr array<u32, 8> Squares()
+  {
+    array<u32, 8> squares{};
+    squares.fill(1);
+    for (u32 i = 0; i < squares.size(); ++i)
+      squares[i] *= i * i;
+    array<u32, 8> other{};
+    other.swap(squares);
+    other.front() += 100;
+    other.at(7) = 49;
+    return other;
+  }
+  static_assert(Squares()[0] == 100 && Squares()[3] == 9 && Squares().back() == 49);
+
+  // A throwing check is not a constant expression, so an index past the
+  // end is rejected at compile time
+  template <size_t Index>
+  constexpr bool READABLE = requires { typename std::integral_constant<u8, TABLE[Index]>; };
+  static_assert(READABLE<3> && !READABLE<4>);
+
+  static_assert(std::is_aggregate_v<array<int, 3>>);
+  static_assert(alignof(array<float, 8, bounds_unchecked, 32>) == 32);
+
+  template <typename Bounds>
+  bool Throws(size_t index)
+  {
+    array<int, 4, Bounds> values = {1, 2, 3, 4};
+    try
+    {
+      (void)values[index];
+    }
+    catch (const std::out_of_range &)
+    {
+      return true;
+    }
+    return false;
+  }
+
+  void BoundsPolicies()
+  {
+    Check(Throws<bounds_checked>(4), "bounds_checked operator[] throws past the end");
+    Check(!Throws<bounds_checked>(3), "bounds_checked operator[] accepts the last index");
+    Check(!Throws<bounds_unchecked>(0), "bounds_unchecked operator[] does not throw");
+
+    array<int, 4, bounds_unchecked> values = {1, 2, 3, 4};
+    bool threw = false;
+    try
+    {
+      values.at(4) = 0;
+    }
+    catch (const std::out_of_range &)
+    {
+      threw = true;
+    }
+    Check(threw, "at() throws whatever the bounds policy");
+
+    array<float, 8, bounds_unchecked, 32> aligned{};
+    Check(reinterpret_cast<std::uintptr_t>(aligned.data()) % 32 == 0, "Align aligns the storage");
+  }
+}
+
+int main()
+{
+  BoundsPolicies();
+
+  if (s_Failures)
+    std::fprintf(stderr, "%d checks failed\n", s_Failures);
+  return s_Failures ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+// ConcurrentHashMap under load: four threads mixing reads, writes, erases,
+// updates and ForEach over a few shards. Each thread owns a range of keys
+// and mirrors them in a std::unordered_map, all threads read every range.
+// Returns non-zero on failure, build with -fsanitize=thread to catch a
+// missing lock.
+
+#include <Containers/ConcurrentHashMap.h>
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  using CustomSTL::ConcurrentHashMap;
+
+  int s_Failures = 0;
+
+  void Check(bool condition, const char *what)
+  {
+    if (!condition)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++s_Failures;
+    }
+  }
+
+  // A value names its key, so a reader can tell a torn or misplaced entry
+  struct Entry
+  {
+    u64 key;
+    u64 version;
+  };
+
+  void StressMixed()
+  {
+    constexpr u64 THREADS = 4;
+    constexpr u64 KEYS = 512;       // Per thread
+    constexpr u64 OPERATIONS = 100000;
+    constexpr u64 COUNTER = ~0ULL;  // Shared key every thread updates
+
+    ConcurrentHashMap<u64, Entry> map(4);
+    map.Insert(COUNTER, {COUNTER, 0});
+
+    std::vector<std::unordered_map<u64, u64>> mirrors(THREADS);
+    std::atomic<u64> mismatches{0};
+    std::atomic<u64> updates{0};
+
+    std::vector<std::thread> threads;
+    for (u64 t = 0; t < THREADS; ++t)
+      threads.emplace_back([&, t] {
+        std::unordered_map<u64, u64> &mirror = mirrors[t];
+        std::mt19937_64 random(t);
+        u64 bad = 0;
+        for (u64 i = 0; i < OPERATIONS; ++i)
+        {
+          const u64 op = random() % 100;
+          const u64 own = t * KEYS + random() % KEYS;
+          const u64 any = random() % (THREADS * KEYS);
+          Entry found;
+          if (op < 40)
+          {
+            if (map.Find(any, found) && found.key != any)
+              ++bad;
+          }
+          else if (op < 60)
+          {
+            map.InsertOrAssign(own, {own, i});
+            mirror[own] = i;
+          }
+          else if (op < 70)
+          {
+            if (map.Insert(own, {own, i}) != !mirror.contains(own))
+              ++bad;
+            mirror.try_emplace(own, i);
+          }
+          else if (op < 85)
+          {
+            if (map.Erase(own) != (mirror.erase(own) != 0))
+              ++bad;
+          }
+          else if (op < 95)
+          {
+            if (map.Update(COUNTER, [](Entry &entry) { ++entry.version; }))
+              updates.fetch_add(1, std::memory_order_relaxed);
+            else
+              ++bad;
+          }
+          else if (op < 99)
+          {
+            const bool owned = mirror.contains(own);
+            if (map.Contains(own) != owned)
+              ++bad;
+            if (owned && map.Find(own, found) && found.version != mirror[own])
+              ++bad;
+          }
+          else
+          {
+            map.ForEach([&bad](const u64 &key, const Entry &entry) {
+              if (entry.key != key)
+                ++bad;
+            });
+          }
+        }
+        mismatches.fetch_add(bad, std::memory_order_relaxed);
+      });
+    for (std::thread &thread : threads)
+      thread.join();
+
+    size_t expected = 1;
+    bool same = true;
+    for (const std::unordered_map<u64, u64> &mirror : mirrors)
+    {
+      expected += mirror.size();
+      for (const auto &[key, version] : mirror)
+      {
+        Entry found;
+        same = same && map.Find(key, found) && found.key == key && found.version == version;
+      }
+    }
+    u64 visited = 0;
+    map.ForEach([&visited](const u64 &, const Entry &) { ++visited; });
+
+    Entry counter{};
+    map.Find(COUNTER, counter);
+
+    std::printf("ConcurrentHashMap: %zu entries, %llu updates, %llu mismatches\n", map.Size(),
+                static_cast<unsigned long long>(updates.load()), static_cast<unsigned long long>(mismatches.load()));
+    Check(mismatches.load() == 0, "every read agrees with the writing thread's mirror");
+    Check(same, "the map matches the mirrors once the threads are joined");
+    Check(map.Size() == expected && visited == expected, "Size and ForEach count every entry");
+    Check(counter.version == updates.load(), "no Update on the shared key is lost");
+  }
+}
+
+int main()
+{
+  StressMixed();
+
+  if (s_Failures)
+    std::fprintf(stderr, "%d checks failed\n", s_Failures);
+  return s_Failures ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+// flat_hash_map and flat_hash_set checked against std::unordered_map and
+// std::unordered_set under erase-heavy churn that fills the table with
+// tombstones, plus the reserve no-rehash guarantee and lookups by
+// std::string_view and C string. Returns non-zero on failure.
+
+#include <Types/Base.h>
+#include <STLContainers/flat_hash_map.h>
+#include <STLContainers/flat_hash_set.h>
+
+#include <bit>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+  using CustomSTL::flat_hash_map;
+  using CustomSTL::flat_hash_set;
+
+  int s_Failures = 0;
+
+  void Check(bool condition, const char *what)
+  {
+    if (!condition)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++s_Failures;
+    }
+  }
+
+  template <typename Map, typename Expected>
+  bool SameMap(const Map &map, const Expected &expected)
+  {
+    if (map.size() != expected.size())
+      return false;
+    size_t visited = 0;
+    for (const auto &[key, value] : map)
+    {
+      auto found = expected.find(key);
+      if (found == expected.end() || found->second != value)
+        return false;
+      ++visited;
+    }
+    return visited == expected.size();
+  }
+
+  // Keys come from a small range, so erased slots are probed over and
+  // refilled again and again. Phases of mostly erases drain the table to
+  // leave it full of tombstones before it is refilled.
+  void MapAgainstUnorderedMap()
+  {
+    constexpr u64 KEYS = 4096;
+    flat_hash_map<u64, std::string> map;
+    std::unordered_map<u64, std::string> expected;
+    std::mt19937_64 random(2);
+
+    bool same = true;
+    size_t maxCapacity = 0;
+    for (u64 i = 0; i < 400000; ++i)
+    {
+      const bool draining = (i / 20000) % 2 == 1;
+      const u64 op = random() % 10;
+      const u64 key = random() % KEYS;
+      if (op < (draining ? 8u : 3u))
+      {
+        same = same && map.erase(key) == expected.erase(key);
+      }
+      else if (op < 9)
+      {
+        const std::string value = std::to_string(i);
+        same = same && map.insert_or_assign(key, value).second == expected.insert_or_assign(key, value).second;
+      }
+      else
+      {
+        auto found = map.find(key);
+        auto wanted = expected.find(key);
+        same = same && (found == map.end() ? wanted == expected.end()
+                                           : wanted != expected.end() && found->second == wanted->second);
+      }
+      maxCapacity = std::max(maxCapacity, map.capacity());
+      if (i % 50000 == 0)
+        same = same && SameMap(map, expected);
+    }
+    same = same && SameMap(map, expected);
+
+    // Erase through iterators while walking
+    for (auto it = map.begin(); it != map.end();)
+    {
+      if (it->first % 3 == 0)
+      {
+        expected.erase(it->first);
+        it = map.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+    same = same && SameMap(map, expected);
+
+    std::printf("flat_hash_map: %zu entries, capacity peaked at %zu\n", map.size(), maxCapacity);
+    Check(same, "flat_hash_map agrees with std::unordered_map under erase-heavy churn");
+    Check(maxCapacity <= 4 * std::bit_ceil(KEYS), "tombstones are compacted instead of growing the table");
+  }
+
+  void SetAgainstUnorderedSet()
+  {
+    constexpr u64 KEYS = 1000;
+    flat_hash_set<u64> set;
+    std::unordered_set<u64> expected;
+    std::mt19937_64 random(3);
+
+    bool same = true;
+    for (u64 i = 0; i < 200000; ++i)
+    {
+      const u64 key = random() % KEYS;
+      if (random() % 2)
+        same = same && set.insert(key).second == expected.insert(key).second;
+      else
+        same = same && set.erase(key) == expected.erase(key);
+      same = same && set.contains(key) == expected.contains(key) && set.count(key) == expected.count(key);
+    }
+    same = same && set.size() == expected.size();
+    for (u64 key : set)
+      same = same && expected.contains(key);
+    Check(same, "flat_hash_set agrees with std::unordered_set under erase-heavy churn");
+  }
+
+  // After reserve(n), n inserts keep the capacity and every element where
+  // it was, so pointers taken along the way stay valid
+  void ReserveDoesNotRehash()
+  {
+    bool stable = true;
+    for (size_t count : {1, 7, 8, 15, 16, 100, 1000, 4097})
+    {
+      flat_hash_map<u64, u64> map;
+      map.reserve(count);
+      const size_t capacity = map.capacity();
+
+      std::vector<const u64 *> values;
+      for (u64 i = 0; i < count; ++i)
+        values.push_back(&map.try_emplace(i * 0x9E3779B97F4A7C15ULL, i).first->second);
+
+      stable = stable && map.capacity() == capacity && map.size() == count;
+      for (u64 i = 0; i < count; ++i)
+        stable = stable && values[i] == &map.find(i * 0x9E3779B97F4A7C15ULL)->second && *values[i] == i;
+    }
+    Check(stable, "inserting up to the reserved count does not rehash");
+  }
+
+  void HeterogeneousLookup()
+  {
+    flat_hash_map<std::string, int> map;
+    map.emplace("alpha", 1);
+    map.emplace("beta", 2);
+    map.emplace(std::string(100, 'x'), 3);
+
+    const std::string_view beta = "beta";
+    const char *alpha = "alpha";
+    const std::string longKey(100, 'x');
+
+    bool found = map.find(beta) != map.end() && map.find(beta)->second == 2;
+    found = found && map.contains(alpha) && map.find(alpha)->second == 1;
+    found = found && map.count(std::string_view(longKey)) == 1;
+    found = found && !map.contains(std::string_view("gamma")) && map.find("gamma") == map.end();
+    found = found && map.erase(beta) == 1 && !map.contains(beta) && map.size() == 2;
+
+    flat_hash_set<std::string> set;
+    set.insert("one");
+    set.insert("two");
+    found = found && set.contains(std::string_view("one")) && set.contains("two") && !set.contains("three");
+    found = found && set.erase(std::string_view("one")) == 1 && set.size() == 1;
+
+    Check(found, "std::string keys are found and erased by std::string_view and C string");
+  }
+}
+
+int main()
+{
+  MapAgainstUnorderedMap();
+  SetAgainstUnorderedSet();
+  ReserveDoesNotRehash();
+  HeterogeneousLookup();
+
+  if (s_Failures)
+    std::fprintf(stderr, "%d checks failed\n", s_Failures);
+  return s_Failures ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+// MPSCQueue with Wakeup under load: four producers enqueue in bursts while
+// the consumer sleeps in Wait() whenever the queue looks empty. A lost
+// wakeup leaves items behind after the producers finish, which the test
+// reports instead of hanging. Returns non-zero on failure.
+
+#include <Containers/MPSCQueue.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  using CustomSTL::MPSCNode;
+  using CustomSTL::MPSCQueue;
+
+  int s_Failures = 0;
+
+  void Check(bool condition, const char *what)
+  {
+    if (!condition)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++s_Failures;
+    }
+  }
+
+  struct Item : MPSCNode
+  {
+    u64 producer;
+    u64 sequence;
+  };
+
+  void StressWait()
+  {
+    constexpr u64 PRODUCERS = 4;
+    constexpr u64 ITEMS = 100000;
+    constexpr u64 BURST = 64;
+
+    std::vector<Item> items(PRODUCERS * ITEMS);
+    MPSCQueue<Item, true> queue;
+    std::atomic<u64> received{0};
+    std::atomic<bool> stop{false};
+    u64 outOfOrder = 0;
+
+    std::thread consumer([&] {
+      u64 expected[PRODUCERS] = {};
+      while (!stop.load(std::memory_order_acquire))
+      {
+        queue.Wait();
+        while (Item *item = queue.Dequeue())
+        {
+          if (item->sequence != expected[item->producer])
+            ++outOfOrder;
+          expected[item->producer] = item->sequence + 1;
+          received.fetch_add(1, std::memory_order_release);
+        }
+      }
+    });
+
+    // Bursts with a pause in between let the consumer drain and go to
+    // sleep, so most bursts start against a sleeping consumer
+    std::vector<std::thread> producers;
+    for (u64 p = 0; p < PRODUCERS; ++p)
+      producers.emplace_back([&, p] {
+        for (u64 i = 0; i < ITEMS; ++i)
+        {
+          Item &item = items[p * ITEMS + i];
+          item.producer = p;
+          item.sequence = i;
+          queue.Enqueue(&item);
+          if (i % BURST == BURST - 1)
+            std::this_thread::yield();
+        }
+      });
+    for (std::thread &producer : producers)
+      producer.join();
+
+    // Without a WakeUp the consumer only gets the tail of the last bursts
+    // if the producers woke it
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (received.load(std::memory_order_acquire) < PRODUCERS * ITEMS && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const u64 drained = received.load(std::memory_order_acquire);
+
+    stop.store(true, std::memory_order_release);
+    queue.WakeUp();
+    consumer.join();
+
+    std::printf("MPSCQueue: %llu of %llu items received\n", static_cast<unsigned long long>(drained),
+                static_cast<unsigned long long>(PRODUCERS * ITEMS));
+    Check(drained == PRODUCERS * ITEMS, "the consumer is woken for every item without an explicit WakeUp");
+    Check(outOfOrder == 0, "each producer's items come out in the order they were enqueued");
+    Check(queue.IsEmpty(), "the queue is empty once everything is drained");
+  }
+}
+
+int main()
+{
+  StressWait();
+
+  if (s_Failures)
+    std::fprintf(stderr, "%d checks failed\n", s_Failures);
+  return s_Failures ? 1 : 0;
+}
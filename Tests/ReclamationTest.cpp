@@ -0,0 +1,275 @@
+// EpochReclamation and HazardPointers under load: four threads pushing and
+// popping a Treiber stack, and orphans from threads that exit in the
+// opposite order to their retire epochs. Returns non-zero on failure,
+// build with -fsanitize=address or thread to catch a premature free.
+
+#include <Utils/EpochReclamation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  using CustomSTL::EpochReclamation;
+  using CustomSTL::HazardPointers;
+
+  int s_Failures = 0;
+
+  void Check(bool condition, const char *what)
+  {
+    if (!condition)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++s_Failures;
+    }
+  }
+
+  constexpr u64 ALIVE = 0xA11CE5A11CE5A11CULL;
+  constexpr u64 DEAD = 0xDEADDEADDEADDEADULL;
+
+  std::atomic<i64> s_LiveNodes{0};
+
+  struct Node
+  {
+    u64 magic = ALIVE;
+    u64 value;
+    Node *next;
+
+    Node(u64 value, Node *next) : value(value), next(next)
+    {
+      s_LiveNodes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~Node()
+    {
+      magic = DEAD;
+      s_LiveNodes.fetch_sub(1, std::memory_order_relaxed);
+    }
+  };
+
+  std::atomic<u64> s_FreedWhileRead{0};
+
+  class TreiberStack
+  {
+  protected:
+    std::atomic<Node *> head{nullptr};
+
+  public:
+    void Push(u64 value)
+    {
+      Node *node = new Node(value, head.load(std::memory_order_relaxed));
+      while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    }
+  };
+
+  class EpochStack : public TreiberStack
+  {
+  public:
+    bool Pop(u64 &value)
+    {
+      Node *node;
+      {
+        EpochReclamation::Guard guard;
+        node = head.load(std::memory_order_acquire);
+        while (node)
+        {
+          if (node->magic != ALIVE)
+            s_FreedWhileRead.fetch_add(1, std::memory_order_relaxed);
+          if (head.compare_exchange_weak(node, node->next, std::memory_order_acquire))
+            break;
+        }
+        if (!node)
+          return false;
+        value = node->value;
+      }
+      EpochReclamation::Retire(node);
+      return true;
+    }
+
+    static void Drain()
+    {
+      EpochReclamation::Synchronize();
+    }
+  };
+
+  class HazardStack : public TreiberStack
+  {
+  public:
+    bool Pop(u64 &value)
+    {
+      HazardPointers::Guard guard;
+      while (Node *node = guard.Protect(head))
+      {
+        if (node->magic != ALIVE)
+          s_FreedWhileRead.fetch_add(1, std::memory_order_relaxed);
+        if (head.compare_exchange_strong(node, node->next, std::memory_order_acquire))
+        {
+          value = node->value;
+          guard.Reset();
+          HazardPointers::Retire(node);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    static void Drain()
+    {
+      HazardPointers::Reclaim();
+    }
+  };
+
+  // Every thread pushes its own values and pops whatever is on top, then
+  // exits with its retire list still full. Every value must come out
+  // exactly once and every node must be freed once the lists are drained.
+  template <typename Stack>
+  void StressStack(const char *name)
+  {
+    constexpr u64 THREADS = 4;
+    constexpr u64 OPERATIONS = 200000;
+
+    s_FreedWhileRead.store(0);
+    std::vector<u64> popped[THREADS];
+    {
+      Stack stack;
+      std::vector<std::thread> threads;
+      for (u64 t = 0; t < THREADS; ++t)
+        threads.emplace_back([&stack, &popped, t] {
+          std::vector<u64> &mine = popped[t];
+          u64 value;
+          for (u64 i = 0; i < OPERATIONS; ++i)
+          {
+            stack.Push((t << 32) | i);
+            if (i % 3 != 0 && stack.Pop(value))
+              mine.push_back(value);
+          }
+        });
+      for (std::thread &thread : threads)
+        thread.join();
+
+      u64 value;
+      while (stack.Pop(value))
+        popped[0].push_back(value);
+      Stack::Drain();
+    }
+
+    std::vector<u64> all;
+    for (const std::vector<u64> &mine : popped)
+      all.insert(all.end(), mine.begin(), mine.end());
+    std::sort(all.begin(), all.end());
+
+    bool exact = all.size() == THREADS * OPERATIONS;
+    for (u64 i = 0; exact && i < all.size(); ++i)
+      exact = all[i] == (((i / OPERATIONS) << 32) | (i % OPERATIONS));
+
+    std::printf("%s: %zu values popped, %lld nodes left\n", name, all.size(),
+                static_cast<long long>(s_LiveNodes.load()));
+    Check(exact, "every pushed value is popped exactly once");
+    Check(s_FreedWhileRead.load() == 0, "no node is freed while a popper reads it");
+    Check(s_LiveNodes.load() == 0, "every node is freed once the retire lists are drained");
+  }
+
+  struct Tracked
+  {
+    std::atomic<bool> *freed;
+  };
+
+  void FreeTracked(void *object)
+  {
+    Tracked *tracked = static_cast<Tracked *>(object);
+    tracked->freed->store(true);
+    delete tracked;
+  }
+
+  // Runs work on its own thread and keeps the thread alive until Finish,
+  // which runs finish on it before it exits
+  class Worker
+  {
+  public:
+    explicit Worker(std::function<void()> work, std::function<void()> finish = [] {})
+    {
+      m_Thread = std::thread([this, work, finish] {
+        work();
+        {
+          std::unique_lock<std::mutex> lock(m_Mutex);
+          m_Done = true;
+          m_Changed.notify_all();
+          m_Changed.wait(lock, [this] { return m_Exit; });
+        }
+        finish();
+      });
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Changed.wait(lock, [this] { return m_Done; });
+    }
+
+    void Finish()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Exit = true;
+      }
+      m_Changed.notify_all();
+      m_Thread.join();
+    }
+
+  private:
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Changed;
+    bool m_Done = false;
+    bool m_Exit = false;
+  };
+
+  // A retires in epoch e + 2 and exits, then B, which retired in epoch e,
+  // exits. The orphans are A's then B's, newest first. A reader pinned in
+  // e + 2 lets Reclaim advance to e + 3, where B's object is safe and A's
+  // is not.
+  void OrphansOutOfOrder()
+  {
+    EpochReclamation::Synchronize();
+    std::atomic<bool> freedA{false}, freedB{false};
+
+    const u64 epoch = EpochReclamation::Epoch();
+    Worker b([&] { EpochReclamation::Retire(new Tracked{&freedB}, FreeTracked); });
+    EpochReclamation::Reclaim();
+    EpochReclamation::Reclaim();
+    Check(EpochReclamation::Epoch() == epoch + 2, "the epoch advances while nothing is pinned");
+
+    Worker a([&] { EpochReclamation::Retire(new Tracked{&freedA}, FreeTracked); });
+    a.Finish();
+
+    std::optional<EpochReclamation::Guard> pinned;
+    Worker reader([&] { pinned.emplace(); }, [&] { pinned.reset(); });
+    b.Finish();
+
+    EpochReclamation::Reclaim();
+    std::printf("orphans: epoch %llu, B freed %d, A freed %d\n",
+                static_cast<unsigned long long>(EpochReclamation::Epoch() - epoch), freedB.load(), freedA.load());
+    Check(EpochReclamation::Epoch() == epoch + 3, "a reader pinned in the current epoch lets it advance once");
+    Check(freedB.load(), "an orphan two epochs old is freed");
+    Check(!freedA.load(), "an orphan from the pinned reader's epoch is kept");
+
+    reader.Finish();
+    EpochReclamation::Synchronize();
+    Check(freedA.load(), "the orphan is freed once the reader unpins");
+  }
+}
+
+int main()
+{
+  StressStack<EpochStack>("EpochReclamation");
+  StressStack<HazardStack>("HazardPointers");
+  OrphansOutOfOrder();
+
+  if (s_Failures)
+    std::fprintf(stderr, "%d checks failed\n", s_Failures);
+  return s_Failures ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+// simd algorithms at every level the CPU supports, compared with plain
+// loops for every element type, over sizes around the vector widths and
+// unaligned starts. Values are small integers, so float sums are exact
+// whatever order the lanes add them in. Returns non-zero on failure.
+
+#include <Utils/SimdAlgorithms.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+  namespace simd = CustomSTL::simd;
+
+  int s_Failures = 0;
+
+  void Check(bool condition, const char *what)
+  {
+    if (!condition)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++s_Failures;
+    }
+  }
+
+  constexpr size_t SIZES[] = {0, 1, 3, 7, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 257, 1000};
+  constexpr size_t OFFSETS = 4;     // Unaligned starts into the buffer
+  constexpr simd::compare_op COMPARES[] = {simd::compare_op::eq, simd::compare_op::ne, simd::compare_op::lt,
+                                           simd::compare_op::le, simd::compare_op::gt, simd::compare_op::ge};
+  constexpr simd::transform_op TRANSFORMS[] = {simd::transform_op::add, simd::transform_op::sub,
+                                               simd::transform_op::mul, simd::transform_op::min,
+                                               simd::transform_op::max};
+
+  template <typename T>
+  bool Holds(simd::compare_op op, T a, T b)
+  {
+    switch (op)
+    {
+    case simd::compare_op::eq: return a == b;
+    case simd::compare_op::ne: return a != b;
+    case simd::compare_op::lt: return a < b;
+    case simd::compare_op::le: return a <= b;
+    case simd::compare_op::gt: return a > b;
+    default: return a >= b;
+    }
+  }
+
+  // Integers wrap, so they are computed in the unsigned type
+  template <typename T>
+  T Apply(simd::transform_op op, T a, T b)
+  {
+    using W = typename std::conditional_t<std::is_integral_v<T>, std::make_unsigned<std::common_type_t<T, unsigned>>,
+                                          std::type_identity<T>>::type;
+    switch (op)
+    {
+    case simd::transform_op::add: return static_cast<T>(static_cast<W>(a) + static_cast<W>(b));
+    case simd::transform_op::sub: return static_cast<T>(static_cast<W>(a) - static_cast<W>(b));
+    case simd::transform_op::mul: return static_cast<T>(static_cast<W>(a) * static_cast<W>(b));
+    case simd::transform_op::min: return std::min(a, b);
+    default: return std::max(a, b);
+    }
+  }
+
+  template <typename T>
+  T Draw(std::mt19937_64 &random)
+  {
+    const int value = static_cast<int>(random() % 121);
+    return static_cast<T>(std::is_signed_v<T> ? value - 60 : value);
+  }
+
+  // Every op on every size and offset, true if all match the plain loops
+  template <typename T>
+  bool MatchesScalar(std::mt19937_64 &random)
+  {
+    bool same = true;
+    std::vector<T> buffer(1000 + OFFSETS), other(1000 + OFFSETS), output(1000 + OFFSETS);
+    for (size_t size : SIZES)
+      for (size_t offset = 0; offset < OFFSETS; ++offset)
+      {
+        for (size_t i = 0; i < buffer.size(); ++i)
+        {
+          buffer[i] = Draw<T>(random);
+          other[i] = Draw<T>(random);
+        }
+        const std::span<const T> a(buffer.data() + offset, size);
+        const std::span<const T> b(other.data() + offset, size);
+        const std::span<T> out(output.data() + offset, size);
+
+        simd::sum_t<T> total = 0;
+        for (T value : a)
+          total += static_cast<simd::sum_t<T>>(value);
+        same = same && simd::sum(a) == total;
+
+        if (size)
+        {
+          same = same && simd::min(a) == *std::min_element(a.begin(), a.end());
+          same = same && simd::max(a) == *std::max_element(a.begin(), a.end());
+        }
+
+        // A value from the data so eq finds something, and one that may not
+        const T probes[] = {size ? a[random() % size] : T(0), Draw<T>(random)};
+        for (T probe : probes)
+          for (simd::compare_op op : COMPARES)
+          {
+            size_t first = size, count = 0;
+            for (size_t i = 0; i < size; ++i)
+              if (Holds(op, a[i], probe))
+              {
+                first = std::min(first, i);
+                ++count;
+              }
+            same = same && simd::find_if(a, op, probe) == first && simd::count_if(a, op, probe) == count;
+          }
+
+        for (simd::transform_op op : TRANSFORMS)
+        {
+          simd::transform(a, out, op, probes[1]);
+          for (size_t i = 0; i < size; ++i)
+            same = same && out[i] == Apply(op, a[i], probes[1]);
+          simd::transform(a, b, out, op);
+          for (size_t i = 0; i < size; ++i)
+            same = same && out[i] == Apply(op, a[i], b[i]);
+        }
+      }
+    return same;
+  }
+
+  const char *Name(simd::level level)
+  {
+    switch (level)
+    {
+    case simd::level::scalar: return "scalar";
+    case simd::level::sse2: return "sse2";
+    default: return "avx2";
+    }
+  }
+
+  void EveryLevel()
+  {
+    const simd::level detected = simd::detected_level();
+    for (simd::level level : {simd::level::scalar, simd::level::sse2, simd::level::avx2})
+    {
+      if (level > detected)
+      {
+        std::printf("simd: %s not supported, skipped\n", Name(level));
+        continue;
+      }
+      simd::set_level(level);
+      Check(simd::active_level() == level, "set_level selects a supported level");
+
+      std::printf("simd: checking %s\n", Name(level));
+      std::mt19937_64 random(static_cast<u64>(level));
+      Check(MatchesScalar<i8>(random), "i8 ops match the plain loops");
+      Check(MatchesScalar<u8>(random), "u8 ops match the plain loops");
+      Check(MatchesScalar<i16>(random), "i16 ops match the plain loops");
+      Check(MatchesScalar<u16>(random), "u16 ops match the plain loops");
+      Check(MatchesScalar<i32>(random), "i32 ops match the plain loops");
+      Check(MatchesScalar<u32>(random), "u32 ops match the plain loops");
+      Check(MatchesScalar<i64>(random), "i64 ops match the plain loops");
+      Check(MatchesScalar<u64>(random), "u64 ops match the plain loops");
+      Check(MatchesScalar<f32>(random), "f32 ops match the plain loops");
+      Check(MatchesScalar<f64>(random), "f64 ops match the plain loops");
+    }
+    simd::set_level(detected);
+  }
+}
+
+int main()
+{
+  EveryLevel();
+
+  if (s_Failures)
+    std::fprintf(stderr, "%d checks failed\n", s_Failures);
+  return s_Failures ? 1 : 0;
+}
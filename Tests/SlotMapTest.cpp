@@ -0,0 +1,180 @@
+// slot_map: stale keys must never resolve, not after their slot is reused
+// and not after its generation wraps, and erasing while scanning must visit
+// every element once. Returns non-zero on failure.
+//
+// The generation wrap needs 2^31 reuses of one slot, about half a minute,
+// so it only runs with --wrap and is registered as its own slow test.
+
+#include <Types/Base.h>
+#include <STLContainers/slot_map.h>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  using CustomSTL::slot_map;
+  using CustomSTL::slot_map_key;
+
+  int s_Failures = 0;
+
+  void Check(bool condition, const char *what)
+  {
+    if (!condition)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++s_Failures;
+    }
+  }
+
+  bool IsStale(slot_map<u64> &map, slot_map_key key)
+  {
+    bool threw = false;
+    try
+    {
+      map.at(key);
+    }
+    catch (const std::out_of_range &)
+    {
+      threw = true;
+    }
+    return threw && !map.contains(key) && !map.find(key) && !map.erase(key);
+  }
+
+  void StaleKeys()
+  {
+    slot_map<u64> map;
+    const slot_map_key a = map.insert(1);
+    const slot_map_key b = map.insert(2);
+    const slot_map_key c = map.insert(3);
+
+    Check(map.erase(b), "erasing a live key succeeds");
+    Check(IsStale(map, b), "an erased key is stale");
+    Check(IsStale(map, slot_map_key{}), "the null key is stale");
+    Check(IsStale(map, slot_map_key{7, 1}), "a key past the last slot is stale");
+
+    const slot_map_key d = map.insert(4);
+    Check(d.index() == b.index() && d.generation() != b.generation(), "a freed slot is reused with a new generation");
+    Check(IsStale(map, b), "a key stays stale after its slot is reused");
+    Check(map.at(a) == 1 && map.at(c) == 3 && map.at(d) == 4, "live keys still resolve to their values");
+
+    map.clear();
+    Check(IsStale(map, a) && IsStale(map, c) && IsStale(map, d), "clear makes every key stale");
+    Check(map.empty(), "clear removes every element");
+  }
+
+  // Random inserts and erases checked against a std::unordered_map keyed
+  // by the raw key, with stale keys kept around and probed
+  void AgainstUnorderedMap()
+  {
+    slot_map<u64> map;
+    std::unordered_map<u64, u64> expected;
+    std::vector<slot_map_key> live, dead;
+    std::mt19937_64 random(1);
+
+    bool same = true;
+    for (u64 i = 0; i < 200000; ++i)
+    {
+      if (live.empty() || random() % 3 != 0)
+      {
+        const slot_map_key key = map.insert(i);
+        same = same && expected.emplace(key.raw(), i).second;
+        live.push_back(key);
+      }
+      else
+      {
+        const size_t pick = random() % live.size();
+        const slot_map_key key = live[pick];
+        live[pick] = live.back();
+        live.pop_back();
+        same = same && map.erase(key) && expected.erase(key.raw()) == 1;
+        dead.push_back(key);
+      }
+      if (!dead.empty())
+        same = same && !map.contains(dead[random() % dead.size()]);
+    }
+
+    same = same && map.size() == expected.size();
+    for (const slot_map_key key : live)
+      same = same && map.contains(key) && map[key] == expected[key.raw()];
+    for (const slot_map_key key : dead)
+      same = same && !map.contains(key);
+    Check(same, "slot_map agrees with std::unordered_map and no dead key resolves");
+  }
+
+  void EraseDuringScan()
+  {
+    constexpr u64 COUNT = 1000;
+    slot_map<u64> map;
+    std::vector<slot_map_key> keys;
+    for (u64 i = 0; i < COUNT; ++i)
+      keys.push_back(map.insert(i));
+
+    // erase moves the last value into pos, so pos is looked at again
+    u64 visited = 0;
+    for (auto it = map.begin(); it != map.end();)
+    {
+      ++visited;
+      if (*it % 2 == 0)
+        it = map.erase(it);
+      else
+        ++it;
+    }
+
+    bool kept = map.size() == COUNT / 2;
+    for (u64 i = 0; i < COUNT; ++i)
+      kept = kept && (i % 2 == 0 ? !map.contains(keys[i]) : map.find(keys[i]) && *map.find(keys[i]) == i);
+    for (auto it = map.cbegin(); it != map.cend(); ++it)
+      kept = kept && map.key_of(it) == keys[*it];
+
+    Check(visited == COUNT, "a scan that erases visits every element once");
+    Check(kept, "erasing during a scan keeps the other keys resolving to their values");
+  }
+
+  // A slot whose generation wraps is retired, so the key handed out for
+  // its first use, and every other key for it, stays stale
+  void GenerationWrap()
+  {
+    slot_map<u64> map;
+    const slot_map_key first = map.insert(0);
+    map.erase(first);
+
+    u64 reuses = 1;
+    slot_map_key key = map.insert(1);
+    while (key.index() == first.index())
+    {
+      map.erase(key);
+      key = map.insert(1);
+      ++reuses;
+    }
+
+    std::printf("slot_map: slot retired after %llu uses\n", static_cast<unsigned long long>(reuses));
+    Check(reuses == 1ULL << 31, "a slot is used 2^31 times before it is retired");
+    Check(IsStale(map, first), "the first key of a retired slot is stale");
+    Check(IsStale(map, slot_map_key{first.index(), 1}) && IsStale(map, slot_map_key{first.index(), u32_max}),
+          "no generation of a retired slot resolves");
+    Check(map.at(key) == 1, "the next insert gets a fresh slot");
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && std::strcmp(argv[1], "--wrap") == 0)
+  {
+    GenerationWrap();
+  }
+  else
+  {
+    StaleKeys();
+    AgainstUnorderedMap();
+    EraseDuringScan();
+  }
+
+  if (s_Failures)
+    std::fprintf(stderr, "%d checks failed\n", s_Failures);
+  return s_Failures ? 1 : 0;
+}
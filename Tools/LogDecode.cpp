@@ -0,0 +1,102 @@
+/**********************************************************************************
+* \brief  Prints binary logs written with LogFileFormat::Binary as text.
+*
+*           LogDecode app.log.2 app.log.1 app.log
+*
+*         Reads standard input when no file is given, so a log can be decoded
+*         while it is being written: tail -c +1 -f app.log | LogDecode
+**********************************************************************************/
+
+#include <Utils/LogBinary.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+  // Decodes after every read, however short, so a pipe from tail -f is
+  // printed as it arrives instead of once a full buffer has come in
+  bool DecodeStream(int input, const char *name)
+  {
+    constexpr size_t READ_SIZE = 1 << 20;
+
+    CustomSTL::LogBinaryDecoder decoder;
+    // Bytes [consumed, pendingSize) of pending are read but not decoded
+    std::vector<byte> pending(READ_SIZE);
+    std::string text;
+    size_t consumed = 0;
+    size_t pendingSize = 0;
+
+    for (;;)
+    {
+      // Only the unconsumed tail moves, and only when the free space at the
+      // end is too small for a full read
+      if (pending.size() - pendingSize < READ_SIZE)
+      {
+        if (consumed)
+        {
+          std::memmove(pending.data(), pending.data() + consumed, pendingSize - consumed);
+          pendingSize -= consumed;
+          consumed = 0;
+        }
+        if (pending.size() - pendingSize < READ_SIZE)
+          pending.resize(pendingSize + READ_SIZE);
+      }
+
+      ssize_t read = ::read(input, pending.data() + pendingSize, READ_SIZE);
+      if (read < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        fprintf(stderr, "LogDecode: cannot read %s: %s\n", name, strerror(errno));
+        return false;
+      }
+      if (read == 0)
+        break;
+      pendingSize += static_cast<size_t>(read);
+
+      text.clear();
+      consumed += decoder.Decode(std::span<const byte>(pending.data() + consumed, pendingSize - consumed), text);
+      fwrite(text.data(), 1, text.size(), stdout);
+      fflush(stdout);
+
+      if (decoder.Failed())
+      {
+        fprintf(stderr, "LogDecode: %s is corrupt or not a binary log\n", name);
+        return false;
+      }
+    }
+
+    if (pendingSize != consumed)
+      fprintf(stderr, "LogDecode: %s ends with a truncated record\n", name);
+    return true;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+    return DecodeStream(STDIN_FILENO, "standard input") ? 0 : 1;
+
+  int result = 0;
+  for (int i = 1; i < argc; ++i)
+  {
+    int input = open(argv[i], O_RDONLY | O_CLOEXEC);
+    if (input < 0)
+    {
+      fprintf(stderr, "LogDecode: cannot open %s\n", argv[i]);
+      result = 1;
+      continue;
+    }
+    if (!DecodeStream(input, argv[i]))
+      result = 1;
+    close(input);
+  }
+  return result;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Hint to the CPU that we are in a spin-wait loop. Frees pipeline resources
+// for the sibling hyper-thread and avoids the memory-order flush on exit.
+inline void CpuRelax()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
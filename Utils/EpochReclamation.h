@@ -0,0 +1,492 @@
+/**********************************************************************************
+* \brief  Deferred freeing for lock-free containers: epoch-based reclamation,
+*         and hazard pointers as the alternative.
+*
+*         A node unlinked from a lock-free structure cannot be deleted right
+*         away, another thread may still be reading it. Retire() takes the
+*         node and deletes it once no reader can reach it any more.
+*
+*           {
+*             EpochReclamation::Guard guard;       // readers pin the epoch
+*             Node *node = head.load(std::memory_order_acquire);
+*             ...                                  // node stays valid here
+*           }
+*           EpochReclamation::Retire(unlinked);    // writers retire
+*
+*         Epochs cost one store and one fence per Guard, whatever is read
+*         inside it, but a thread that stays pinned holds back every retired
+*         node in the process. Hazard pointers protect one pointer at a time,
+*         each protection costs a fence and a re-read, and a stalled thread
+*         only holds back the few nodes it protects. Use epochs for short
+*         read-side sections, hazard pointers when a reader may block.
+*
+*         Both keep a retire list per thread and free in batches. Lists left
+*         by exiting threads are handed over and freed by whoever reclaims
+*         next. The state is process wide and leaked, so any container can
+*         use it without owning anything.
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+#include <Utils/NonCopyable.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace CustomSTL
+{
+  // An object waiting to be freed and how to free it
+  struct RetiredObject
+  {
+    void *object;
+    void (*deleter)(void *);
+    u64 epoch;    // Global epoch when retired, unused by hazard pointers
+  };
+
+  namespace detail
+  {
+    // Frees the entries canFree accepts and keeps the rest. Lists merged
+    // from several threads are in no particular order, so every entry is
+    // tested.
+    template <typename CanFree>
+    size_t FreeRetired(std::vector<RetiredObject> &retired, CanFree &&canFree)
+    {
+      const auto kept = std::partition(retired.begin(), retired.end(),
+                                       [&canFree](const RetiredObject &entry) { return !canFree(entry); });
+      std::vector<RetiredObject> freeing(kept, retired.end());
+      retired.erase(kept, retired.end());
+      for (const RetiredObject &entry : freeing)
+        entry.deleter(entry.object);
+      return freeing.size();
+    }
+
+    // What every per-thread record has, Derived adds the scheme's fields
+    // and a Release() that clears them when the owning thread exits
+    template <typename Derived>
+    struct ThreadRecord
+    {
+      std::atomic<bool> inUse{true};
+      Derived *next = nullptr;                // Immutable once published
+      std::vector<RetiredObject> retired;     // Only touched by the owning thread
+    };
+
+    // The per-thread records of one reclamation scheme. The list only
+    // grows: a thread adopts a record an exited thread released or
+    // publishes a new one. An exiting thread's retire list becomes an
+    // orphan, freed by whoever collects next.
+    template <typename Record>
+    class ThreadRecords
+    {
+    public:
+      static Record &Local()
+      {
+        if (Record *record = s_Local) [[likely]]
+          return *record;
+        return Attach();
+      }
+
+      // True once the calling thread's record was released
+      static bool Exited()
+      {
+        return s_Exited;
+      }
+
+      static Record *Head()
+      {
+        return GetState().records.load(std::memory_order_acquire);
+      }
+
+      static size_t Count()
+      {
+        return GetState().count.load(std::memory_order_relaxed);
+      }
+
+      // For threads that retire after their record was released
+      static void Orphan(const RetiredObject &entry)
+      {
+        State &state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.orphans.push_back(entry);
+      }
+
+      // Frees what canFree accepts from the record's list and the orphans.
+      // Returns how many objects were freed.
+      template <typename CanFree>
+      static size_t Collect(Record &record, CanFree &&canFree)
+      {
+        State &state = GetState();
+
+        // Deleters may retire more objects, so the list is swapped out first
+        std::vector<RetiredObject> retired;
+        retired.swap(record.retired);
+        size_t freed = FreeRetired(retired, canFree);
+        retired.insert(retired.end(), record.retired.begin(), record.retired.end());
+        record.retired.swap(retired);
+
+        std::vector<RetiredObject> orphans;
+        {
+          std::unique_lock<std::mutex> lock(state.mutex, std::try_to_lock);
+          if (lock.owns_lock())
+            orphans.swap(state.orphans);
+        }
+        if (!orphans.empty())
+        {
+          freed += FreeRetired(orphans, canFree);
+          std::lock_guard<std::mutex> lock(state.mutex);
+          state.orphans.insert(state.orphans.end(), orphans.begin(), orphans.end());
+        }
+        return freed;
+      }
+
+    private:
+      struct State
+      {
+        alignas(64) std::atomic<Record *> records{nullptr};
+        std::atomic<size_t> count{0};
+        std::mutex mutex;
+        std::vector<RetiredObject> orphans;    // Left by exited threads
+      };
+
+      // Leaked, threads may retire while statics are destroyed
+      static State &GetState()
+      {
+        static State *state = new State;
+        return *state;
+      }
+
+      // Adopts the record of an exited thread, or publishes a new one
+      static Record *Acquire(State &state)
+      {
+        for (Record *record = state.records.load(std::memory_order_acquire); record; record = record->next)
+        {
+          bool free = false;
+          if (!record->inUse.load(std::memory_order_relaxed) &&
+              record->inUse.compare_exchange_strong(free, true, std::memory_order_acquire))
+            return record;
+        }
+
+        Record *record = new Record;
+        Record *head = state.records.load(std::memory_order_relaxed);
+        do
+          record->next = head;
+        while (!state.records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+        state.count.fetch_add(1, std::memory_order_relaxed);
+        return record;
+      }
+
+      [[gnu::noinline]] static Record &Attach()
+      {
+        State &state = GetState();
+
+        // A thread that already exited keeps the record it gets here, there
+        // is no thread_local left to release it
+        if (s_Exited)
+        {
+          s_Local = Acquire(state);
+          return *s_Local;
+        }
+
+        // Hands the retire list over and releases the record when the
+        // thread exits
+        struct Owner
+        {
+          Record *record;
+
+          explicit Owner(State &state) : record(Acquire(state)) {}
+
+          ~Owner()
+          {
+            State &state = GetState();
+            {
+              std::lock_guard<std::mutex> lock(state.mutex);
+              state.orphans.insert(state.orphans.end(), record->retired.begin(), record->retired.end());
+            }
+            record->retired.clear();
+            record->retired.shrink_to_fit();
+            record->Release();
+            record->inUse.store(false, std::memory_order_release);
+            s_Local = nullptr;
+            s_Exited = true;
+          }
+        };
+
+        static thread_local Owner owner(state);
+        s_Local = owner.record;
+        return *owner.record;
+      }
+
+      static inline thread_local Record *s_Local = nullptr;
+      static inline thread_local bool s_Exited = false;
+    };
+  }
+
+  class EpochReclamation
+  {
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t BATCH = 64;    // Retires between reclaim attempts
+
+    struct Record;
+    using Records = detail::ThreadRecords<Record>;
+
+  public:
+    // Pins the calling thread to the current epoch for its lifetime. Guards
+    // nest, only the outermost one pins.
+    class Guard : NonCopyable
+    {
+    public:
+      Guard()
+      {
+        Record &record = Records::Local();
+        if (record.nesting++ == 0)
+        {
+          record.state.store((GetState().epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+          // Orders the pin before every load the guard protects
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+      }
+
+      ~Guard()
+      {
+        Record &record = Records::Local();
+        if (--record.nesting == 0)
+          record.state.store(0, std::memory_order_release);
+      }
+    };
+
+    // Deletes object once no Guard that could have reached it is alive. It
+    // must already be unreachable for new readers.
+    template <typename T>
+    static void Retire(T *object)
+    {
+      Retire(object, [](void *pointer) { delete static_cast<T *>(pointer); });
+    }
+
+    static void Retire(void *object, void (*deleter)(void *))
+    {
+      // Orders the caller's unlink before the epoch load, so an epoch read
+      // here cannot predate a reader that can still reach object
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const u64 epoch = GetState().epoch.load(std::memory_order_acquire);
+      if (Records::Exited()) [[unlikely]]
+      {
+        Records::Orphan({object, deleter, epoch});
+        return;
+      }
+
+      Record &record = Records::Local();
+      record.retired.push_back({object, deleter, epoch});
+      if (record.retired.size() >= BATCH)
+        Collect(record);
+    }
+
+    // Tries to advance the epoch and frees what the calling thread retired
+    // that is now safe. Returns how many objects were freed.
+    static size_t Reclaim()
+    {
+      return Collect(Records::Local());
+    }
+
+    // Blocks until everything the calling thread retired so far, and every
+    // orphan, has been freed. Must not be called while holding a Guard.
+    static void Synchronize()
+    {
+      State &state = GetState();
+      Record &record = Records::Local();
+      if (record.nesting)
+        throw std::logic_error("EpochReclamation::Synchronize: called inside a Guard");
+
+      const u64 target = state.epoch.load(std::memory_order_acquire) + 2;
+      while (state.epoch.load(std::memory_order_acquire) < target)
+        if (!TryAdvance(state))
+          std::this_thread::yield();
+      Collect(record);
+    }
+
+    static u64 Epoch()
+    {
+      return GetState().epoch.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct alignas(CACHE_LINE) Record : detail::ThreadRecord<Record>
+    {
+      std::atomic<u64> state{0};          // (epoch << 1) | 1 while pinned, 0 otherwise
+      u32 nesting = 0;                    // Only touched by the owning thread
+
+      void Release()
+      {
+        nesting = 0;
+        state.store(0, std::memory_order_relaxed);
+      }
+    };
+
+    struct State
+    {
+      alignas(CACHE_LINE) std::atomic<u64> epoch{2};
+    };
+
+    // Leaked, threads may retire while statics are destroyed
+    static State &GetState()
+    {
+      static State *state = new State;
+      return *state;
+    }
+
+    // Advances the epoch if every pinned thread has seen the current one
+    static bool TryAdvance(State &state)
+    {
+      u64 epoch = state.epoch.load(std::memory_order_seq_cst);
+      for (Record *record = Records::Head(); record; record = record->next)
+      {
+        const u64 pinned = record->state.load(std::memory_order_seq_cst);
+        if ((pinned & 1) && (pinned >> 1) != epoch)
+          return false;
+      }
+      return state.epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    // An object retired in epoch e may be in use by a thread pinned in e,
+    // the epoch only reaches e + 2 once no such thread is left
+    static size_t Collect(Record &record)
+    {
+      State &state = GetState();
+      TryAdvance(state);
+      const u64 epoch = state.epoch.load(std::memory_order_acquire);
+      return Records::Collect(record, [epoch](const RetiredObject &entry) { return entry.epoch + 2 <= epoch; });
+    }
+  };
+
+  class HazardPointers
+  {
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr u32 SLOTS = 4;        // Guards one thread can hold at once
+    static constexpr size_t BATCH = 64;    // Least retires between scans
+
+    struct Record;
+    using Records = detail::ThreadRecords<Record>;
+
+  public:
+    // Owns one hazard slot of the calling thread. Whatever it protects is
+    // not freed until it protects something else or is destroyed.
+    class Guard : NonCopyable
+    {
+    public:
+      Guard() : m_Record(Records::Local())
+      {
+        const u32 free = ~m_Record.used & ((1u << SLOTS) - 1);
+        if (!free)
+          throw std::logic_error("HazardPointers::Guard: too many guards on one thread");
+        m_Slot = static_cast<u32>(std::countr_zero(free));
+        m_Record.used |= 1u << m_Slot;
+      }
+
+      ~Guard()
+      {
+        Reset();
+        m_Record.used &= ~(1u << m_Slot);
+      }
+
+      // Loads source and protects the pointer, retrying until the pointer
+      // is still in source after the protection was published
+      template <typename T>
+      T *Protect(const std::atomic<T *> &source)
+      {
+        T *pointer = source.load(std::memory_order_relaxed);
+        while (true)
+        {
+          m_Record.hazards[m_Slot].store(pointer, std::memory_order_seq_cst);
+          // seq_cst so the re-load cannot be satisfied before the hazard is
+          // visible to a reclaimer's scan
+          T *current = source.load(std::memory_order_seq_cst);
+          if (current == pointer)
+            return pointer;
+          pointer = current;
+        }
+      }
+
+      // Protects a pointer known to be alive, e.g. held by another guard
+      void Set(const void *pointer)
+      {
+        m_Record.hazards[m_Slot].store(pointer, std::memory_order_seq_cst);
+      }
+
+      void Reset()
+      {
+        m_Record.hazards[m_Slot].store(nullptr, std::memory_order_release);
+      }
+
+    private:
+      Record &m_Record;
+      u32 m_Slot;
+    };
+
+    // Deletes object once no Guard protects it. It must already be
+    // unreachable for new readers.
+    template <typename T>
+    static void Retire(T *object)
+    {
+      Retire(object, [](void *pointer) { delete static_cast<T *>(pointer); });
+    }
+
+    static void Retire(void *object, void (*deleter)(void *))
+    {
+      if (Records::Exited()) [[unlikely]]
+      {
+        Records::Orphan({object, deleter, 0});
+        return;
+      }
+
+      Record &record = Records::Local();
+      record.retired.push_back({object, deleter, 0});
+
+      // Scanning costs a pass over every hazard, so wait until the list
+      // is large compared to the number of hazards
+      const size_t threshold = std::max(BATCH, 2 * SLOTS * Records::Count());
+      if (record.retired.size() >= threshold)
+        Collect(record);
+    }
+
+    // Frees what the calling thread retired that no guard protects.
+    // Returns how many objects were freed.
+    static size_t Reclaim()
+    {
+      return Collect(Records::Local());
+    }
+
+  private:
+    struct alignas(CACHE_LINE) Record : detail::ThreadRecord<Record>
+    {
+      std::atomic<const void *> hazards[SLOTS] = {};
+      u32 used = 0;                       // Bit per slot held by a Guard, owner only
+
+      void Release()
+      {
+        used = 0;
+        for (std::atomic<const void *> &hazard : hazards)
+          hazard.store(nullptr, std::memory_order_relaxed);
+      }
+    };
+
+    static size_t Collect(Record &record)
+    {
+      // Pairs with the seq_cst store in Protect, a reader either sees the
+      // object unlinked or has its hazard seen here
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      std::vector<const void *> hazards;
+      for (Record *other = Records::Head(); other; other = other->next)
+        for (const std::atomic<const void *> &hazard : other->hazards)
+          if (const void *pointer = hazard.load(std::memory_order_acquire))
+            hazards.push_back(pointer);
+      std::sort(hazards.begin(), hazards.end());
+
+      return Records::Collect(record, [&hazards](const RetiredObject &entry) {
+        return !std::binary_search(hazards.begin(), hazards.end(), entry.object);
+      });
+    }
+  };
+}
@@ -0,0 +1,561 @@
+/**********************************************************************************
+* \brief  Counters, value histograms and scoped timers for hot paths.
+*
+*           INSTRUMENT_COUNT("Cache.Miss");
+*           INSTRUMENT_RECORD("Batch.Size", items.size());
+*           INSTRUMENT_SCOPE("Frame.Update");   // times the enclosing scope
+*
+*           std::string report = CustomSTL::Instrumentation::Snapshot().ToJson();
+*
+*         Every thread updates its own copy of each metric with plain relaxed
+*         stores, there are no shared cache lines and no read-modify-writes on
+*         the hot path. Snapshot() sums the copies of all live threads plus
+*         whatever exited threads left behind.
+*
+*         Histograms are log-linear, like HdrHistogram: 16 linear buckets per
+*         power of two, so any recorded value is reported within 1/16 (6.25%)
+*         of itself over the whole u64 range. Timers record time stamp counter
+*         ticks and are reported in nanoseconds.
+*
+*         Metrics are identified by name, every call site using the same name
+*         feeds the same metric. Building with INSTRUMENTATION_ENABLED=0
+*         removes every INSTRUMENT_* macro, including the ones in the
+*         containers, and their arguments are not evaluated.
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+#include <Utils/Tsc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef INSTRUMENTATION_ENABLED
+#define INSTRUMENTATION_ENABLED 1
+#endif
+
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+
+#if INSTRUMENTATION_ENABLED
+
+#define INSTRUMENT_ADD(name, value)                                                                 \
+  do                                                                                                \
+  {                                                                                                 \
+    static constinit ::CustomSTL::MetricSite metricSite_(name, ::CustomSTL::MetricKind::Counter);   \
+    ::CustomSTL::Instrumentation::Add(metricSite_, static_cast<u64>(value));                        \
+  } while (0)
+
+#define INSTRUMENT_RECORD(name, value)                                                              \
+  do                                                                                                \
+  {                                                                                                 \
+    static constinit ::CustomSTL::MetricSite metricSite_(name, ::CustomSTL::MetricKind::Histogram); \
+    ::CustomSTL::Instrumentation::Record(metricSite_, static_cast<u64>(value));                     \
+  } while (0)
+
+#define INSTRUMENT_SCOPE(name)                                                                     \
+  static constinit ::CustomSTL::MetricSite INSTRUMENT_CONCAT(metricSite_, __LINE__)(               \
+      name, ::CustomSTL::MetricKind::Timer);                                                       \
+  ::CustomSTL::ScopedTimer INSTRUMENT_CONCAT(scopedTimer_, __LINE__)(INSTRUMENT_CONCAT(metricSite_, __LINE__))
+
+#else
+
+#define INSTRUMENT_ADD(name, value) \
+  do                                \
+  {                                 \
+  } while (0)
+#define INSTRUMENT_RECORD(name, value) \
+  do                                   \
+  {                                    \
+  } while (0)
+#define INSTRUMENT_SCOPE(name) static_assert(true, "")
+
+#endif
+
+#define INSTRUMENT_COUNT(name) INSTRUMENT_ADD(name, 1)
+
+namespace CustomSTL
+{
+  enum class MetricKind : u8
+  {
+    Counter,    // A running total
+    Histogram,  // A distribution of recorded values
+    Timer       // A distribution of durations, recorded in ticks
+  };
+
+  // A place in the code that updates a metric. Its slot is looked up by
+  // name on first use.
+  struct MetricSite
+  {
+    constexpr MetricSite(const char *name, MetricKind kind) : name(name), kind(kind) {}
+
+    const char *const name;
+    const MetricKind kind;
+    std::atomic<u32> id{0};  // Slot + 1, 0 until first use
+  };
+
+  // Log-linear bucketing shared by the recorder and the snapshot
+  struct HistogramLayout
+  {
+    static constexpr unsigned SUB_BITS = 4;
+    static constexpr u64 SUB_COUNT = u64{1} << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    static constexpr size_t Index(u64 value)
+    {
+      if (value < SUB_COUNT)
+        return static_cast<size_t>(value);
+      const unsigned exponent = static_cast<unsigned>(std::bit_width(value)) - 1;
+      const u64 sub = (value >> (exponent - SUB_BITS)) & (SUB_COUNT - 1);
+      return static_cast<size_t>((exponent - SUB_BITS + 1) * SUB_COUNT + sub);
+    }
+
+    static constexpr u64 Lowest(size_t index)
+    {
+      if (index < SUB_COUNT)
+        return index;
+      const unsigned exponent = static_cast<unsigned>(index / SUB_COUNT) + SUB_BITS - 1;
+      return (SUB_COUNT + index % SUB_COUNT) << (exponent - SUB_BITS);
+    }
+
+    static constexpr u64 Highest(size_t index)
+    {
+      if (index < SUB_COUNT)
+        return index;
+      const unsigned exponent = static_cast<unsigned>(index / SUB_COUNT) + SUB_BITS - 1;
+      return Lowest(index) + ((u64{1} << (exponent - SUB_BITS)) - 1);
+    }
+  };
+
+  struct CounterSnapshot
+  {
+    std::string name;
+    u64 value = 0;
+  };
+
+  struct HistogramSnapshot
+  {
+    std::string name;
+    MetricKind kind = MetricKind::Histogram;
+    u64 count = 0;
+    double sum = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double scale = 1.0;         // Reported units per recorded unit
+    std::vector<u64> buckets;   // HistogramLayout::BUCKETS counts, unscaled
+
+    const char *Unit() const
+    {
+      return kind == MetricKind::Timer ? "ns" : "";
+    }
+
+    double Mean() const
+    {
+      return count ? sum / static_cast<double>(count) : 0.0;
+    }
+
+    // The value at or below which percentile% of the recorded values lie,
+    // rounded up to the end of its bucket
+    double Percentile(double percentile) const
+    {
+      if (!count)
+        return 0.0;
+      const double wanted = std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count));
+      const u64 target = std::max<u64>(1, static_cast<u64>(wanted));
+
+      u64 seen = 0;
+      for (size_t i = 0; i < buckets.size(); ++i)
+      {
+        seen += buckets[i];
+        if (seen >= target)
+          return std::clamp(static_cast<double>(HistogramLayout::Highest(i)) * scale, min, max);
+      }
+      return max;
+    }
+  };
+
+  struct InstrumentationSnapshot
+  {
+    std::vector<CounterSnapshot> counters;
+    std::vector<HistogramSnapshot> histograms;
+
+    // One metric per line, histograms with their mean and percentiles
+    std::string ToText() const
+    {
+      std::string out;
+      char line[256];
+      for (const CounterSnapshot &counter : counters)
+      {
+        std::snprintf(line, sizeof(line), "%-40s %llu\n", counter.name.c_str(),
+                      static_cast<unsigned long long>(counter.value));
+        out += line;
+      }
+      for (const HistogramSnapshot &histogram : histograms)
+      {
+        std::snprintf(line, sizeof(line),
+                      "%-40s count=%llu mean=%.4g p50=%.4g p90=%.4g p99=%.4g p99.9=%.4g max=%.4g%s%s\n",
+                      histogram.name.c_str(), static_cast<unsigned long long>(histogram.count), histogram.Mean(),
+                      histogram.Percentile(50), histogram.Percentile(90), histogram.Percentile(99),
+                      histogram.Percentile(99.9), histogram.max, *histogram.Unit() ? " " : "", histogram.Unit());
+        out += line;
+      }
+      return out;
+    }
+
+    std::string ToJson() const
+    {
+      auto quoted = [](std::string_view text) {
+        std::string out = "\"";
+        for (char c : text)
+        {
+          if (c == '"' || c == '\\')
+            out += '\\';
+          out += c;
+        }
+        return out + '"';
+      };
+
+      std::string out = "{\"counters\":{";
+      char number[64];
+      for (size_t i = 0; i < counters.size(); ++i)
+      {
+        std::snprintf(number, sizeof(number), ":%llu", static_cast<unsigned long long>(counters[i].value));
+        out += (i ? "," : "") + quoted(counters[i].name) + number;
+      }
+
+      out += "},\"histograms\":{";
+      for (size_t i = 0; i < histograms.size(); ++i)
+      {
+        const HistogramSnapshot &histogram = histograms[i];
+        char fields[512];
+        std::snprintf(fields, sizeof(fields),
+                      ":{\"unit\":\"%s\",\"count\":%llu,\"mean\":%.17g,\"min\":%.17g,\"p50\":%.17g,"
+                      "\"p90\":%.17g,\"p99\":%.17g,\"p999\":%.17g,\"max\":%.17g}",
+                      histogram.Unit(), static_cast<unsigned long long>(histogram.count), histogram.Mean(),
+                      histogram.min, histogram.Percentile(50), histogram.Percentile(90),
+                      histogram.Percentile(99), histogram.Percentile(99.9), histogram.max);
+        out += (i ? "," : "") + quoted(histogram.name) + fields;
+      }
+      return out + "}}";
+    }
+  };
+
+  class Instrumentation
+  {
+  public:
+    static constexpr u32 MAX_COUNTERS = 256;
+    static constexpr u32 MAX_HISTOGRAMS = 64;
+
+    static void Add(MetricSite &site, u64 value)
+    {
+      const u32 slot = Slot(site);
+      if (slot >= MAX_COUNTERS) [[unlikely]]
+        return;
+
+      if (ThreadMetrics *local = Local()) [[likely]]
+        Bump(local->counters[slot], value);
+      else
+        AddRetired(slot, value);
+    }
+
+    static void Record(MetricSite &site, u64 value)
+    {
+      const u32 slot = Slot(site);
+      if (slot >= MAX_HISTOGRAMS) [[unlikely]]
+        return;
+
+      ThreadMetrics *local = Local();
+      if (!local) [[unlikely]]
+      {
+        RecordRetired(slot, value);
+        return;
+      }
+      Cells *cells = local->histograms[slot].load(std::memory_order_relaxed);
+      if (!cells) [[unlikely]]
+      {
+        cells = new Cells;
+        local->histograms[slot].store(cells, std::memory_order_release);
+      }
+      cells->Record(value);
+    }
+
+    // Totals over every thread that has used a metric so far
+    static InstrumentationSnapshot Snapshot()
+    {
+      State &state = GetState();
+      std::lock_guard<std::mutex> lock(state.mutex);
+
+      TscCalibration calibration = state.calibration;
+      calibration.Refine();
+
+      InstrumentationSnapshot snapshot;
+      for (u32 slot = 0; slot < state.counters.size(); ++slot)
+      {
+        u64 total = Load(state.retired.counters[slot]);
+        for (const ThreadMetrics *thread : state.threads)
+          total += Load(thread->counters[slot]);
+        snapshot.counters.push_back({state.counters[slot].name, total});
+      }
+
+      for (u32 slot = 0; slot < state.histograms.size(); ++slot)
+      {
+        HistogramSnapshot histogram;
+        histogram.name = state.histograms[slot].name;
+        histogram.kind = state.histograms[slot].kind;
+        histogram.buckets.assign(HistogramLayout::BUCKETS, 0);
+        if (histogram.kind == MetricKind::Timer)
+          histogram.scale = 1.0 / calibration.ticksPerNanosecond;
+
+        u64 sum = 0, min = u64_max, max = 0;
+        auto add = [&](const Cells *cells) {
+          if (!cells)
+            return;
+          histogram.count += Load(cells->count);
+          sum += Load(cells->sum);
+          min = std::min(min, Load(cells->min));
+          max = std::max(max, Load(cells->max));
+          for (size_t i = 0; i < HistogramLayout::BUCKETS; ++i)
+            histogram.buckets[i] += Load(cells->buckets[i]);
+        };
+        add(state.retired.histograms[slot].load(std::memory_order_acquire));
+        for (const ThreadMetrics *thread : state.threads)
+          add(thread->histograms[slot].load(std::memory_order_acquire));
+
+        if (histogram.count)
+        {
+          histogram.sum = static_cast<double>(sum) * histogram.scale;
+          histogram.min = static_cast<double>(min) * histogram.scale;
+          histogram.max = static_cast<double>(max) * histogram.scale;
+        }
+        snapshot.histograms.push_back(std::move(histogram));
+      }
+      return snapshot;
+    }
+
+  private:
+    static constexpr u32 DISCARDED = u32_max;  // Site id once its table is full
+
+    // Written only by the owning thread, or under the state lock for the
+    // retired totals, read by Snapshot
+    static void Bump(std::atomic<u64> &cell, u64 value)
+    {
+      cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static u64 Load(const std::atomic<u64> &cell)
+    {
+      return cell.load(std::memory_order_relaxed);
+    }
+
+    struct Cells
+    {
+      std::atomic<u64> count{0};
+      std::atomic<u64> sum{0};
+      std::atomic<u64> min{u64_max};
+      std::atomic<u64> max{0};
+      std::atomic<u64> buckets[HistogramLayout::BUCKETS] = {};
+
+      void Record(u64 value)
+      {
+        Bump(count, 1);
+        Bump(sum, value);
+        if (value < Load(min))
+          min.store(value, std::memory_order_relaxed);
+        if (value > Load(max))
+          max.store(value, std::memory_order_relaxed);
+        Bump(buckets[HistogramLayout::Index(value)], 1);
+      }
+
+      // Folds another thread's cells into these, under the state lock
+      void Merge(const Cells &other)
+      {
+        Bump(count, Load(other.count));
+        Bump(sum, Load(other.sum));
+        min.store(std::min(Load(min), Load(other.min)), std::memory_order_relaxed);
+        max.store(std::max(Load(max), Load(other.max)), std::memory_order_relaxed);
+        for (size_t i = 0; i < HistogramLayout::BUCKETS; ++i)
+          Bump(buckets[i], Load(other.buckets[i]));
+      }
+    };
+
+    struct ThreadMetrics
+    {
+      std::atomic<u64> counters[MAX_COUNTERS] = {};
+      std::atomic<Cells *> histograms[MAX_HISTOGRAMS] = {};
+
+      ~ThreadMetrics()
+      {
+        for (std::atomic<Cells *> &cells : histograms)
+          delete cells.load(std::memory_order_relaxed);
+      }
+    };
+
+    struct Metric
+    {
+      std::string name;
+      MetricKind kind;
+    };
+
+    struct State
+    {
+      std::mutex mutex;
+      std::vector<Metric> counters;      // By slot
+      std::vector<Metric> histograms;    // By slot
+      std::vector<ThreadMetrics *> threads;
+      ThreadMetrics retired;             // What exited threads recorded
+      TscCalibration calibration;
+
+      State()
+      {
+        calibration.nanoseconds = TscCalibration::SystemNanoseconds();
+        calibration.tsc = ReadTsc();
+      }
+    };
+
+    // Leaked, threads may still record while statics are destroyed
+    static State &GetState()
+    {
+      static State *state = new State;
+      return *state;
+    }
+
+    static u32 Slot(MetricSite &site)
+    {
+      u32 id = site.id.load(std::memory_order_acquire);
+      if (!id) [[unlikely]]
+        id = Register(site);
+      return id == DISCARDED ? DISCARDED : id - 1;
+    }
+
+    [[gnu::noinline]] static u32 Register(MetricSite &site)
+    {
+      State &state = GetState();
+      std::lock_guard<std::mutex> lock(state.mutex);
+
+      const bool counter = site.kind == MetricKind::Counter;
+      std::vector<Metric> &metrics = counter ? state.counters : state.histograms;
+      const u32 capacity = counter ? MAX_COUNTERS : MAX_HISTOGRAMS;
+
+      u32 id = 0;
+      for (u32 slot = 0; slot < metrics.size() && !id; ++slot)
+        if (metrics[slot].name == site.name)
+          id = slot + 1;
+
+      if (!id && metrics.size() < capacity)
+      {
+        metrics.push_back({site.name, site.kind});
+        id = static_cast<u32>(metrics.size());
+      }
+      if (!id)
+        id = DISCARDED;
+
+      site.id.store(id, std::memory_order_release);
+      return id;
+    }
+
+    // The calling thread's metrics, nullptr once they have been retired
+    static ThreadMetrics *Local()
+    {
+      if (ThreadMetrics *metrics = s_Local) [[likely]]
+        return metrics;
+      return s_Exited ? nullptr : &Attach();
+    }
+
+    // Called with the state lock held
+    static Cells &RetiredCells(State &state, u32 slot)
+    {
+      Cells *cells = state.retired.histograms[slot].load(std::memory_order_relaxed);
+      if (!cells)
+      {
+        cells = new Cells;
+        state.retired.histograms[slot].store(cells, std::memory_order_release);
+      }
+      return *cells;
+    }
+
+    // Other thread_local destructors that run after the thread's metrics
+    // were retired add straight to the retired totals
+    [[gnu::noinline]] static void AddRetired(u32 slot, u64 value)
+    {
+      State &state = GetState();
+      std::lock_guard<std::mutex> lock(state.mutex);
+      Bump(state.retired.counters[slot], value);
+    }
+
+    [[gnu::noinline]] static void RecordRetired(u32 slot, u64 value)
+    {
+      State &state = GetState();
+      std::lock_guard<std::mutex> lock(state.mutex);
+      RetiredCells(state, slot).Record(value);
+    }
+
+    [[gnu::noinline]] static ThreadMetrics &Attach()
+    {
+      // Folds the thread's metrics into the retired totals when it exits
+      struct Owner
+      {
+        ThreadMetrics *metrics = new ThreadMetrics;
+
+        Owner()
+        {
+          State &state = GetState();
+          std::lock_guard<std::mutex> lock(state.mutex);
+          state.threads.push_back(metrics);
+        }
+
+        ~Owner()
+        {
+          State &state = GetState();
+          {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            for (u32 slot = 0; slot < MAX_COUNTERS; ++slot)
+              Bump(state.retired.counters[slot], Load(metrics->counters[slot]));
+            for (u32 slot = 0; slot < MAX_HISTOGRAMS; ++slot)
+            {
+              if (const Cells *cells = metrics->histograms[slot].load(std::memory_order_relaxed))
+                RetiredCells(state, slot).Merge(*cells);
+            }
+            std::erase(state.threads, metrics);
+          }
+          delete metrics;
+
+          s_Local = nullptr;
+          s_Exited = true;
+        }
+      };
+
+      static thread_local Owner owner;
+      s_Local = owner.metrics;
+      return *owner.metrics;
+    }
+
+    static inline thread_local ThreadMetrics *s_Local = nullptr;
+    static inline thread_local bool s_Exited = false;
+  };
+
+  // Records how long the enclosing scope took into a Timer metric
+  class ScopedTimer
+  {
+  public:
+    explicit ScopedTimer(MetricSite &site) : m_Site(site), m_Start(ReadTsc()) {}
+
+    ~ScopedTimer()
+    {
+      Instrumentation::Record(m_Site, ReadTsc() - m_Start);
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  private:
+    MetricSite &m_Site;
+    u64 m_Start;
+  };
+}
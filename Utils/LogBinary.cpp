@@ -0,0 +1,341 @@
+#include "LogBinary.h"
+
+#include <cstring>
+
+namespace CustomSTL
+{
+  namespace LogBinary
+  {
+    namespace
+    {
+      void PutTag(std::string &out, Tag tag)
+      {
+        out += static_cast<char>(tag);
+      }
+
+      void PutString(std::string &out, std::string_view text)
+      {
+        PutVarint(out, text.size());
+        out.append(text);
+      }
+
+      void PutRaw64(std::string &out, u64 bits)
+      {
+        char raw[sizeof(bits)];
+        std::memcpy(raw, &bits, sizeof(bits));
+        out.append(raw, sizeof(raw));
+      }
+
+      // Bounds checked reader over one buffer. A false return means the
+      // data ran out, unless corrupt was set.
+      struct Reader
+      {
+        const byte *at;
+        const byte *end;
+        bool corrupt = false;
+
+        bool Byte(u8 &value)
+        {
+          if (at == end)
+            return false;
+          value = static_cast<u8>(*at++);
+          return true;
+        }
+
+        bool Varint(u64 &value)
+        {
+          value = 0;
+          for (unsigned shift = 0; shift < 64; shift += 7)
+          {
+            u8 part;
+            if (!Byte(part))
+              return false;
+            value |= static_cast<u64>(part & 0x7F) << shift;
+            if (!(part & 0x80))
+              return true;
+          }
+          // No u64 needs more than 10 bytes, more data would not help
+          corrupt = true;
+          return false;
+        }
+
+        bool Raw64(u64 &value)
+        {
+          if (end - at < 8)
+            return false;
+          std::memcpy(&value, at, sizeof(value));
+          at += sizeof(value);
+          return true;
+        }
+
+        bool String(std::string &text)
+        {
+          u64 length;
+          if (!Varint(length) || static_cast<u64>(end - at) < length)
+            return false;
+          text.assign(reinterpret_cast<const char *>(at), static_cast<size_t>(length));
+          at += length;
+          return true;
+        }
+
+        bool Skip(size_t count)
+        {
+          if (static_cast<size_t>(end - at) < count)
+            return false;
+          at += count;
+          return true;
+        }
+      };
+    }
+
+    void PutVarint(std::string &out, u64 value)
+    {
+      char encoded[10];
+      size_t size = 0;
+      while (value >= 0x80)
+      {
+        encoded[size++] = static_cast<char>(value | 0x80);
+        value >>= 7;
+      }
+      encoded[size++] = static_cast<char>(value);
+      out.append(encoded, size);
+    }
+
+    void PutHeader(std::string &out)
+    {
+      PutTag(out, Tag::Header);
+      out.append(MAGIC, sizeof(MAGIC));
+      PutVarint(out, VERSION);
+    }
+
+    void PutCalibration(std::string &out, const TscCalibration &calibration)
+    {
+      PutTag(out, Tag::Calibration);
+      PutVarint(out, calibration.tsc);
+      PutVarint(out, calibration.nanoseconds);
+      u64 bits;
+      std::memcpy(&bits, &calibration.ticksPerNanosecond, sizeof(bits));
+      PutRaw64(out, bits);
+    }
+
+    void PutSite(std::string &out, u32 id, LogLevel level, u32 line,
+                 std::string_view format, std::string_view signature, std::string_view file)
+    {
+      PutTag(out, Tag::Site);
+      PutVarint(out, id);
+      PutVarint(out, static_cast<u64>(level));
+      PutVarint(out, line);
+      PutString(out, format);
+      PutString(out, signature);
+      PutString(out, file);
+    }
+
+    void PutThread(std::string &out, u32 threadId, u64 baseTsc)
+    {
+      PutTag(out, Tag::Thread);
+      PutVarint(out, threadId);
+      PutVarint(out, baseTsc);
+    }
+
+    void PutDropped(std::string &out, u32 threadId, u64 count)
+    {
+      PutTag(out, Tag::Dropped);
+      PutVarint(out, threadId);
+      PutVarint(out, count);
+    }
+
+    bool PutRecord(std::string &out, u32 siteId, i64 tscDelta, const char *signature,
+                   const byte *args, const byte *end)
+    {
+      PutTag(out, Tag::Record);
+      PutVarint(out, siteId);
+      PutVarint(out, ZigZag(tscDelta));
+
+      for (; *signature; ++signature)
+      {
+        const char code = *signature;
+        if (code == 'b' || code == 'c')
+        {
+          if (args == end)
+            return false;
+          out += static_cast<char>(*args++);
+          continue;
+        }
+
+        if (code == 's')
+        {
+          u32 length;
+          if (end - args < static_cast<ptrdiff>(sizeof(length)))
+            return false;
+          std::memcpy(&length, args, sizeof(length));
+          args += sizeof(length);
+          if (static_cast<size_t>(end - args) < length)
+            return false;
+          PutString(out, std::string_view(reinterpret_cast<const char *>(args), length));
+          args += length;
+          continue;
+        }
+
+        u64 bits;
+        if (end - args < static_cast<ptrdiff>(sizeof(bits)))
+          return false;
+        std::memcpy(&bits, args, sizeof(bits));
+        args += sizeof(bits);
+        if (code == 'i')
+          PutVarint(out, ZigZag(static_cast<i64>(bits)));
+        else if (code == 'd')
+          PutRaw64(out, bits);
+        else
+          PutVarint(out, bits);
+      }
+      return true;
+    }
+  }
+
+  size_t LogBinaryDecoder::Decode(std::span<const byte> data, std::string &out)
+  {
+    using namespace LogBinary;
+
+    LogBinary::Reader reader{data.data(), data.data() + data.size()};
+    const byte *entryStart = reader.at;
+
+    auto corrupt = [this] {
+      m_Failed = true;
+      return false;
+    };
+
+    // Parses one entry, false if it is incomplete or corrupt
+    auto entry = [&]() -> bool {
+      u8 tag;
+      if (!reader.Byte(tag))
+        return false;
+
+      switch (static_cast<Tag>(tag))
+      {
+      case Tag::Header:
+      {
+        u64 version;
+        if (static_cast<size_t>(reader.end - reader.at) < sizeof(MAGIC))
+          return false;
+        if (std::memcmp(reader.at, MAGIC, sizeof(MAGIC)) != 0)
+          return corrupt();
+        reader.at += sizeof(MAGIC);
+        if (!reader.Varint(version))
+          return false;
+        if (version != VERSION)
+          return corrupt();
+        m_Sites.clear();
+        return true;
+      }
+      case Tag::Calibration:
+      {
+        TscCalibration calibration;
+        u64 bits;
+        if (!reader.Varint(calibration.tsc) || !reader.Varint(calibration.nanoseconds) || !reader.Raw64(bits))
+          return false;
+        std::memcpy(&calibration.ticksPerNanosecond, &bits, sizeof(bits));
+        m_Calibration = calibration;
+        return true;
+      }
+      case Tag::Site:
+      {
+        u64 id, level, line;
+        Site site;
+        std::string file;
+        if (!reader.Varint(id) || !reader.Varint(level) || !reader.Varint(line) ||
+            !reader.String(site.format) || !reader.String(site.signature) || !reader.String(file))
+          return false;
+        if (!id || id > u32_max || level > static_cast<u64>(LogLevel::Off))
+          return corrupt();
+        site.level = static_cast<LogLevel>(level);
+        m_Sites[static_cast<u32>(id)] = std::move(site);
+        return true;
+      }
+      case Tag::Thread:
+      {
+        u64 threadId, baseTsc;
+        if (!reader.Varint(threadId) || !reader.Varint(baseTsc))
+          return false;
+        m_ThreadId = static_cast<u32>(threadId);
+        m_LastTsc = baseTsc;
+        return true;
+      }
+      case Tag::Dropped:
+      {
+        u64 threadId, count;
+        if (!reader.Varint(threadId) || !reader.Varint(count))
+          return false;
+        m_Prefix.Append(out, m_Calibration.ToNanoseconds(m_LastTsc), LogLevel::Warn, static_cast<u32>(threadId));
+        out += "logger dropped ";
+        out += std::to_string(count);
+        out += " records, the thread's buffer was full\n";
+        return true;
+      }
+      case Tag::Record:
+      {
+        u64 id, delta;
+        if (!reader.Varint(id) || !reader.Varint(delta))
+          return false;
+        const auto found = id <= u32_max ? m_Sites.find(static_cast<u32>(id)) : m_Sites.end();
+        if (found == m_Sites.end())
+          return corrupt();
+        const Site &site = found->second;
+
+        // Back to the in-memory layout FormatLogMessage reads
+        m_Args.clear();
+        for (char code : site.signature)
+        {
+          u64 value;
+          if (code == 'b' || code == 'c')
+          {
+            u8 single;
+            if (!reader.Byte(single))
+              return false;
+            m_Args += static_cast<char>(single);
+            continue;
+          }
+          if (code == 's')
+          {
+            if (!reader.Varint(value) || !reader.Skip(static_cast<size_t>(value)) || value > u32_max)
+              return false;
+            u32 length = static_cast<u32>(value);
+            m_Args.append(reinterpret_cast<const char *>(&length), sizeof(length));
+            m_Args.append(reinterpret_cast<const char *>(reader.at - length), length);
+            continue;
+          }
+          if (code == 'd' ? !reader.Raw64(value) : !reader.Varint(value))
+            return false;
+          if (code == 'i')
+            value = static_cast<u64>(UnZigZag(value));
+          m_Args.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        m_LastTsc += static_cast<u64>(UnZigZag(delta));
+        m_Prefix.Append(out, m_Calibration.ToNanoseconds(m_LastTsc), site.level, m_ThreadId);
+        const byte *args = reinterpret_cast<const byte *>(m_Args.data());
+        if (!FormatLogMessage(out, site.format, site.signature.c_str(), args, args + m_Args.size()))
+          out += " <corrupt record>";
+        out += '\n';
+        return true;
+      }
+      default:
+        return corrupt();
+      }
+    };
+
+    while (!m_Failed && reader.at != reader.end)
+    {
+      const size_t outSize = out.size();
+      if (!entry())
+      {
+        // Drop the partial text of an entry that could not be finished
+        out.resize(outSize);
+        if (reader.corrupt)
+          m_Failed = true;
+        break;
+      }
+      entryStart = reader.at;
+    }
+    return static_cast<size_t>(entryStart - data.data());
+  }
+}
@@ -0,0 +1,108 @@
+/**********************************************************************************
+* \brief  Compact binary log format, written by Logger with
+*         LogFileFormat::Binary and turned back into text offline by
+*         LogBinaryDecoder (see Tools/LogDecode.cpp).
+*
+*         A file is a sequence of entries, each a tag byte and a payload.
+*         Integers are LEB128 varints, signed ones zigzag encoded first.
+*
+*           Header       "CSTLLOG", version. Starts every file (and every
+*                        session appended to one), resets the site table.
+*           Calibration  tsc, nanoseconds, ticks per nanosecond (8 bytes)
+*           Site         id, level, line, format, signature, file. Emitted
+*                        once per file, before the first record using it.
+*           Thread       thread id, base tsc. Records that follow belong to
+*                        this thread.
+*           Record       site id, zigzag tsc delta from the previous record
+*                        (or the base), arguments.
+*           Dropped      thread id, count
+*
+*         Arguments follow the site's signature: b and c are one byte, i is
+*         a zigzag varint, u and p are varints, d is 8 raw bytes and s is a
+*         varint length followed by the characters.
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+#include <Utils/LogFormat.h>
+#include <Utils/Tsc.h>
+
+#include <span>
+#include <string>
+#include <unordered_map>
+
+namespace CustomSTL
+{
+  namespace LogBinary
+  {
+    inline constexpr char MAGIC[7] = {'C', 'S', 'T', 'L', 'L', 'O', 'G'};
+    inline constexpr u32 VERSION = 1;
+
+    enum class Tag : u8
+    {
+      Header = 1,
+      Calibration,
+      Site,
+      Thread,
+      Record,
+      Dropped
+    };
+
+    void PutVarint(std::string &out, u64 value);
+
+    inline u64 ZigZag(i64 value)
+    {
+      return (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63);
+    }
+
+    inline i64 UnZigZag(u64 value)
+    {
+      return static_cast<i64>(value >> 1) ^ -static_cast<i64>(value & 1);
+    }
+
+    void PutHeader(std::string &out);
+    void PutCalibration(std::string &out, const TscCalibration &calibration);
+    void PutSite(std::string &out, u32 id, LogLevel level, u32 line,
+                 std::string_view format, std::string_view signature, std::string_view file);
+    void PutThread(std::string &out, u32 threadId, u64 baseTsc);
+    void PutDropped(std::string &out, u32 threadId, u64 count);
+
+    // Transcodes a record whose arguments are in Logger's in-memory layout
+    // (see LogFormat.h). Returns false if the arguments ran past end.
+    bool PutRecord(std::string &out, u32 siteId, i64 tscDelta, const char *signature,
+                   const byte *args, const byte *end);
+  }
+
+  // Turns a binary log back into the text the logger would have written
+  class LogBinaryDecoder
+  {
+  public:
+    // Decodes whole entries from data and appends their text to out.
+    // Returns how many bytes were used, a trailing partial entry is left
+    // for the next call. Stops early on corrupt data, see Failed().
+    size_t Decode(std::span<const byte> data, std::string &out);
+
+    bool Failed() const
+    {
+      return m_Failed;
+    }
+
+  private:
+    struct Site
+    {
+      LogLevel level = LogLevel::Info;
+      std::string format;
+      std::string signature;
+    };
+
+    // Keyed by id rather than indexed, ids in a file can be sparse and a
+    // corrupt one must not size anything
+    std::unordered_map<u32, Site> m_Sites;
+    TscCalibration m_Calibration;
+    u32 m_ThreadId = 0;
+    u64 m_LastTsc = 0;
+    std::string m_Args;         // Arguments in the in-memory layout
+    LogLinePrefix m_Prefix;
+    bool m_Failed = false;
+  };
+}
@@ -0,0 +1,162 @@
+#include "LogFormat.h"
+
+#include <charconv>
+#include <ctime>
+
+namespace CustomSTL
+{
+  const char *LogLevelName(LogLevel level)
+  {
+    switch (level)
+    {
+    case LogLevel::Trace:
+      return "TRACE";
+    case LogLevel::Debug:
+      return "DEBUG";
+    case LogLevel::Info:
+      return "INFO ";
+    case LogLevel::Warn:
+      return "WARN ";
+    case LogLevel::Error:
+      return "ERROR";
+    case LogLevel::Critical:
+      return "CRIT ";
+    default:
+      return "OFF  ";
+    }
+  }
+
+  namespace
+  {
+    template <typename T>
+    void AppendNumber(std::string &out, T value, int base = 10)
+    {
+      char text[32];
+      std::to_chars_result result;
+      if constexpr (std::is_floating_point_v<T>)
+        result = std::to_chars(text, text + sizeof(text), value);
+      else
+        result = std::to_chars(text, text + sizeof(text), value, base);
+      out.append(text, result.ptr);
+    }
+
+    // Appends the argument at args and advances past it
+    bool AppendArg(std::string &out, char code, const byte *&args, const byte *end)
+    {
+      size_t size = (code == 'b' || code == 'c') ? 1 : code == 's' ? sizeof(u32) : 8;
+      if (static_cast<size_t>(end - args) < size)
+        return false;
+
+      if (code == 'b' || code == 'c')
+      {
+        char value = static_cast<char>(*args++);
+        if (code == 'b')
+          out += value ? "true" : "false";
+        else
+          out += value;
+        return true;
+      }
+
+      if (code == 's')
+      {
+        u32 length;
+        std::memcpy(&length, args, sizeof(length));
+        args += sizeof(length);
+        if (static_cast<size_t>(end - args) < length)
+          return false;
+        out.append(reinterpret_cast<const char *>(args), length);
+        args += length;
+        return true;
+      }
+
+      u64 bits;
+      std::memcpy(&bits, args, sizeof(bits));
+      args += sizeof(bits);
+      switch (code)
+      {
+      case 'i':
+        AppendNumber(out, static_cast<i64>(bits));
+        break;
+      case 'u':
+        AppendNumber(out, bits);
+        break;
+      case 'd':
+      {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        AppendNumber(out, value);
+        break;
+      }
+      case 'p':
+        out += "0x";
+        AppendNumber(out, bits, 16);
+        break;
+      default:
+        return false;
+      }
+      return true;
+    }
+  }
+
+  void LogLinePrefix::Append(std::string &out, u64 nanoseconds, LogLevel level, u32 threadId)
+  {
+    i64 seconds = static_cast<i64>(nanoseconds / 1000000000);
+    if (seconds != m_Second)
+    {
+      time_t time = static_cast<time_t>(seconds);
+      tm utc;
+      gmtime_r(&time, &utc);
+      strftime(m_Date, sizeof(m_Date), "%Y-%m-%dT%H:%M:%S", &utc);
+      m_Second = seconds;
+    }
+    char micros[8];
+    u32 fraction = static_cast<u32>(nanoseconds % 1000000000 / 1000);
+    micros[0] = '.';
+    for (int digit = 6; digit > 0; --digit, fraction /= 10)
+      micros[digit] = static_cast<char>('0' + fraction % 10);
+    micros[7] = 'Z';
+    out += m_Date;
+    out.append(micros, sizeof(micros));
+
+    out += ' ';
+    out += LogLevelName(level);
+    out += " [T";
+    AppendNumber(out, threadId);
+    out += "] ";
+  }
+
+  bool FormatLogMessage(std::string &out, std::string_view format, const char *signature,
+                        const byte *args, const byte *end)
+  {
+    size_t i = 0;
+    while (i < format.size())
+    {
+      size_t brace = format.find_first_of("{}", i);
+      if (brace == std::string_view::npos)
+      {
+        out.append(format.substr(i));
+        break;
+      }
+      out.append(format.substr(i, brace - i));
+      i = brace;
+
+      char c = format[i];
+      if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c)
+      {
+        out += c;
+        i += 2;
+        continue;
+      }
+      if (c == '{' && i + 1 < format.size() && format[i + 1] == '}' && *signature)
+      {
+        if (!AppendArg(out, *signature++, args, end))
+          return false;
+        i += 2;
+        continue;
+      }
+      out += c;
+      ++i;
+    }
+    return true;
+  }
+}
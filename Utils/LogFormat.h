@@ -0,0 +1,161 @@
+/**********************************************************************************
+* \brief  How Logger captures arguments and turns them back into text.
+*
+*         A log call does not format anything. Each argument is copied into the
+*         record as raw bytes, and the call site's signature, one type code per
+*         argument, says how to read them back. FormatLogMessage then replaces
+*         each {} in the format string with the next argument, on the logger's
+*         background thread or offline.
+*
+*         Type codes: b bool, c char, i signed integer (8 bytes), u unsigned
+*         integer (8 bytes), d floating point (8 bytes), p pointer (8 bytes),
+*         s string (u32 length then the characters).
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace CustomSTL
+{
+  enum class LogLevel : u8
+  {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Critical,
+    Off
+  };
+
+  // Fixed width name, e.g. "INFO "
+  const char *LogLevelName(LogLevel level);
+
+  template <typename T>
+  constexpr char LogArgCode()
+  {
+    using U = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<U, bool>)
+      return 'b';
+    else if constexpr (std::is_same_v<U, char>)
+      return 'c';
+    else if constexpr (std::is_enum_v<U>)
+      return LogArgCode<std::underlying_type_t<U>>();
+    else if constexpr (std::is_integral_v<U>)
+      return std::is_signed_v<U> ? 'i' : 'u';
+    else if constexpr (std::is_floating_point_v<U>)
+      return 'd';
+    else if constexpr (std::is_null_pointer_v<U>)
+      return 's';
+    else if constexpr (std::is_convertible_v<const U &, std::string_view>)
+      return 's';
+    else if constexpr (std::is_pointer_v<U>)
+      return 'p';
+    else
+      static_assert(!sizeof(U), "Type cannot be logged, convert it to a string or number first");
+  }
+
+  // Signature of a call site, Args are the decayed argument types
+  template <typename... Args>
+  inline constexpr char LogSignature[] = {LogArgCode<Args>()..., '\0'};
+
+  // nullptr and null C strings are logged as "(null)", string_view cannot
+  // be made from them
+  template <typename T>
+  std::string_view LogArgString(const T &value)
+  {
+    if constexpr (std::is_null_pointer_v<T>)
+      return "(null)";
+    else if constexpr (std::is_pointer_v<T>)
+      return value ? std::string_view(value) : std::string_view("(null)");
+    else
+      return std::string_view(value);
+  }
+
+  // Bytes the argument takes in a record
+  template <typename T>
+  size_t LogArgSize(const T &value)
+  {
+    constexpr char code = LogArgCode<T>();
+    if constexpr (code == 'b' || code == 'c')
+      return 1;
+    else if constexpr (code == 's')
+      return sizeof(u32) + LogArgString(value).size();
+    else
+      return 8;
+  }
+
+  // Copies the argument to out and advances it
+  template <typename T>
+  void LogArgWrite(byte *&out, const T &value)
+  {
+    using U = std::remove_cvref_t<T>;
+    constexpr char code = LogArgCode<T>();
+    if constexpr (code == 'b' || code == 'c')
+    {
+      *out++ = static_cast<byte>(value);
+    }
+    else if constexpr (code == 's')
+    {
+      std::string_view text = LogArgString(value);
+      u32 length = static_cast<u32>(text.size());
+      std::memcpy(out, &length, sizeof(length));
+      std::memcpy(out + sizeof(length), text.data(), length);
+      out += sizeof(length) + length;
+    }
+    else
+    {
+      u64 bits;
+      if constexpr (code == 'd')
+      {
+        double widened = static_cast<double>(value);
+        std::memcpy(&bits, &widened, sizeof(bits));
+      }
+      else if constexpr (code == 'p')
+        bits = reinterpret_cast<uptr>(value);
+      else if constexpr (std::is_enum_v<U>)
+        bits = static_cast<u64>(static_cast<std::underlying_type_t<U>>(value));
+      else
+        bits = static_cast<u64>(value);
+      std::memcpy(out, &bits, sizeof(bits));
+      out += sizeof(bits);
+    }
+  }
+
+  // Writes the "2026-01-02T03:04:05.123456Z INFO  [T3] " start of a line.
+  // The date part is cached per second, keep one instance per writer.
+  class LogLinePrefix
+  {
+  public:
+    void Append(std::string &out, u64 nanoseconds, LogLevel level, u32 threadId);
+
+  private:
+    i64 m_Second = -1;
+    char m_Date[32] = {};
+  };
+
+  /**************************************************************************/
+  /*!
+    \brief	Appends a message to out, replacing each {} in format with the
+            next argument. {{ and }} print a single brace. Placeholders past
+            the last argument are kept as they are.
+
+    \param	out: string to append to
+
+    \param	format: the call site's format string
+
+    \param	signature: the call site's argument type codes
+
+    \param	args, end: the record's argument bytes
+
+    \return	false if the arguments ran past end, the record is corrupt
+  */
+  /**************************************************************************/
+  bool FormatLogMessage(std::string &out, std::string_view format, const char *signature,
+                        const byte *args, const byte *end);
+}
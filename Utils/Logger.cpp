@@ -0,0 +1,549 @@
+#include "Logger.h"
+#include <Utils/CpuRelax.h>
+#include <Utils/LogBinary.h>
+
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CustomSTL
+{
+  namespace
+  {
+    struct SiteInfo
+    {
+      const char *format;
+      const char *signature;
+      const char *file;
+      u32 line;
+      LogLevel level;
+    };
+
+    struct LoggerState
+    {
+      std::mutex sitesMutex;
+      std::vector<SiteInfo> sites;  // Site id - 1
+
+      std::mutex buffersMutex;
+      std::vector<SharedPtr<Logger::ThreadBuffer>> buffers;
+      std::atomic<u64> buffersVersion{0};
+      u32 nextThreadId = 0;
+      size_t bufferBytes = 1 << 20;
+
+      std::mutex wakeMutex;
+      std::condition_variable wake;
+      std::condition_variable flushed;
+      u64 flushRequested = 0;
+      u64 flushCompleted = 0;
+      bool stopping = false;
+
+      std::atomic<bool> running{false};
+      std::chrono::milliseconds pollInterval{1};
+      LogFileFormat format = LogFileFormat::Text;
+      TscCalibration calibration;
+      UniquePtr<LogSink> sink;
+      std::thread thread;
+    };
+
+    // Leaked on purpose, threads may exit after static destruction
+    LoggerState &State()
+    {
+      static LoggerState *state = new LoggerState();
+      return *state;
+    }
+
+    // Writes every chunk, retrying on partial writes and interrupts
+    void WriteAll(int fd, const iovec *chunks, int count)
+    {
+      std::vector<iovec> pending(chunks, chunks + count);
+      iovec *next = pending.data();
+      int left = count;
+      while (left > 0)
+      {
+        ssize_t written = writev(fd, next, left < IOV_MAX ? left : IOV_MAX);
+        if (written < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return;
+        }
+        while (left > 0 && static_cast<size_t>(written) >= next->iov_len)
+        {
+          written -= static_cast<ssize_t>(next->iov_len);
+          ++next;
+          --left;
+        }
+        if (left > 0)
+        {
+          next->iov_base = static_cast<char *>(next->iov_base) + written;
+          next->iov_len -= static_cast<size_t>(written);
+        }
+      }
+    }
+
+    class Writer
+    {
+    public:
+      explicit Writer(LoggerState &state)
+          : m_State(state), m_Binary(state.format == LogFileFormat::Binary),
+            m_Calibration(state.calibration), m_LastRefine(TscCalibration::SystemNanoseconds()) {}
+
+      // Writes everything in the rings, returns false if there was nothing
+      // to do
+      bool Drain()
+      {
+        RefreshBuffers();
+        RefineCalibration();
+        if (m_Texts.size() < m_Buffers.size())
+          m_Texts.resize(m_Buffers.size());
+
+        m_Chunks.clear();
+        m_BatchSites.clear();
+        ++m_Batch;
+        bool closedAny = false;
+        size_t bytes = 0;
+        for (size_t i = 0; i < m_Buffers.size(); ++i)
+        {
+          std::string &text = m_Texts[i];
+          text.clear();
+          Logger::ThreadBuffer &buffer = *m_Buffers[i];
+          bool closed = buffer.closed.load(std::memory_order_acquire);
+          Format(buffer, text);
+          if (!text.empty())
+          {
+            m_Chunks.push_back({text.data(), text.size()});
+            bytes += text.size();
+          }
+          closedAny |= closed && buffer.ring.IsEmpty();
+        }
+
+        if (!m_Chunks.empty())
+        {
+          u64 segment = m_State.sink->BeginBatch(bytes);
+          if (m_Binary && Prelude(segment))
+            m_Chunks.insert(m_Chunks.begin(), {m_Prelude.data(), m_Prelude.size()});
+          m_State.sink->Write(m_Chunks.data(), static_cast<int>(m_Chunks.size()));
+        }
+        if (closedAny)
+          RemoveClosed();
+        return !m_Chunks.empty();
+      }
+
+    private:
+      static constexpr u64 REFINE_INTERVAL = 1000000000;  // Nanoseconds
+
+      LoggerState &m_State;
+      const bool m_Binary;
+      std::vector<SharedPtr<Logger::ThreadBuffer>> m_Buffers;
+      u64 m_BuffersVersion = ~0ULL;
+      std::vector<SiteInfo> m_Sites;
+      std::vector<std::string> m_Texts;  // One per buffer, reused
+      std::vector<iovec> m_Chunks;
+      LogLinePrefix m_Prefix;
+
+      TscCalibration m_Calibration;
+      u64 m_LastRefine;
+      bool m_CalibrationChanged = true;
+
+      // Binary mode: sites used in this batch and in which file each site
+      // was last defined
+      std::string m_Prelude;
+      std::vector<u32> m_BatchSites;
+      std::vector<u64> m_SiteBatch;
+      std::vector<u64> m_SiteFile;
+      u64 m_Batch = 0;
+      u64 m_File = 0;
+      u64 m_Segment = ~0ULL;
+
+      void RefreshBuffers()
+      {
+        if (m_State.buffersVersion.load(std::memory_order_acquire) == m_BuffersVersion)
+          return;
+        std::lock_guard<std::mutex> lock(m_State.buffersMutex);
+        m_Buffers = m_State.buffers;
+        m_BuffersVersion = m_State.buffersVersion.load(std::memory_order_relaxed);
+      }
+
+      void RemoveClosed()
+      {
+        std::lock_guard<std::mutex> lock(m_State.buffersMutex);
+        std::erase_if(m_State.buffers, [](const SharedPtr<Logger::ThreadBuffer> &buffer) {
+          return buffer->closed.load(std::memory_order_acquire) && buffer->ring.IsEmpty();
+        });
+        m_State.buffersVersion.fetch_add(1, std::memory_order_release);
+      }
+
+      // The rate measured at Start spans a few milliseconds, measuring it
+      // again over a longer span keeps late timestamps accurate
+      void RefineCalibration()
+      {
+        u64 now = TscCalibration::SystemNanoseconds();
+        if (now - m_LastRefine < REFINE_INTERVAL)
+          return;
+        m_Calibration.Refine();
+        m_LastRefine = now;
+        m_CalibrationChanged = true;
+      }
+
+      const SiteInfo *Site(u32 id)
+      {
+        if (id > m_Sites.size())
+        {
+          std::lock_guard<std::mutex> lock(m_State.sitesMutex);
+          m_Sites = m_State.sites;
+          m_SiteBatch.resize(m_Sites.size(), 0);
+          m_SiteFile.resize(m_Sites.size(), 0);
+        }
+        return id && id <= m_Sites.size() ? &m_Sites[id - 1] : nullptr;
+      }
+
+      void Format(Logger::ThreadBuffer &buffer, std::string &text)
+      {
+        std::span<const byte> data = buffer.ring.ReadSpan();
+        size_t offset = 0;
+        u64 lastTsc = 0;
+        while (data.size() - offset >= sizeof(Logger::RecordHeader))
+        {
+          Logger::RecordHeader header;
+          std::memcpy(&header, data.data() + offset, sizeof(header));
+          const byte *args = data.data() + offset + sizeof(header);
+          const byte *end = data.data() + offset + header.size;
+          offset += header.size;
+
+          const SiteInfo *site = Site(header.siteId);
+          if (!site)
+            continue;
+
+          if (!m_Binary)
+          {
+            m_Prefix.Append(text, m_Calibration.ToNanoseconds(header.timestamp), site->level, buffer.threadId);
+            if (!FormatLogMessage(text, site->format, site->signature, args, end))
+              text += " <corrupt record>";
+            text += '\n';
+            continue;
+          }
+
+          if (text.empty())
+          {
+            LogBinary::PutThread(text, buffer.threadId, header.timestamp);
+            lastTsc = header.timestamp;
+          }
+          if (m_SiteBatch[header.siteId - 1] != m_Batch)
+          {
+            m_SiteBatch[header.siteId - 1] = m_Batch;
+            m_BatchSites.push_back(header.siteId);
+          }
+          LogBinary::PutRecord(text, header.siteId, static_cast<i64>(header.timestamp - lastTsc),
+                               site->signature, args, end);
+          lastTsc = header.timestamp;
+        }
+        buffer.ring.Consume(offset);
+
+        if (u64 dropped = buffer.dropped.exchange(0, std::memory_order_relaxed))
+        {
+          if (m_Binary)
+          {
+            if (text.empty())
+              LogBinary::PutThread(text, buffer.threadId, ReadTsc());
+            LogBinary::PutDropped(text, buffer.threadId, dropped);
+            return;
+          }
+          m_Prefix.Append(text, TscCalibration::SystemNanoseconds(), LogLevel::Warn, buffer.threadId);
+          text += "logger dropped ";
+          text += std::to_string(dropped);
+          text += " records, the thread's buffer was full\n";
+        }
+      }
+
+      // Builds what must precede this batch's records in a binary file: the
+      // header when the sink started a new file, the calibration when it
+      // changed and the sites not defined in this file yet. Returns false
+      // if nothing is needed.
+      bool Prelude(u64 segment)
+      {
+        m_Prelude.clear();
+        if (segment != m_Segment)
+        {
+          m_Segment = segment;
+          ++m_File;
+          LogBinary::PutHeader(m_Prelude);
+          m_CalibrationChanged = true;
+        }
+        if (m_CalibrationChanged)
+        {
+          LogBinary::PutCalibration(m_Prelude, m_Calibration);
+          m_CalibrationChanged = false;
+        }
+        for (u32 id : m_BatchSites)
+        {
+          if (m_SiteFile[id - 1] == m_File)
+            continue;
+          m_SiteFile[id - 1] = m_File;
+          const SiteInfo &site = m_Sites[id - 1];
+          LogBinary::PutSite(m_Prelude, id, site.level, site.line, site.format, site.signature, site.file);
+        }
+        return !m_Prelude.empty();
+      }
+    };
+
+    void Run(LoggerState &state)
+    {
+      Writer writer(state);
+      for (;;)
+      {
+        u64 flushTicket;
+        bool stopping;
+        {
+          std::lock_guard<std::mutex> lock(state.wakeMutex);
+          flushTicket = state.flushRequested;
+          stopping = state.stopping;
+        }
+
+        bool wrote = writer.Drain();
+
+        if (flushTicket != state.flushCompleted)
+        {
+          state.sink->Flush();
+          std::lock_guard<std::mutex> lock(state.wakeMutex);
+          state.flushCompleted = flushTicket;
+          state.flushed.notify_all();
+        }
+        // Stop was seen before the drain, so everything logged before Stop
+        // has been written
+        if (stopping)
+          break;
+
+        if (!wrote)
+        {
+          std::unique_lock<std::mutex> lock(state.wakeMutex);
+          state.wake.wait_for(lock, state.pollInterval, [&] {
+            return state.stopping || state.flushRequested != flushTicket;
+          });
+        }
+      }
+      state.sink->Flush();
+    }
+  }
+
+  void ConsoleSink::Write(const iovec *chunks, int count)
+  {
+    WriteAll(m_Fd, chunks, count);
+  }
+
+  FileSink::FileSink(std::string path, size_t maxBytes, unsigned maxFiles)
+      : m_Path(std::move(path)), m_MaxBytes(maxBytes), m_MaxFiles(maxFiles)
+  {
+    Open(false);
+  }
+
+  FileSink::~FileSink()
+  {
+    if (m_Fd >= 0)
+      close(m_Fd);
+  }
+
+  void FileSink::Open(bool truncate)
+  {
+    m_Fd = open(m_Path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND), 0644);
+    if (m_Fd < 0)
+      throw std::system_error(errno, std::generic_category(), "FileSink: open " + m_Path);
+
+    struct stat info;
+    m_Written = fstat(m_Fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    ++m_Segment;
+  }
+
+  void FileSink::Rotate()
+  {
+    close(m_Fd);
+    m_Fd = -1;
+    if (m_MaxFiles)
+    {
+      for (unsigned i = m_MaxFiles - 1; i > 0; --i)
+        rename((m_Path + '.' + std::to_string(i)).c_str(), (m_Path + '.' + std::to_string(i + 1)).c_str());
+      rename(m_Path.c_str(), (m_Path + ".1").c_str());
+    }
+    // Errors cannot be reported from the logger thread, keep logging to
+    // the old file if the new one cannot be opened
+    try
+    {
+      Open(true);
+    }
+    catch (const std::system_error &)
+    {
+      m_Fd = open((m_Path + ".1").c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+  }
+
+  u64 FileSink::BeginBatch(size_t bytes)
+  {
+    if (m_MaxBytes && m_Written && m_Written + bytes > m_MaxBytes)
+      Rotate();
+    return m_Segment;
+  }
+
+  void FileSink::Write(const iovec *chunks, int count)
+  {
+    if (m_Fd < 0)
+      return;
+
+    size_t bytes = 0;
+    for (int i = 0; i < count; ++i)
+      bytes += chunks[i].iov_len;
+    WriteAll(m_Fd, chunks, count);
+    m_Written += bytes;
+  }
+
+  void FileSink::Flush()
+  {
+    if (m_Fd >= 0)
+      fdatasync(m_Fd);
+  }
+
+  void Logger::Start(UniquePtr<LogSink> sink, const LoggerOptions &options)
+  {
+    LoggerState &state = State();
+    if (state.running.load(std::memory_order_acquire))
+      throw std::logic_error("Logger: already started");
+
+    {
+      std::lock_guard<std::mutex> lock(state.buffersMutex);
+      state.bufferBytes = options.threadBufferBytes;
+    }
+    state.sink = std::move(sink);
+    state.pollInterval = options.pollInterval;
+    state.format = options.format;
+    state.calibration = TscCalibration::Measure(std::chrono::milliseconds(2));
+    state.stopping = false;
+    state.flushRequested = state.flushCompleted = 0;
+    s_Overflow.store(options.overflow, std::memory_order_relaxed);
+
+    state.running.store(true, std::memory_order_release);
+    state.thread = std::thread(Run, std::ref(state));
+    s_Level.store(options.level, std::memory_order_relaxed);
+  }
+
+  void Logger::Stop()
+  {
+    LoggerState &state = State();
+    if (!state.running.load(std::memory_order_acquire))
+      return;
+
+    s_Level.store(LogLevel::Off, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(state.wakeMutex);
+      state.stopping = true;
+    }
+    state.wake.notify_one();
+    state.thread.join();
+
+    state.running.store(false, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(state.wakeMutex);
+      state.flushed.notify_all();
+    }
+    state.sink.reset();
+  }
+
+  void Logger::Flush()
+  {
+    LoggerState &state = State();
+    std::unique_lock<std::mutex> lock(state.wakeMutex);
+    if (!state.running.load(std::memory_order_acquire) || state.stopping)
+      return;
+
+    u64 ticket = ++state.flushRequested;
+    state.wake.notify_one();
+    state.flushed.wait(lock, [&] {
+      return state.flushCompleted >= ticket || !state.running.load(std::memory_order_acquire);
+    });
+  }
+
+  u32 Logger::Register(LogSite &site, const char *signature)
+  {
+    LoggerState &state = State();
+    std::lock_guard<std::mutex> lock(state.sitesMutex);
+    if (u32 id = site.id.load(std::memory_order_relaxed))
+      return id;
+
+    state.sites.push_back({site.format, signature, site.file, site.line, site.level});
+    u32 id = static_cast<u32>(state.sites.size());
+    site.id.store(id, std::memory_order_release);
+    return id;
+  }
+
+  Logger::ThreadBuffer *Logger::AttachThread()
+  {
+    // Trivially destructible, so it can still be read after the thread's
+    // destructors have run
+    static thread_local bool exited = false;
+
+    // Marks the ring closed when the thread exits, the logger thread frees
+    // it once it is drained
+    struct Owner
+    {
+      ThreadBuffer *buffer = nullptr;
+      ~Owner()
+      {
+        s_Buffer = nullptr;
+        exited = true;
+        if (buffer)
+          buffer->closed.store(true, std::memory_order_release);
+      }
+    };
+
+    // Logging from a later thread_local destructor would attach a ring
+    // that is never closed, drop the record instead
+    if (exited) [[unlikely]]
+    {
+      s_Dropped.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    static thread_local Owner owner;
+
+    LoggerState &state = State();
+    std::lock_guard<std::mutex> lock(state.buffersMutex);
+    auto buffer = MakeShared<ThreadBuffer>(state.bufferBytes, state.nextThreadId++);
+    state.buffers.push_back(buffer);
+    state.buffersVersion.fetch_add(1, std::memory_order_release);
+
+    owner.buffer = buffer.get();
+    s_Buffer = owner.buffer;
+    return s_Buffer;
+  }
+
+  std::span<byte> Logger::WaitForSpace(ThreadBuffer &buffer, size_t size)
+  {
+    LoggerState &state = State();
+    if (size <= buffer.ring.Capacity() && s_Overflow.load(std::memory_order_relaxed) == LogOverflow::Block)
+    {
+      for (unsigned spin = 0; state.running.load(std::memory_order_acquire); ++spin)
+      {
+        std::span<byte> space = buffer.ring.WriteSpan();
+        if (space.size() >= size)
+          return space;
+        if (spin < 64)
+        {
+          CpuRelax();
+        }
+        else
+        {
+          state.wake.notify_one();
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    s_Dropped.fetch_add(1, std::memory_order_relaxed);
+    return {};
+  }
+}
@@ -0,0 +1,260 @@
+/**********************************************************************************
+* \brief  Asynchronous logger. The calling thread only copies a call site id,
+*         a timestamp and the raw arguments into its own single-producer ring,
+*         no formatting and no I/O. A background thread drains every ring,
+*         formats the records and hands them to the sink in one writev.
+*
+*         Levels are filtered twice: calls below LOG_ACTIVE_LEVEL are removed
+*         at compile time, the rest check the runtime level first.
+*
+*           CustomSTL::Logger::Start(MakeUnique<CustomSTL::FileSink>("app.log"));
+*           LOG_INFO("request {} took {} us", id, micros);
+*
+*         Records from one thread are written in order. Records from different
+*         threads are written one ring at a time, so they may interleave out
+*         of timestamp order within a batch.
+*
+*         Timestamps are raw time stamp counter reads, converted to wall clock
+*         time by the logger thread. With LogFileFormat::Binary the records are
+*         not formatted at all but transcoded to the compact format described
+*         in LogBinary.h, and Tools/LogDecode turns such files back into text.
+*
+*         Linux only, the rings are MappedRingBuffers.
+**********************************************************************************/
+
+#pragma once
+#include <Containers/MappedRingBuffer.h>
+#include <Types/Base.h>
+#include <Utils/LogFormat.h>
+#include <Utils/Tsc.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <sys/uio.h>
+
+// Calls below this level are compiled out, 0 keeps everything down to Trace
+#ifndef LOG_ACTIVE_LEVEL
+#define LOG_ACTIVE_LEVEL 0
+#endif
+
+#define LOG_AT(level, format, ...)                                                          \
+  do                                                                                        \
+  {                                                                                         \
+    if constexpr (::CustomSTL::LogLevelCompiled(level))                                     \
+    {                                                                                       \
+      if (::CustomSTL::Logger::ShouldLog(level))                                            \
+      {                                                                                     \
+        static constinit ::CustomSTL::LogSite logSite_(level, format, __FILE__, __LINE__); \
+        ::CustomSTL::Logger::Write(logSite_ __VA_OPT__(, ) __VA_ARGS__);                   \
+      }                                                                                     \
+    }                                                                                       \
+  } while (0)
+
+#define LOG_TRACE(format, ...) LOG_AT(::CustomSTL::LogLevel::Trace, format __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_DEBUG(format, ...) LOG_AT(::CustomSTL::LogLevel::Debug, format __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_INFO(format, ...) LOG_AT(::CustomSTL::LogLevel::Info, format __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_WARN(format, ...) LOG_AT(::CustomSTL::LogLevel::Warn, format __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_ERROR(format, ...) LOG_AT(::CustomSTL::LogLevel::Error, format __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_CRITICAL(format, ...) LOG_AT(::CustomSTL::LogLevel::Critical, format __VA_OPT__(, ) __VA_ARGS__)
+
+namespace CustomSTL
+{
+  constexpr bool LogLevelCompiled(LogLevel level)
+  {
+    constexpr int activeLevel = LOG_ACTIVE_LEVEL;
+    return static_cast<int>(level) >= activeLevel;
+  }
+
+  // A log statement. Its id is handed out on the first call that passes
+  // the level checks.
+  struct LogSite
+  {
+    constexpr LogSite(LogLevel level, const char *format, const char *file, u32 line)
+        : level(level), format(format), file(file), line(line) {}
+
+    const LogLevel level;
+    const char *const format;
+    const char *const file;
+    const u32 line;
+    std::atomic<u32> id{0};
+  };
+
+  // Where formatted text goes. Only called from the logger thread.
+  class LogSink
+  {
+  public:
+    virtual ~LogSink() = default;
+
+    // Called before each Write with its size. Returns a number that
+    // changes whenever the sink starts a new file, so the logger knows to
+    // repeat the binary header and site table.
+    virtual u64 BeginBatch(size_t bytes)
+    {
+      (void)bytes;
+      return 0;
+    }
+
+    virtual void Write(const iovec *chunks, int count) = 0;
+    virtual void Flush() {}
+  };
+
+  // Writes to standard output or another open descriptor
+  class ConsoleSink : public LogSink
+  {
+  public:
+    explicit ConsoleSink(int fd = 1) : m_Fd(fd) {}
+
+    void Write(const iovec *chunks, int count) override;
+
+  private:
+    int m_Fd;
+  };
+
+  // Appends to a file. With a maximum size the file is rotated before a
+  // batch that would grow it past the limit: app.log becomes app.log.1,
+  // app.log.1 becomes app.log.2 and so on, keeping at most maxFiles old
+  // files. A batch is never split across files.
+  class FileSink : public LogSink
+  {
+  public:
+    explicit FileSink(std::string path, size_t maxBytes = 0, unsigned maxFiles = 5);
+    ~FileSink() override;
+
+    u64 BeginBatch(size_t bytes) override;
+    void Write(const iovec *chunks, int count) override;
+    void Flush() override;
+
+  private:
+    std::string m_Path;
+    size_t m_MaxBytes;
+    unsigned m_MaxFiles;
+    size_t m_Written = 0;
+    u64 m_Segment = 0;      // Files opened so far
+    int m_Fd = -1;
+
+    void Open(bool truncate);
+    void Rotate();
+  };
+
+  // What a thread does when its ring is full
+  enum class LogOverflow
+  {
+    Drop,  // Discard the record, a count of dropped records is logged later
+    Block  // Wait for the logger thread to make room
+  };
+
+  enum class LogFileFormat
+  {
+    Text,   // Formatted lines
+    Binary  // LogBinary records, decoded offline
+  };
+
+  struct LoggerOptions
+  {
+    LogLevel level = LogLevel::Info;
+    LogOverflow overflow = LogOverflow::Drop;
+    LogFileFormat format = LogFileFormat::Text;
+    size_t threadBufferBytes = 1 << 20;                  // Ring size per thread
+    std::chrono::milliseconds pollInterval{1};           // Idle sleep of the logger thread
+  };
+
+  class Logger
+  {
+  public:
+    // Starts the background thread, throws if it is already running
+    static void Start(UniquePtr<LogSink> sink, const LoggerOptions &options = {});
+
+    // Writes everything logged so far and stops the background thread
+    static void Stop();
+
+    // Returns once everything this thread logged before the call is written
+    static void Flush();
+
+    static void SetLevel(LogLevel level)
+    {
+      s_Level.store(level, std::memory_order_relaxed);
+    }
+
+    static LogLevel GetLevel()
+    {
+      return s_Level.load(std::memory_order_relaxed);
+    }
+
+    static bool ShouldLog(LogLevel level)
+    {
+      return level >= s_Level.load(std::memory_order_relaxed);
+    }
+
+    // Total records discarded because a ring was full
+    static u64 Dropped()
+    {
+      return s_Dropped.load(std::memory_order_relaxed);
+    }
+
+    // Captures one record, called by the LOG_ macros
+    template <typename... Args>
+    static void Write(LogSite &site, const Args &...args)
+    {
+      u32 id = site.id.load(std::memory_order_acquire);
+      if (!id) [[unlikely]]
+        id = Register(site, LogSignature<std::decay_t<Args>...>);
+
+      const size_t size = sizeof(RecordHeader) + (LogArgSize(args) + ... + size_t(0));
+      ThreadBuffer *buffer = s_Buffer;
+      if (!buffer) [[unlikely]]
+      {
+        buffer = AttachThread();
+        if (!buffer)
+          return;
+      }
+
+      std::span<byte> space = buffer->ring.WriteSpan();
+      if (space.size() < size) [[unlikely]]
+      {
+        space = WaitForSpace(*buffer, size);
+        if (space.empty())
+          return;
+      }
+
+      RecordHeader header{static_cast<u32>(size), id, ReadTsc()};
+      byte *out = space.data();
+      std::memcpy(out, &header, sizeof(header));
+      out += sizeof(header);
+      (LogArgWrite(out, args), ...);
+      buffer->ring.Commit(size);
+    }
+
+    struct RecordHeader
+    {
+      u32 size;       // Whole record, header included
+      u32 siteId;
+      u64 timestamp;  // ReadTsc
+    };
+
+    struct ThreadBuffer
+    {
+      explicit ThreadBuffer(size_t bytes, u32 threadId) : ring(bytes), threadId(threadId) {}
+
+      MappedRingBuffer<byte> ring;
+      const u32 threadId;
+      std::atomic<u64> dropped{0};    // Not reported yet
+      std::atomic<bool> closed{false}; // The thread has exited
+    };
+
+  private:
+    static inline std::atomic<LogLevel> s_Level{LogLevel::Off};
+    static inline std::atomic<LogOverflow> s_Overflow{LogOverflow::Drop};
+    static inline std::atomic<u64> s_Dropped{0};
+
+    // Constant initialized, so reading it needs no TLS init wrapper
+    static inline thread_local ThreadBuffer *s_Buffer = nullptr;
+
+    static u32 Register(LogSite &site, const char *signature);
+    // Returns nullptr once the calling thread's thread_local destructors
+    // have started, the record is then counted as dropped
+    static ThreadBuffer *AttachThread();
+    static std::span<byte> WaitForSpace(ThreadBuffer &buffer, size_t size);
+  };
+}
@@ -1,4 +1,24 @@
 #include "Random.h"
 
-std::mt19937 Random::s_RandomEngine;
-std::uniform_int_distribution<std::mt19937::result_type> Random::s_Distribution;
+std::atomic<u64> Random::s_MasterSeed{0};
+std::atomic<u64> Random::s_Generation{1};
+std::atomic<u64> Random::s_ThreadCount{0};
+
+void Random::Reseed(u64 generation)
+{
+  // Handed out indices start at the top bit so they never match one given
+  // to SetThreadIndex
+  if (!s_State.indexed)
+  {
+    s_State.index = (1ULL << 63) | s_ThreadCount.fetch_add(1, std::memory_order_relaxed);
+    s_State.indexed = true;
+  }
+
+  // Mix the thread index in through SplitMix so neighbouring threads get
+  // unrelated engine states
+  SplitMix64 mix(s_MasterSeed.load(std::memory_order_relaxed));
+  u64 seed = mix() ^ (s_State.index * 0x9E3779B97F4A7C15ULL);
+  s_State.engine.seed(SplitMix64(seed)());
+  s_State.lanes.seed(s_State.engine);
+  s_State.generation = generation;
+}
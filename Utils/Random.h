@@ -1,10 +1,129 @@
 #pragma once
+#include <Utils/RandomEngines.h>
+#include <Utils/RandomSimd.h>
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <random>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+// Engine used by Random, any class from RandomEngines.h or another
+// UniformRandomBitGenerator with a seed(u64) member and a constexpr
+// default constructor
+#ifndef RANDOM_ENGINE
+#define RANDOM_ENGINE Xoshiro256ss
+#endif
+
+/******************************************************************************/
+/*!
+  \brief	An independent, reproducible random sequence picked by a seed and
+          a stream id, made by Random::Stream. Setting one up is O(1), so a
+          parallel job can give every task (rather than every thread) its own
+          stream and produce the same results on any number of threads.
+*/
+/******************************************************************************/
+class RandomStream
+{
+public:
+  using result_type = Philox4x32::result_type;
+
+  RandomStream(u64 seed, u64 streamId) : m_Engine(seed, streamId) {}
+
+  static constexpr result_type min() { return Philox4x32::min(); }
+  static constexpr result_type max() { return Philox4x32::max(); }
+
+  result_type operator()() { return m_Engine(); }
+
+  // Skips count 64 bit outputs in constant time
+  void Discard(u64 count) { m_Engine.discard(count); }
+
+  // Returns a float in [0, 1)
+  float Float()
+  {
+    return static_cast<float>(m_Engine() >> 40) * 0x1.0p-24f;
+  }
+
+  // Returns a float between min and max
+  float FloatRange(float min, float max)
+  {
+    return min + Float() * (max - min);
+  }
+
+  // Returns an unsigned in [min, max), min if the range is empty
+  unsigned UIntRange(unsigned min, unsigned max)
+  {
+    if (max <= min)
+      return min;
+    return min + Bounded(max - min);
+  }
 
+  // Returns an int in [min, max), min if the range is empty
+  int IntRange(int min, int max)
+  {
+    if (max <= min)
+      return min;
+    return static_cast<int>(static_cast<u32>(min) + Bounded(static_cast<u32>(max) - static_cast<u32>(min)));
+  }
+
+  // Fills a buffer with floats between min and max
+  void Fill(std::span<float> out, float min, float max)
+  {
+    for (float &value : out)
+      value = FloatRange(min, max);
+  }
+
+  // Fills a buffer with unsigned numbers in [lo, hi), all lo if the range
+  // is empty, like UIntRange
+  void Fill(std::span<u32> out, u32 lo, u32 hi)
+  {
+    if (hi <= lo)
+    {
+      std::fill(out.begin(), out.end(), lo);
+      return;
+    }
+    for (u32 &value : out)
+      value = UIntRange(lo, hi);
+  }
+
+private:
+  Philox4x32 m_Engine;
+
+  // Lemire's multiply-shift reduction to [0, range)
+  u32 Bounded(u32 range)
+  {
+    u64 product = static_cast<u64>(static_cast<u32>(m_Engine() >> 32)) * range;
+    if (static_cast<u32>(product) < range) [[unlikely]]
+    {
+      const u32 threshold = static_cast<u32>(-range) % range;
+      while (static_cast<u32>(product) < threshold)
+        product = static_cast<u64>(static_cast<u32>(m_Engine() >> 32)) * range;
+    }
+    return static_cast<u32>(product >> 32);
+  }
+};
+
+/******************************************************************************/
+/*!
+  \brief	Static random number interface.
+          Every thread draws from its own engine, so calls never race and
+          never contend. Each thread's engine is seeded from the master seed
+          and the thread's index. A thread that calls SetThreadIndex gets the
+          same sequence for the same seed and index on every run. Otherwise
+          the index is handed out on the thread's first call, in whatever
+          order the threads get there, so only a single threaded run is
+          reproducible. Use Stream for results that must not depend on
+          threads at all.
+*/
+/******************************************************************************/
 class Random
 {
 public:
+  using Engine = RANDOM_ENGINE;
+
   /**************************************************************************/
   /*!
     \brief	Call this function at the start of the game.
@@ -12,23 +131,41 @@ public:
   /**************************************************************************/
   static void Init()
   {
-    unsigned seed = static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count());
-    s_RandomEngine.seed(seed);
+    Seed(0);
   }
 
   /**************************************************************************/
   /*!
-    \brief	Changes the seed
+    \brief	Changes the master seed. Every thread reseeds its engine on its
+            next call.
 
     \param	seed: the seed to change to, 0 means random seed
   */
   /**************************************************************************/
   static void Seed(unsigned seed = 0)
   {
+    u64 master = seed;
     if (!seed)
-      seed = static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count());
+      master = static_cast<u64>(std::chrono::system_clock::now().time_since_epoch().count());
+
+    s_MasterSeed.store(master, std::memory_order_relaxed);
+    s_Generation.fetch_add(1, std::memory_order_release);
+  }
 
-    s_RandomEngine.seed(seed);
+  /**************************************************************************/
+  /*!
+    \brief	Gives the calling thread a fixed index, e.g. its worker number,
+            and reseeds its engine from the master seed and that index.
+            Threads that share an index share a sequence.
+
+    \param	index: the thread's index
+  */
+  /**************************************************************************/
+  static void SetThreadIndex(u64 index)
+  {
+    s_State.index = index;
+    s_State.indexed = true;
+    Reseed(s_Generation.load(std::memory_order_acquire));
   }
 
   /**************************************************************************/
@@ -38,8 +175,8 @@ public:
   /**************************************************************************/
   static float RandomFloat()
   {
-    static std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
-    return static_cast<float>(distribution(s_RandomEngine));
+    // Top 24 bits fill the float mantissa exactly, result is in [0, 1)
+    return static_cast<float>(GetEngine()() >> 40) * 0x1.0p-24f;
   }
 
   /**************************************************************************/
@@ -54,7 +191,9 @@ public:
   /**************************************************************************/
   static unsigned RandomUIntRange(unsigned min, unsigned max)
   {
-    return static_cast<unsigned>(min + (RandomFloat() * (max - min)));
+    if (max <= min)
+      return min;
+    return min + Bounded(static_cast<u32>(GetEngine()() >> 32), max - min);
   }
 
   /**************************************************************************/
@@ -69,7 +208,10 @@ public:
   /**************************************************************************/
   static int RandomIntRange(int min, int max)
   {
-    return static_cast<int>(min + (RandomFloat() * (max - min)));
+    if (max <= min)
+      return min;
+    u32 range = static_cast<u32>(max) - static_cast<u32>(min);
+    return static_cast<int>(static_cast<u32>(min) + Bounded(static_cast<u32>(GetEngine()() >> 32), range));
   }
 
   /**************************************************************************/
@@ -86,8 +228,302 @@ public:
     return (min + (RandomFloat() * (max - min)));
   }
 
+  /**************************************************************************/
+  /*!
+    \brief	Fills a buffer with floats between a range, from several
+            engine lanes stepped together with SIMD
+
+    \param	out: the buffer to fill
+
+    \param	min: mininum number in the range
+
+    \param	max: maximum number in the range
+  */
+  /**************************************************************************/
+  static void Fill(std::span<float> out, float min, float max)
+  {
+    const float scale = (max - min) * 0x1.0p-24f;
+    FillBits(out.size(), [&](size_t i, u32 bits) {
+      out[i] = min + static_cast<float>(bits >> 8) * scale;
+    });
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Fills a buffer with unbiased unsigned numbers between a range.
+            Example lo = 0, hi = 3. Numbers given would be 0,1,2
+            Uses Lemire's nearly divisionless method, a division is only
+            needed for a tiny fraction of draws.
+
+    \param	out: the buffer to fill
+
+    \param	lo: mininum number in the range
+
+    \param	hi: maximum number in the range. If hi <= lo the range is empty
+                and every number is lo, like RandomUIntRange.
+  */
+  /**************************************************************************/
+  static void Fill(std::span<u32> out, u32 lo, u32 hi)
+  {
+    if (hi <= lo)
+    {
+      std::fill(out.begin(), out.end(), lo);
+      return;
+    }
+    const u32 range = hi - lo;
+    const u32 threshold = static_cast<u32>(-range) % range;
+    FillBits(out.size(), [&](size_t i, u32 bits) {
+      u64 product = static_cast<u64>(bits) * range;
+      while (static_cast<u32>(product) < threshold) [[unlikely]]
+        product = static_cast<u64>(static_cast<u32>(GetEngine()() >> 32)) * range;
+      out[i] = lo + static_cast<u32>(product >> 32);
+    });
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Fills a buffer with normally distributed floats (Box-Muller)
+
+    \param	out: the buffer to fill
+
+    \param	mean: mean of the distribution
+
+    \param	stddev: standard deviation of the distribution
+  */
+  /**************************************************************************/
+  static void FillNormal(std::span<float> out, float mean, float stddev)
+  {
+    constexpr float TWO_PI = 6.28318530717958647692f;
+    auto transform = [&](u32 bits1, u32 bits2, float &cosine, float &sine) {
+      float u1 = static_cast<float>((bits1 >> 8) + 1) * 0x1.0p-24f;
+      float u2 = static_cast<float>(bits2 >> 8) * 0x1.0p-24f;
+      float radius = stddev * std::sqrt(-2.0f * std::log(u1));
+      cosine = mean + radius * std::cos(TWO_PI * u2);
+      sine = mean + radius * std::sin(TWO_PI * u2);
+    };
+
+    // Pairs of draws give pairs of outputs, an odd tail takes one more draw
+    const size_t pairs = out.size() & ~size_t(1);
+    u32 first = 0;
+    FillBits(pairs, [&](size_t i, u32 bits) {
+      if (i & 1)
+        transform(first, bits, out[i - 1], out[i]);
+      else
+        first = bits;
+    });
+    if (pairs != out.size())
+    {
+      float unused;
+      u64 bits = GetEngine()();
+      transform(static_cast<u32>(bits >> 32), static_cast<u32>(bits), out[pairs], unused);
+    }
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Fills a buffer with exponentially distributed floats
+
+    \param	out: the buffer to fill
+
+    \param	lambda: rate of the distribution
+  */
+  /**************************************************************************/
+  static void FillExponential(std::span<float> out, float lambda)
+  {
+    const float scale = -1.0f / lambda;
+    FillBits(out.size(), [&](size_t i, u32 bits) {
+      float u = static_cast<float>((bits >> 8) + 1) * 0x1.0p-24f;
+      out[i] = scale * std::log(u);
+    });
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Shuffles a buffer uniformly (Fisher-Yates). Two swap positions
+            are drawn from each 64 bit number, halving the engine calls.
+
+    \param	items: the buffer to shuffle
+  */
+  /**************************************************************************/
+  template <typename T>
+  static void Shuffle(std::span<T> items)
+  {
+    using std::swap;
+    u64 remaining = items.size();
+    // A pair of ranges must multiply within 64 bits to share a draw
+    for (; remaining > (1ULL << 32); --remaining)
+      swap(items[remaining - 1], items[Bounded64(remaining)]);
+    for (; remaining > 1; remaining -= 2)
+    {
+      u64 first, second;
+      BoundedPair(remaining, remaining - 1, first, second);
+      swap(items[remaining - 1], items[first]);
+      swap(items[remaining - 2], items[second]);
+    }
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Picks k distinct numbers out of [0, n) with Floyd's algorithm,
+            k draws whatever the size of n. The order of the result is not
+            uniformly random, Shuffle it if that matters.
+
+    \param	out: receives the k = out.size() numbers
+
+    \param	n: size of the range to pick from
+  */
+  /**************************************************************************/
+  static void SampleWithoutReplacement(std::span<u32> out, u32 n)
+  {
+    const u32 k = static_cast<u32>(out.size());
+    if (out.size() > n)
+      throw std::invalid_argument("Random::SampleWithoutReplacement: k is larger than n");
+
+    // Small samples check membership by scanning what was picked so far
+    constexpr u32 SCAN_LIMIT = 64;
+    std::unordered_set<u32> picked;
+    if (k > SCAN_LIMIT)
+      picked.reserve(k);
+
+    for (u32 i = 0, j = n - k; i < k; ++i, ++j)
+    {
+      u32 candidate = Bounded(static_cast<u32>(GetEngine()() >> 32), j + 1);
+      bool taken;
+      if (k > SCAN_LIMIT)
+        taken = !picked.insert(candidate).second;
+      else
+        taken = std::find(out.begin(), out.begin() + i, candidate) != out.begin() + i;
+      if (taken)
+      {
+        candidate = j;
+        if (k > SCAN_LIMIT)
+          picked.insert(j);
+      }
+      out[i] = candidate;
+    }
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Makes an independent stream that does not depend on the master
+            seed or on which thread asks for it. The same seed and stream id
+            always give the same sequence.
+
+    \param	seed: seed shared by all streams of one run
+
+    \param	streamId: picks the stream, e.g. a task or particle index
+  */
+  /**************************************************************************/
+  static RandomStream Stream(u64 seed, u64 streamId)
+  {
+    return RandomStream(seed, streamId);
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Returns the calling thread's engine, for use with <random>
+            distributions or bulk generation
+  */
+  /**************************************************************************/
+  static Engine &GetEngine()
+  {
+    u64 generation = s_Generation.load(std::memory_order_acquire);
+    if (s_State.generation != generation) [[unlikely]]
+      Reseed(generation);
+    return s_State.engine;
+  }
+
 private:
-  //Mersenne Twister 19937 generator
-  static std::mt19937 s_RandomEngine;
-  static std::uniform_int_distribution<std::mt19937::result_type> s_Distribution;
+  using Lanes = Xoshiro256ssLanes<8>;
+
+  struct ThreadState
+  {
+    Engine engine;
+    Lanes lanes;         // Bulk generator, seeded from engine
+    u64 generation = 0;  // 0 means never seeded
+    u64 index = 0;       // From SetThreadIndex or the thread's first call
+    bool indexed = false;
+  };
+
+  static thread_local ThreadState s_State;
+
+  static std::atomic<u64> s_MasterSeed;
+  static std::atomic<u64> s_Generation;
+  static std::atomic<u64> s_ThreadCount;
+
+  static void Reseed(u64 generation);
+
+  static Lanes &GetLanes()
+  {
+    GetEngine();
+    return s_State.lanes;
+  }
+
+  // Lemire's multiply-shift reduction of a 32 bit draw to [0, range)
+  static u32 Bounded(u32 bits, u32 range)
+  {
+    u64 product = static_cast<u64>(bits) * range;
+    if (static_cast<u32>(product) < range) [[unlikely]]
+    {
+      const u32 threshold = static_cast<u32>(-range) % range;
+      while (static_cast<u32>(product) < threshold)
+        product = static_cast<u64>(static_cast<u32>(GetEngine()() >> 32)) * range;
+    }
+    return static_cast<u32>(product >> 32);
+  }
+
+  // 64 bit version of Bounded, for ranges beyond 32 bits
+  static u64 Bounded64(u64 range)
+  {
+    Engine &engine = GetEngine();
+    u64 hi;
+    u64 lo = Multiply128(engine(), range, hi);
+    if (lo < range) [[unlikely]]
+    {
+      const u64 threshold = (0 - range) % range;
+      while (lo < threshold)
+        lo = Multiply128(engine(), range, hi);
+    }
+    return hi;
+  }
+
+  // Brackett-Bivens and Lemire's batched reduction: first in [0, range1)
+  // and second in [0, range2) from one draw. range1 * range2 must fit in
+  // 64 bits.
+  static void BoundedPair(u64 range1, u64 range2, u64 &first, u64 &second)
+  {
+    Engine &engine = GetEngine();
+    const u64 bound = range1 * range2;
+    u64 leftover = Multiply128(Multiply128(engine(), range1, first), range2, second);
+    if (leftover < bound) [[unlikely]]
+    {
+      const u64 threshold = (0 - bound) % bound;
+      while (leftover < threshold)
+        leftover = Multiply128(Multiply128(engine(), range1, first), range2, second);
+    }
+  }
+
+  // Calls store(index, 32 random bits) for every index below count,
+  // drawing the bits a block of lanes at a time
+  template <typename Store>
+  static void FillBits(size_t count, Store &&store)
+  {
+    Lanes &lanes = GetLanes();
+    u64 block[Lanes::LANES];
+    size_t i = 0;
+    while (i < count)
+    {
+      lanes.Next(block);
+      for (size_t lane = 0; lane < Lanes::LANES && i < count; ++lane)
+      {
+        store(i++, static_cast<u32>(block[lane] >> 32));
+        if (i < count)
+          store(i++, static_cast<u32>(block[lane]));
+      }
+    }
+  }
 };
+
+// Defined here rather than in Random.cpp so the hot path reads it directly
+// instead of through a TLS wrapper call
+inline thread_local Random::ThreadState Random::s_State;
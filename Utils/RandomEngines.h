@@ -0,0 +1,346 @@
+#pragma once
+#include <Types/Base.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/******************************************************************************/
+/*!
+  \brief  Small, fast pseudo random engines used by Random.
+          All of them satisfy UniformRandomBitGenerator, so they can also be
+          used with the <random> distributions, and all have constexpr default
+          constructors so thread_local instances need no guard.
+*/
+/******************************************************************************/
+
+/**************************************************************************/
+/*!
+  \brief	Full 64 x 64 -> 128 bit multiply
+
+  \param	a, b: the operands
+
+  \param	hi: receives the upper 64 bits
+
+  \return	the lower 64 bits
+*/
+/**************************************************************************/
+inline u64 Multiply128(u64 a, u64 b, u64 &hi)
+{
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  hi = static_cast<u64>(product >> 64);
+  return static_cast<u64>(product);
+#elif defined(_MSC_VER)
+  return _umul128(a, b, &hi);
+#else
+  u64 aLo = a & 0xFFFFFFFFu, aHi = a >> 32;
+  u64 bLo = b & 0xFFFFFFFFu, bHi = b >> 32;
+  u64 lolo = aLo * bLo;
+  u64 hilo = aHi * bLo;
+  u64 lohi = aLo * bHi;
+  u64 cross = (lolo >> 32) + (hilo & 0xFFFFFFFFu) + lohi;
+  hi = aHi * bHi + (hilo >> 32) + (cross >> 32);
+  return (cross << 32) | (lolo & 0xFFFFFFFFu);
+#endif
+}
+
+constexpr u64 RotateLeft(u64 x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+/**************************************************************************/
+/*!
+  \brief	SplitMix64. Tiny and statistically decent, mainly used to expand
+          a single 64 bit seed into the state of the other engines.
+*/
+/**************************************************************************/
+class SplitMix64
+{
+public:
+  using result_type = u64;
+
+  constexpr SplitMix64(u64 seed = 0) : m_State(seed) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return u64_max; }
+
+  void seed(u64 seed) { m_State = seed; }
+
+  result_type operator()()
+  {
+    u64 z = (m_State += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+private:
+  u64 m_State;
+};
+
+/**************************************************************************/
+/*!
+  \brief	xoshiro256** by Blackman and Vigna. 32 bytes of state, a few
+          cycles per number, the default engine of Random.
+*/
+/**************************************************************************/
+class Xoshiro256ss
+{
+public:
+  using result_type = u64;
+
+  constexpr Xoshiro256ss() : m_State{} {}
+
+  explicit Xoshiro256ss(u64 seed) { this->seed(seed); }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return u64_max; }
+
+  void seed(u64 seed)
+  {
+    SplitMix64 expand(seed);
+    for (u64 &word : m_State)
+      word = expand();
+  }
+
+  result_type operator()()
+  {
+    const u64 result = RotateLeft(m_State[1] * 5, 7) * 9;
+    const u64 t = m_State[1] << 17;
+
+    m_State[2] ^= m_State[0];
+    m_State[3] ^= m_State[1];
+    m_State[1] ^= m_State[2];
+    m_State[0] ^= m_State[3];
+    m_State[2] ^= t;
+    m_State[3] = RotateLeft(m_State[3], 45);
+
+    return result;
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Advances the engine by 2^128 steps. Calling it repeatedly on
+            copies of one engine gives up to 2^128 non overlapping streams.
+  */
+  /**************************************************************************/
+  void jump()
+  {
+    static constexpr u64 JUMP[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                   0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+    Advance(JUMP);
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Advances the engine by 2^192 steps, to split off groups of
+            streams that are each further divided with jump()
+  */
+  /**************************************************************************/
+  void long_jump()
+  {
+    static constexpr u64 LONG_JUMP[] = {0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL,
+                                        0x77710069854EE241ULL, 0x39109BB02ACBE635ULL};
+    Advance(LONG_JUMP);
+  }
+
+private:
+  u64 m_State[4];
+
+  // Multiplies the state by a jump polynomial
+  void Advance(const u64 (&polynomial)[4])
+  {
+    u64 s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (u64 word : polynomial)
+    {
+      for (int bit = 0; bit < 64; ++bit)
+      {
+        if (word & (1ULL << bit))
+        {
+          s0 ^= m_State[0];
+          s1 ^= m_State[1];
+          s2 ^= m_State[2];
+          s3 ^= m_State[3];
+        }
+        (*this)();
+      }
+    }
+    m_State[0] = s0;
+    m_State[1] = s1;
+    m_State[2] = s2;
+    m_State[3] = s3;
+  }
+};
+
+/**************************************************************************/
+/*!
+  \brief	PCG64 with the DXSM output function (128 bit LCG state).
+          Slower than xoshiro256** but with a larger state space and
+          independent streams selected by the increment.
+*/
+/**************************************************************************/
+class Pcg64
+{
+public:
+  using result_type = u64;
+
+  constexpr Pcg64() : m_StateHi(0), m_StateLo(0), m_IncHi(0), m_IncLo(1) {}
+
+  explicit Pcg64(u64 seed, u64 stream = 0) { this->seed(seed, stream); }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return u64_max; }
+
+  void seed(u64 seed, u64 stream = 0)
+  {
+    SplitMix64 expand(seed);
+    SplitMix64 expandStream(stream ^ 0xDA3E39CB94B95BDBULL);
+    m_IncHi = expandStream();
+    m_IncLo = expandStream() | 1;
+    m_StateHi = 0;
+    m_StateLo = 0;
+    Step();
+    u64 hi = expand();
+    u64 lo = expand();
+    m_StateLo += lo;
+    m_StateHi += hi + (m_StateLo < lo);
+    Step();
+  }
+
+  result_type operator()()
+  {
+    u64 hi = m_StateHi;
+    const u64 lo = m_StateLo | 1;
+    Step();
+
+    hi ^= hi >> 32;
+    hi *= CHEAP_MULTIPLIER;
+    hi ^= hi >> 48;
+    hi *= lo;
+    return hi;
+  }
+
+private:
+  static constexpr u64 CHEAP_MULTIPLIER = 0xDA942042E4DD58B5ULL;
+
+  u64 m_StateHi, m_StateLo;
+  u64 m_IncHi, m_IncLo;
+
+  // state = state * multiplier + increment, 128 bit, with the 64 bit
+  // "cheap multiplier" as in PCG64DXSM
+  void Step()
+  {
+    u64 hi;
+    u64 lo = Multiply128(m_StateLo, CHEAP_MULTIPLIER, hi);
+    hi += m_StateHi * CHEAP_MULTIPLIER;
+
+    m_StateLo = lo + m_IncLo;
+    m_StateHi = hi + m_IncHi + (m_StateLo < lo);
+  }
+};
+
+/**************************************************************************/
+/*!
+  \brief	Philox4x32-10 by Salmon et al., a counter-based engine: each
+          output block is a keyed bijection of a 128 bit counter, so any
+          position of any stream is reachable in O(1).
+
+          The key is the seed, the upper half of the counter selects the
+          stream and the lower half is the position within it. Different
+          stream ids never share a counter, so they never overlap.
+*/
+/**************************************************************************/
+class Philox4x32
+{
+public:
+  using result_type = u64;
+
+  constexpr Philox4x32() : m_Key{}, m_Counter{}, m_Output{}, m_Used(2) {}
+
+  explicit Philox4x32(u64 seed, u64 stream = 0) { this->seed(seed, stream); }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return u64_max; }
+
+  void seed(u64 seed, u64 stream = 0)
+  {
+    m_Key[0] = static_cast<u32>(seed);
+    m_Key[1] = static_cast<u32>(seed >> 32);
+    m_Counter[0] = 0;
+    m_Counter[1] = 0;
+    m_Counter[2] = static_cast<u32>(stream);
+    m_Counter[3] = static_cast<u32>(stream >> 32);
+    m_Used = 2;
+  }
+
+  result_type operator()()
+  {
+    if (m_Used == 2)
+    {
+      Block(m_Output);
+      u64 position = Position() + 1;
+      m_Counter[0] = static_cast<u32>(position);
+      m_Counter[1] = static_cast<u32>(position >> 32);
+      m_Used = 0;
+    }
+    return m_Output[m_Used++];
+  }
+
+  // Skips count outputs in constant time
+  void discard(u64 count)
+  {
+    u64 buffered = 2 - m_Used;
+    if (count < buffered)
+    {
+      m_Used += static_cast<u32>(count);
+      return;
+    }
+    count -= buffered;
+    u64 position = Position() + count / 2;
+    m_Counter[0] = static_cast<u32>(position);
+    m_Counter[1] = static_cast<u32>(position >> 32);
+    m_Used = 2;
+    if (count & 1)
+      (*this)();
+  }
+
+private:
+  static constexpr u32 M0 = 0xD2511F53;
+  static constexpr u32 M1 = 0xCD9E8D57;
+  static constexpr u32 W0 = 0x9E3779B9;
+  static constexpr u32 W1 = 0xBB67AE85;
+
+  u32 m_Key[2];
+  u32 m_Counter[4];
+  u64 m_Output[2];
+  u32 m_Used;
+
+  u64 Position() const
+  {
+    return (static_cast<u64>(m_Counter[1]) << 32) | m_Counter[0];
+  }
+
+  // Ten rounds over the current counter
+  void Block(u64 (&out)[2]) const
+  {
+    u32 c0 = m_Counter[0], c1 = m_Counter[1], c2 = m_Counter[2], c3 = m_Counter[3];
+    u32 k0 = m_Key[0], k1 = m_Key[1];
+    for (int round = 0; round < 10; ++round)
+    {
+      const u64 p0 = static_cast<u64>(M0) * c0;
+      const u64 p1 = static_cast<u64>(M1) * c2;
+      const u32 n0 = static_cast<u32>(p1 >> 32) ^ c1 ^ k0;
+      const u32 n2 = static_cast<u32>(p0 >> 32) ^ c3 ^ k1;
+      c0 = n0;
+      c1 = static_cast<u32>(p1);
+      c2 = n2;
+      c3 = static_cast<u32>(p0);
+      k0 += W0;
+      k1 += W1;
+    }
+    out[0] = (static_cast<u64>(c1) << 32) | c0;
+    out[1] = (static_cast<u64>(c3) << 32) | c2;
+  }
+};
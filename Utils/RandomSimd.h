@@ -0,0 +1,144 @@
+#pragma once
+#include <Utils/RandomEngines.h>
+#include <Utils/SimdAlgorithms.h>
+
+#if CUSTOMSTL_SIMD_X86
+namespace CustomSTL::simd::detail
+{
+  // Compiled for AVX2 and only called when s_Active says so, like the
+  // kernels in SimdAlgorithms.h
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+  namespace avx2
+  {
+    inline __m256i Rotl64(__m256i x, int k)
+    {
+      return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+    }
+
+    // Steps lanes xoshiro256** streams, four per register. lanes is a
+    // multiple of 4 and the states are 32 byte aligned.
+    inline void Xoshiro256ssNext(u64 *state0, u64 *state1, u64 *state2, u64 *state3, size_t lanes, u64 *out)
+    {
+      for (size_t lane = 0; lane < lanes; lane += 4)
+      {
+        __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i *>(state0 + lane));
+        __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i *>(state1 + lane));
+        __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i *>(state2 + lane));
+        __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i *>(state3 + lane));
+
+        __m256i x = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+        __m256i r = Rotl64(x, 7);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + lane), _mm256_add_epi64(_mm256_slli_epi64(r, 3), r));
+
+        __m256i t = _mm256_slli_epi64(s1, 17);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = Rotl64(s3, 45);
+
+        _mm256_store_si256(reinterpret_cast<__m256i *>(state0 + lane), s0);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(state1 + lane), s1);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(state2 + lane), s2);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(state3 + lane), s3);
+      }
+    }
+  }
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+}
+#endif
+
+/**************************************************************************/
+/*!
+  \brief	Several independent xoshiro256** streams stepped in lock step.
+          The state is stored lane-major so one step is a handful of vector
+          instructions: four lanes per 256 bit register when the CPU has
+          AVX2 (picked at run time like CustomSTL::simd), otherwise plain
+          loops the compiler can vectorize. Used by the Random::Fill
+          functions.
+
+          xoshiro256** only needs multiplies by 5 and 9, which are done as
+          shift and add, so no 64 bit vector multiply is required.
+*/
+/**************************************************************************/
+template <size_t Lanes>
+class Xoshiro256ssLanes
+{
+public:
+  static constexpr size_t LANES = Lanes;
+
+  constexpr Xoshiro256ssLanes() : m_S0{}, m_S1{}, m_S2{}, m_S3{} {}
+
+  /**************************************************************************/
+  /*!
+    \brief	Seeds every lane from draws of another engine
+
+    \param	source: engine to draw the lane seeds from
+  */
+  /**************************************************************************/
+  template <typename Engine>
+  void seed(Engine &source)
+  {
+    for (size_t lane = 0; lane < Lanes; ++lane)
+    {
+      SplitMix64 expand(source());
+      m_S0[lane] = expand();
+      m_S1[lane] = expand();
+      m_S2[lane] = expand();
+      m_S3[lane] = expand();
+    }
+  }
+
+  /**************************************************************************/
+  /*!
+    \brief	Steps every lane once
+
+    \param	out: receives Lanes numbers
+  */
+  /**************************************************************************/
+  void Next(u64 *out)
+  {
+#if CUSTOMSTL_SIMD_X86
+    if constexpr (Lanes % 4 == 0)
+    {
+      if (CustomSTL::simd::active_level() == CustomSTL::simd::level::avx2)
+      {
+        CustomSTL::simd::detail::avx2::Xoshiro256ssNext(m_S0, m_S1, m_S2, m_S3, Lanes, out);
+        return;
+      }
+    }
+#endif
+    for (size_t lane = 0; lane < Lanes; ++lane)
+    {
+      const u64 s1 = m_S1[lane];
+      const u64 x = (s1 << 2) + s1;
+      const u64 r = RotateLeft(x, 7);
+      out[lane] = (r << 3) + r;
+
+      const u64 t = s1 << 17;
+      m_S2[lane] ^= m_S0[lane];
+      m_S3[lane] ^= s1;
+      m_S1[lane] = s1 ^ m_S2[lane];
+      m_S0[lane] ^= m_S3[lane];
+      m_S2[lane] ^= t;
+      m_S3[lane] = RotateLeft(m_S3[lane], 45);
+    }
+  }
+
+private:
+  alignas(32) u64 m_S0[Lanes];
+  alignas(32) u64 m_S1[Lanes];
+  alignas(32) u64 m_S2[Lanes];
+  alignas(32) u64 m_S3[Lanes];
+
+};
@@ -0,0 +1,228 @@
+#pragma once
+#include <Utils/Random.h>
+
+#include <cassert>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*!
+  \brief	Sampling on top of Random. Every sampler draws from the calling
+          thread's Random engine by default, or from any engine passed in,
+          e.g. a RandomStream for reproducible parallel runs.
+*/
+/******************************************************************************/
+
+/**************************************************************************/
+/*!
+  \brief	Weighted choice in O(1) per draw with Vose's alias method.
+          Building the table is O(n). A draw costs one 64 bit number: the
+          upper half picks a column, the lower half flips the column's coin.
+*/
+/**************************************************************************/
+class AliasTable
+{
+public:
+  AliasTable() = default;
+
+  /**************************************************************************/
+  /*!
+    \brief	Builds the table, index i is drawn with probability
+            weights[i] / sum of weights
+
+    \param	weights: non negative weights, at least one must be positive
+  */
+  /**************************************************************************/
+  explicit AliasTable(std::span<const double> weights)
+  {
+    Build(weights);
+  }
+
+  void Build(std::span<const double> weights)
+  {
+    const size_t n = weights.size();
+    if (!n || n > u32_max)
+      throw std::invalid_argument("AliasTable: weight count must be in [1, 2^32)");
+
+    double sum = 0.0;
+    for (double weight : weights)
+    {
+      if (!(weight >= 0.0) || std::isinf(weight))
+        throw std::invalid_argument("AliasTable: weights must be finite and non negative");
+      sum += weight;
+    }
+    if (!(sum > 0.0))
+      throw std::invalid_argument("AliasTable: weights sum to zero");
+
+    m_Columns.assign(n, Column{});
+    std::vector<double> scaled(n);
+    std::vector<u32> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      scaled[i] = weights[i] * static_cast<double>(n) / sum;
+      (scaled[i] < 1.0 ? small : large).push_back(static_cast<u32>(i));
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+      u32 less = small.back();
+      u32 more = large.back();
+      small.pop_back();
+
+      m_Columns[less].threshold = ToThreshold(scaled[less]);
+      m_Columns[less].alias = more;
+
+      scaled[more] -= 1.0 - scaled[less];
+      if (scaled[more] < 1.0)
+      {
+        large.pop_back();
+        small.push_back(more);
+      }
+    }
+
+    // Whatever is left is full up to rounding error
+    for (u32 i : small)
+      m_Columns[i] = Column{u32_max, i};
+    for (u32 i : large)
+      m_Columns[i] = Column{u32_max, i};
+  }
+
+  // Draws an index with the calling thread's Random engine. The table must
+  // have been built, a default constructed one has no index to draw.
+  u32 Sample() const
+  {
+    return Sample(Random::GetEngine());
+  }
+
+  template <typename Engine>
+  u32 Sample(Engine &engine) const
+  {
+    assert(!m_Columns.empty() && "AliasTable::Sample called before Build");
+    const u64 bits = engine();
+    // Multiply-shift column pick, bias is at most size / 2^32
+    const u32 column = static_cast<u32>(((bits >> 32) * m_Columns.size()) >> 32);
+    const Column &entry = m_Columns[column];
+    return static_cast<u32>(bits) < entry.threshold ? column : entry.alias;
+  }
+
+  size_t Size() const
+  {
+    return m_Columns.size();
+  }
+
+private:
+  struct Column
+  {
+    u32 threshold = 0;  // Keep the column while the coin is below this
+    u32 alias = 0;      // Otherwise take this index
+  };
+
+  std::vector<Column> m_Columns;
+
+  static u32 ToThreshold(double probability)
+  {
+    double scaled = probability * 4294967296.0;
+    return scaled >= 4294967295.0 ? u32_max : static_cast<u32>(scaled);
+  }
+};
+
+/**************************************************************************/
+/*!
+  \brief	Keeps a uniform sample of up to Capacity() items from a stream of
+          unknown length. Uses Li's Algorithm L, which computes how many
+          items to skip instead of drawing for each one, so once the
+          reservoir is full an Offer is usually just a counter increment.
+*/
+/**************************************************************************/
+template <typename T>
+class ReservoirSampler
+{
+public:
+  explicit ReservoirSampler(size_t capacity) : m_Capacity(capacity)
+  {
+    if (!capacity)
+      throw std::invalid_argument("ReservoirSampler: capacity must be positive");
+    m_Samples.reserve(capacity);
+  }
+
+  // Offers the next item of the stream, drawing from the calling thread's
+  // Random engine
+  template <typename U>
+  void Offer(U &&value)
+  {
+    Offer(std::forward<U>(value), Random::GetEngine());
+  }
+
+  template <typename U, typename Engine>
+  void Offer(U &&value, Engine &engine)
+  {
+    ++m_Seen;
+    if (m_Seen <= m_Capacity)
+    {
+      m_Samples.emplace_back(std::forward<U>(value));
+      if (m_Seen == m_Capacity)
+      {
+        m_Weight = std::exp(std::log(Uniform(engine)) / static_cast<double>(m_Capacity));
+        m_Next = m_Seen + Skip(engine) + 1;
+      }
+      return;
+    }
+    if (m_Seen != m_Next)
+      return;
+
+    const u64 slot = ((engine() >> 32) * m_Capacity) >> 32;
+    m_Samples[static_cast<size_t>(slot)] = std::forward<U>(value);
+    m_Weight *= std::exp(std::log(Uniform(engine)) / static_cast<double>(m_Capacity));
+    m_Next += Skip(engine) + 1;
+  }
+
+  std::span<const T> Samples() const
+  {
+    return m_Samples;
+  }
+
+  // Number of items offered so far
+  u64 Seen() const
+  {
+    return m_Seen;
+  }
+
+  size_t Capacity() const
+  {
+    return m_Capacity;
+  }
+
+  void Reset()
+  {
+    m_Samples.clear();
+    m_Seen = 0;
+    m_Next = 0;
+    m_Weight = 1.0;
+  }
+
+private:
+  std::vector<T> m_Samples;
+  size_t m_Capacity;
+  u64 m_Seen = 0;
+  u64 m_Next = 0;       // Index (from 1) of the next item to keep
+  double m_Weight = 1.0;
+
+  // Uniform double in the open interval (0, 1)
+  template <typename Engine>
+  static double Uniform(Engine &engine)
+  {
+    return (static_cast<double>(engine() >> 11) + 0.5) * 0x1.0p-53;
+  }
+
+  template <typename Engine>
+  u64 Skip(Engine &engine) const
+  {
+    double skip = std::floor(std::log(Uniform(engine)) / std::log1p(-m_Weight));
+    return skip < 0x1.0p62 ? static_cast<u64>(skip) : (1ULL << 62);
+  }
+};
@@ -0,0 +1,989 @@
+/**********************************************************************************
+* \brief  Vectorized algorithms over contiguous arithmetic data: sum, min,
+*         max, find, count, compares against a value and element-wise
+*         transforms. They take anything contiguous (CustomSTL::array,
+*         std::vector, std::span, C arrays) and also BList, walked one node
+*         at a time.
+*
+*           CustomSTL::array<f32, 1024, CustomSTL::bounds_debug, 32> samples;
+*           f32 total = CustomSTL::simd::sum(samples);
+*           size_t hot = CustomSTL::simd::count_if(samples, compare_op::gt, 0.9f);
+*
+*         Each kernel is compiled for AVX2 and for SSE2 and the best one the
+*         CPU supports is picked at run time, so the default build runs AVX2
+*         code without -march=native. Other targets use the scalar code.
+*         set_level() forces a lower level, e.g. to compare them.
+*
+*         Integers wrap like unsigned arithmetic and sums are widened to 64
+*         bits. Floating point sums are added in a different order than a
+*         plain loop, so the last bits can differ. min, max and ordered
+*         compares give unspecified results on NaNs.
+**********************************************************************************/
+
+#pragma once
+#include <Types/Base.h>
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CUSTOMSTL_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define CUSTOMSTL_SIMD_X86 0
+#endif
+
+namespace CustomSTL::simd
+{
+  enum class level : u8
+  {
+    scalar,
+    sse2,
+    avx2
+  };
+
+  enum class compare_op : u8
+  {
+    eq,
+    ne,
+    lt,
+    le,
+    gt,
+    ge
+  };
+
+  enum class transform_op : u8
+  {
+    add,
+    sub,
+    mul,
+    min,
+    max
+  };
+
+  // Type sum() returns, integers are widened so long buffers do not overflow
+  template <typename T>
+  using sum_t = std::conditional_t<std::is_floating_point_v<T>, T, std::conditional_t<std::is_signed_v<T>, i64, u64>>;
+
+  namespace detail
+  {
+    inline level Detect()
+    {
+#if CUSTOMSTL_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+      int info[4];
+      __cpuid(info, 1);
+      const bool osxsave = info[2] & (1 << 27);
+      __cpuidex(info, 7, 0);
+      const bool avx2 = info[1] & (1 << 5);
+      // The OS must save the YMM registers too
+      if (osxsave && avx2 && (_xgetbv(0) & 6) == 6)
+        return level::avx2;
+#else
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+        return level::avx2;
+#endif
+      return level::sse2;
+#else
+      return level::scalar;
+#endif
+    }
+
+    inline const level s_Detected = Detect();
+    inline std::atomic<level> s_Active{s_Detected};
+
+    // Fixed width type with the same representation as T, the one the
+    // vector lanes are chosen by. void if no lanes exist for T.
+    template <size_t Size, bool Signed>
+    struct int_of;
+    template <> struct int_of<1, true> { using type = i8; };
+    template <> struct int_of<1, false> { using type = u8; };
+    template <> struct int_of<2, true> { using type = i16; };
+    template <> struct int_of<2, false> { using type = u16; };
+    template <> struct int_of<4, true> { using type = i32; };
+    template <> struct int_of<4, false> { using type = u32; };
+    template <> struct int_of<8, true> { using type = i64; };
+    template <> struct int_of<8, false> { using type = u64; };
+
+    template <typename T>
+    struct storage
+    {
+      using type = void;
+    };
+
+    template <typename T>
+      requires(std::is_integral_v<T> && !std::is_same_v<T, bool>)
+    struct storage<T> : int_of<sizeof(T), std::is_signed_v<T>>
+    {
+    };
+
+    template <> struct storage<f32> { using type = f32; };
+    template <> struct storage<f64> { using type = f64; };
+
+    // Reference versions, also the tails of the vector ones
+    namespace scalar
+    {
+      // Integer arithmetic is done unsigned so overflow wraps instead of
+      // being undefined, at least as wide as unsigned so u16 * u16 does not
+      // promote to a signed int
+      template <typename T>
+      using wrap_t = std::conditional_t<std::is_floating_point_v<T>, T,
+                                        std::common_type_t<unsigned, std::make_unsigned_t<std::conditional_t<std::is_floating_point_v<T>, int, T>>>>;
+
+      template <typename T>
+      sum_t<T> sum(const T *data, size_t size)
+      {
+        using A = std::conditional_t<std::is_floating_point_v<T>, T, u64>;
+        A total = 0;
+        for (size_t i = 0; i < size; ++i)
+          total += static_cast<A>(data[i]);
+        return static_cast<sum_t<T>>(total);
+      }
+
+      template <bool Max, typename T>
+      T extreme(const T *data, size_t size)
+      {
+        T best = data[0];
+        for (size_t i = 1; i < size; ++i)
+          if (Max ? best < data[i] : data[i] < best)
+            best = data[i];
+        return best;
+      }
+
+      template <compare_op Op, typename T>
+      bool test(T a, T b)
+      {
+        if constexpr (Op == compare_op::eq)
+          return a == b;
+        else if constexpr (Op == compare_op::ne)
+          return a != b;
+        else if constexpr (Op == compare_op::lt)
+          return a < b;
+        else if constexpr (Op == compare_op::le)
+          return a <= b;
+        else if constexpr (Op == compare_op::gt)
+          return a > b;
+        else
+          return a >= b;
+      }
+
+      template <compare_op Op, typename T>
+      size_t find_if(const T *data, size_t size, T value)
+      {
+        for (size_t i = 0; i < size; ++i)
+          if (test<Op>(data[i], value))
+            return i;
+        return size;
+      }
+
+      template <compare_op Op, typename T>
+      size_t count_if(const T *data, size_t size, T value)
+      {
+        size_t count = 0;
+        for (size_t i = 0; i < size; ++i)
+          count += test<Op>(data[i], value);
+        return count;
+      }
+
+      template <transform_op Op, typename T>
+      T apply(T a, T b)
+      {
+        using W = wrap_t<T>;
+        if constexpr (Op == transform_op::add)
+          return static_cast<T>(static_cast<W>(a) + static_cast<W>(b));
+        else if constexpr (Op == transform_op::sub)
+          return static_cast<T>(static_cast<W>(a) - static_cast<W>(b));
+        else if constexpr (Op == transform_op::mul)
+          return static_cast<T>(static_cast<W>(a) * static_cast<W>(b));
+        else if constexpr (Op == transform_op::min)
+          return b < a ? b : a;
+        else
+          return a < b ? b : a;
+      }
+
+      template <transform_op Op, typename T>
+      void transform_value(const T *input, T *output, size_t size, T value)
+      {
+        for (size_t i = 0; i < size; ++i)
+          output[i] = apply<Op>(input[i], value);
+      }
+
+      template <transform_op Op, typename T>
+      void transform_pairs(const T *a, const T *b, T *output, size_t size)
+      {
+        for (size_t i = 0; i < size; ++i)
+          output[i] = apply<Op>(a[i], b[i]);
+      }
+    }
+
+#if CUSTOMSTL_SIMD_X86
+    // SSE2 is part of x86-64, so no target switch is needed
+    namespace sse2
+    {
+      template <typename S>
+      struct lanes
+      {
+        static constexpr bool SUPPORTED = false;
+        static constexpr bool FLOATING = false;
+      };
+
+      template <typename S>
+        requires std::is_integral_v<S>
+      struct lanes<S>
+      {
+        using reg = __m128i;
+        static constexpr bool SUPPORTED = true;
+        static constexpr bool FLOATING = false;
+        static constexpr size_t COUNT = 16 / sizeof(S);
+
+        static reg load(const void *p) { return _mm_loadu_si128(static_cast<const __m128i *>(p)); }
+        static void store(void *p, reg v) { _mm_storeu_si128(static_cast<__m128i *>(p), v); }
+        static reg bit_or(reg a, reg b) { return _mm_or_si128(a, b); }
+        static reg bit_not(reg a) { return _mm_xor_si128(a, _mm_set1_epi32(-1)); }
+        static reg blend(reg mask, reg a, reg b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+        static u32 mask_bits(reg mask) { return static_cast<u32>(_mm_movemask_epi8(mask)); }
+        static __m128i as_int(reg v) { return v; }
+
+        static reg set1(S v)
+        {
+          if constexpr (sizeof(S) == 1)
+            return _mm_set1_epi8(static_cast<char>(v));
+          else if constexpr (sizeof(S) == 2)
+            return _mm_set1_epi16(static_cast<short>(v));
+          else if constexpr (sizeof(S) == 4)
+            return _mm_set1_epi32(static_cast<int>(v));
+          else
+            return _mm_set1_epi64x(static_cast<long long>(v));
+        }
+
+        static reg add(reg a, reg b)
+        {
+          if constexpr (sizeof(S) == 1)
+            return _mm_add_epi8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return _mm_add_epi16(a, b);
+          else if constexpr (sizeof(S) == 4)
+            return _mm_add_epi32(a, b);
+          else
+            return _mm_add_epi64(a, b);
+        }
+
+        static reg sub(reg a, reg b)
+        {
+          if constexpr (sizeof(S) == 1)
+            return _mm_sub_epi8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return _mm_sub_epi16(a, b);
+          else if constexpr (sizeof(S) == 4)
+            return _mm_sub_epi32(a, b);
+          else
+            return _mm_sub_epi64(a, b);
+        }
+
+        static reg mul(reg a, reg b)
+          requires(sizeof(S) == 2)
+        {
+          return _mm_mullo_epi16(a, b);
+        }
+
+        static reg eq(reg a, reg b)
+        {
+          if constexpr (sizeof(S) == 1)
+            return _mm_cmpeq_epi8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return _mm_cmpeq_epi16(a, b);
+          else if constexpr (sizeof(S) == 4)
+            return _mm_cmpeq_epi32(a, b);
+          else
+          {
+            // Both 32-bit halves must match
+            const reg halves = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+          }
+        }
+
+        // SSE2 has no 64-bit compare, those lanes stay unordered
+        static reg gt(reg a, reg b)
+          requires(sizeof(S) < 8)
+        {
+          if constexpr (std::is_unsigned_v<S>)
+          {
+            // Flipping the sign bit maps unsigned order onto signed order
+            const reg flip = set1(static_cast<S>(S(1) << (sizeof(S) * 8 - 1)));
+            a = _mm_xor_si128(a, flip);
+            b = _mm_xor_si128(b, flip);
+          }
+          if constexpr (sizeof(S) == 1)
+            return _mm_cmpgt_epi8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return _mm_cmpgt_epi16(a, b);
+          else
+            return _mm_cmpgt_epi32(a, b);
+        }
+
+        // Sums are kept in 64-bit lanes
+        static reg sum_zero() { return _mm_setzero_si128(); }
+
+        static void accumulate(reg &acc, reg v)
+          requires(sizeof(S) >= 4 || std::is_same_v<S, u8>)
+        {
+          if constexpr (sizeof(S) == 8)
+            acc = _mm_add_epi64(acc, v);
+          else if constexpr (sizeof(S) == 4)
+          {
+            const reg high = std::is_signed_v<S> ? _mm_srai_epi32(v, 31) : _mm_setzero_si128();
+            acc = _mm_add_epi64(acc, _mm_add_epi64(_mm_unpacklo_epi32(v, high), _mm_unpackhi_epi32(v, high)));
+          }
+          else
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+        }
+
+        static sum_t<S> reduce(reg acc)
+        {
+          u64 parts[2];
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(parts), acc);
+          return static_cast<sum_t<S>>(parts[0] + parts[1]);
+        }
+      };
+
+      template <>
+      struct lanes<f32>
+      {
+        using reg = __m128;
+        static constexpr bool SUPPORTED = true;
+        static constexpr bool FLOATING = true;
+        static constexpr size_t COUNT = 4;
+
+        static reg load(const void *p) { return _mm_loadu_ps(static_cast<const float *>(p)); }
+        static void store(void *p, reg v) { _mm_storeu_ps(static_cast<float *>(p), v); }
+        static reg set1(f32 v) { return _mm_set1_ps(v); }
+        static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+        static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+        static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+        static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+        static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+        static reg bit_or(reg a, reg b) { return _mm_or_ps(a, b); }
+        static u32 mask_bits(reg mask) { return static_cast<u32>(_mm_movemask_epi8(_mm_castps_si128(mask))); }
+        static __m128i as_int(reg v) { return _mm_castps_si128(v); }
+
+        template <compare_op Op>
+        static reg compare(reg a, reg b)
+        {
+          if constexpr (Op == compare_op::eq)
+            return _mm_cmpeq_ps(a, b);
+          else if constexpr (Op == compare_op::ne)
+            return _mm_cmpneq_ps(a, b);
+          else if constexpr (Op == compare_op::lt)
+            return _mm_cmplt_ps(a, b);
+          else if constexpr (Op == compare_op::le)
+            return _mm_cmple_ps(a, b);
+          else if constexpr (Op == compare_op::gt)
+            return _mm_cmpgt_ps(a, b);
+          else
+            return _mm_cmpge_ps(a, b);
+        }
+
+        static reg sum_zero() { return _mm_setzero_ps(); }
+        static void accumulate(reg &acc, reg v) { acc = _mm_add_ps(acc, v); }
+
+        static f32 reduce(reg acc)
+        {
+          f32 parts[4];
+          _mm_storeu_ps(parts, acc);
+          return (parts[0] + parts[1]) + (parts[2] + parts[3]);
+        }
+      };
+
+      template <>
+      struct lanes<f64>
+      {
+        using reg = __m128d;
+        static constexpr bool SUPPORTED = true;
+        static constexpr bool FLOATING = true;
+        static constexpr size_t COUNT = 2;
+
+        static reg load(const void *p) { return _mm_loadu_pd(static_cast<const double *>(p)); }
+        static void store(void *p, reg v) { _mm_storeu_pd(static_cast<double *>(p), v); }
+        static reg set1(f64 v) { return _mm_set1_pd(v); }
+        static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+        static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+        static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+        static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+        static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+        static reg bit_or(reg a, reg b) { return _mm_or_pd(a, b); }
+        static u32 mask_bits(reg mask) { return static_cast<u32>(_mm_movemask_epi8(_mm_castpd_si128(mask))); }
+        static __m128i as_int(reg v) { return _mm_castpd_si128(v); }
+
+        template <compare_op Op>
+        static reg compare(reg a, reg b)
+        {
+          if constexpr (Op == compare_op::eq)
+            return _mm_cmpeq_pd(a, b);
+          else if constexpr (Op == compare_op::ne)
+            return _mm_cmpneq_pd(a, b);
+          else if constexpr (Op == compare_op::lt)
+            return _mm_cmplt_pd(a, b);
+          else if constexpr (Op == compare_op::le)
+            return _mm_cmple_pd(a, b);
+          else if constexpr (Op == compare_op::gt)
+            return _mm_cmpgt_pd(a, b);
+          else
+            return _mm_cmpge_pd(a, b);
+        }
+
+        static reg sum_zero() { return _mm_setzero_pd(); }
+        static void accumulate(reg &acc, reg v) { acc = _mm_add_pd(acc, v); }
+
+        static f64 reduce(reg acc)
+        {
+          f64 parts[2];
+          _mm_storeu_pd(parts, acc);
+          return parts[0] + parts[1];
+        }
+      };
+
+#include "SimdKernels.h"
+    }
+
+    // Everything defined from here to the matching pop is compiled for
+    // AVX2, and only ever called after Detect() found it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+    namespace avx2
+    {
+      template <typename S>
+      struct lanes
+      {
+        static constexpr bool SUPPORTED = false;
+        static constexpr bool FLOATING = false;
+      };
+
+      template <typename S>
+        requires std::is_integral_v<S>
+      struct lanes<S>
+      {
+        using reg = __m256i;
+        static constexpr bool SUPPORTED = true;
+        static constexpr bool FLOATING = false;
+        static constexpr size_t COUNT = 32 / sizeof(S);
+
+        static reg load(const void *p) { return _mm256_loadu_si256(static_cast<const __m256i *>(p)); }
+        static void store(void *p, reg v) { _mm256_storeu_si256(static_cast<__m256i *>(p), v); }
+        static reg bit_or(reg a, reg b) { return _mm256_or_si256(a, b); }
+        static reg bit_not(reg a) { return _mm256_xor_si256(a, _mm256_set1_epi32(-1)); }
+        static reg blend(reg mask, reg a, reg b) { return _mm256_blendv_epi8(b, a, mask); }
+        static u32 mask_bits(reg mask) { return static_cast<u32>(_mm256_movemask_epi8(mask)); }
+        static __m256i as_int(reg v) { return v; }
+
+        static reg set1(S v)
+        {
+          if constexpr (sizeof(S) == 1)
+            return _mm256_set1_epi8(static_cast<char>(v));
+          else if constexpr (sizeof(S) == 2)
+            return _mm256_set1_epi16(static_cast<short>(v));
+          else if constexpr (sizeof(S) == 4)
+            return _mm256_set1_epi32(static_cast<int>(v));
+          else
+            return _mm256_set1_epi64x(static_cast<long long>(v));
+        }
+
+        static reg add(reg a, reg b)
+        {
+          if constexpr (sizeof(S) == 1)
+            return _mm256_add_epi8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return _mm256_add_epi16(a, b);
+          else if constexpr (sizeof(S) == 4)
+            return _mm256_add_epi32(a, b);
+          else
+            return _mm256_add_epi64(a, b);
+        }
+
+        static reg sub(reg a, reg b)
+        {
+          if constexpr (sizeof(S) == 1)
+            return _mm256_sub_epi8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return _mm256_sub_epi16(a, b);
+          else if constexpr (sizeof(S) == 4)
+            return _mm256_sub_epi32(a, b);
+          else
+            return _mm256_sub_epi64(a, b);
+        }
+
+        static reg mul(reg a, reg b)
+          requires(sizeof(S) == 2 || sizeof(S) == 4)
+        {
+          if constexpr (sizeof(S) == 2)
+            return _mm256_mullo_epi16(a, b);
+          else
+            return _mm256_mullo_epi32(a, b);
+        }
+
+        static reg eq(reg a, reg b)
+        {
+          if constexpr (sizeof(S) == 1)
+            return _mm256_cmpeq_epi8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return _mm256_cmpeq_epi16(a, b);
+          else if constexpr (sizeof(S) == 4)
+            return _mm256_cmpeq_epi32(a, b);
+          else
+            return _mm256_cmpeq_epi64(a, b);
+        }
+
+        static reg gt(reg a, reg b)
+        {
+          if constexpr (std::is_unsigned_v<S>)
+          {
+            const reg flip = set1(static_cast<S>(S(1) << (sizeof(S) * 8 - 1)));
+            a = _mm256_xor_si256(a, flip);
+            b = _mm256_xor_si256(b, flip);
+          }
+          if constexpr (sizeof(S) == 1)
+            return _mm256_cmpgt_epi8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return _mm256_cmpgt_epi16(a, b);
+          else if constexpr (sizeof(S) == 4)
+            return _mm256_cmpgt_epi32(a, b);
+          else
+            return _mm256_cmpgt_epi64(a, b);
+        }
+
+        // Native below 64 bits, wider lanes blend on gt
+        static reg min(reg a, reg b)
+          requires(sizeof(S) < 8)
+        {
+          if constexpr (sizeof(S) == 1)
+            return std::is_signed_v<S> ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return std::is_signed_v<S> ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b);
+          else
+            return std::is_signed_v<S> ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+        }
+
+        static reg max(reg a, reg b)
+          requires(sizeof(S) < 8)
+        {
+          if constexpr (sizeof(S) == 1)
+            return std::is_signed_v<S> ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b);
+          else if constexpr (sizeof(S) == 2)
+            return std::is_signed_v<S> ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b);
+          else
+            return std::is_signed_v<S> ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+        }
+
+        static reg sum_zero() { return _mm256_setzero_si256(); }
+
+        static void accumulate(reg &acc, reg v)
+          requires(sizeof(S) >= 4 || std::is_same_v<S, u8>)
+        {
+          if constexpr (sizeof(S) == 8)
+            acc = _mm256_add_epi64(acc, v);
+          else if constexpr (sizeof(S) == 4)
+          {
+            const __m128i low = _mm256_castsi256_si128(v), high = _mm256_extracti128_si256(v, 1);
+            if constexpr (std::is_signed_v<S>)
+              acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_cvtepi32_epi64(low), _mm256_cvtepi32_epi64(high)));
+            else
+              acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_cvtepu32_epi64(low), _mm256_cvtepu32_epi64(high)));
+          }
+          else
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+        }
+
+        static sum_t<S> reduce(reg acc)
+        {
+          u64 parts[4];
+          _mm256_storeu_si256(reinterpret_cast<__m256i *>(parts), acc);
+          return static_cast<sum_t<S>>((parts[0] + parts[1]) + (parts[2] + parts[3]));
+        }
+      };
+
+      template <>
+      struct lanes<f32>
+      {
+        using reg = __m256;
+        static constexpr bool SUPPORTED = true;
+        static constexpr bool FLOATING = true;
+        static constexpr size_t COUNT = 8;
+
+        static reg load(const void *p) { return _mm256_loadu_ps(static_cast<const float *>(p)); }
+        static void store(void *p, reg v) { _mm256_storeu_ps(static_cast<float *>(p), v); }
+        static reg set1(f32 v) { return _mm256_set1_ps(v); }
+        static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+        static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+        static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+        static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+        static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+        static reg bit_or(reg a, reg b) { return _mm256_or_ps(a, b); }
+        static u32 mask_bits(reg mask) { return static_cast<u32>(_mm256_movemask_epi8(_mm256_castps_si256(mask))); }
+        static __m256i as_int(reg v) { return _mm256_castps_si256(v); }
+
+        template <compare_op Op>
+        static reg compare(reg a, reg b)
+        {
+          if constexpr (Op == compare_op::eq)
+            return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+          else if constexpr (Op == compare_op::ne)
+            return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ);
+          else if constexpr (Op == compare_op::lt)
+            return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+          else if constexpr (Op == compare_op::le)
+            return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+          else if constexpr (Op == compare_op::gt)
+            return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+          else
+            return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+        }
+
+        static reg sum_zero() { return _mm256_setzero_ps(); }
+        static void accumulate(reg &acc, reg v) { acc = _mm256_add_ps(acc, v); }
+
+        static f32 reduce(reg acc)
+        {
+          f32 parts[8];
+          _mm256_storeu_ps(parts, acc);
+          return ((parts[0] + parts[1]) + (parts[2] + parts[3])) + ((parts[4] + parts[5]) + (parts[6] + parts[7]));
+        }
+      };
+
+      template <>
+      struct lanes<f64>
+      {
+        using reg = __m256d;
+        static constexpr bool SUPPORTED = true;
+        static constexpr bool FLOATING = true;
+        static constexpr size_t COUNT = 4;
+
+        static reg load(const void *p) { return _mm256_loadu_pd(static_cast<const double *>(p)); }
+        static void store(void *p, reg v) { _mm256_storeu_pd(static_cast<double *>(p), v); }
+        static reg set1(f64 v) { return _mm256_set1_pd(v); }
+        static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+        static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+        static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+        static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+        static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+        static reg bit_or(reg a, reg b) { return _mm256_or_pd(a, b); }
+        static u32 mask_bits(reg mask) { return static_cast<u32>(_mm256_movemask_epi8(_mm256_castpd_si256(mask))); }
+        static __m256i as_int(reg v) { return _mm256_castpd_si256(v); }
+
+        template <compare_op Op>
+        static reg compare(reg a, reg b)
+        {
+          if constexpr (Op == compare_op::eq)
+            return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+          else if constexpr (Op == compare_op::ne)
+            return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ);
+          else if constexpr (Op == compare_op::lt)
+            return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+          else if constexpr (Op == compare_op::le)
+            return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+          else if constexpr (Op == compare_op::gt)
+            return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+          else
+            return _mm256_cmp_pd(a, b, _CMP_GE_OQ);
+        }
+
+        static reg sum_zero() { return _mm256_setzero_pd(); }
+        static void accumulate(reg &acc, reg v) { acc = _mm256_add_pd(acc, v); }
+
+        static f64 reduce(reg acc)
+        {
+          f64 parts[4];
+          _mm256_storeu_pd(parts, acc);
+          return (parts[0] + parts[1]) + (parts[2] + parts[3]);
+        }
+      };
+
+#include "SimdKernels.h"
+    }
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
+
+    template <typename R>
+    auto View(R &range)
+    {
+      return std::span(std::ranges::data(range), std::ranges::size(range));
+    }
+
+    // Turns a run time compare_op into a compile time one, so the kernels
+    // do not branch on it per element
+    template <typename F>
+    decltype(auto) WithCompare(compare_op op, F &&f)
+    {
+      switch (op)
+      {
+      case compare_op::eq: return f(std::integral_constant<compare_op, compare_op::eq>{});
+      case compare_op::ne: return f(std::integral_constant<compare_op, compare_op::ne>{});
+      case compare_op::lt: return f(std::integral_constant<compare_op, compare_op::lt>{});
+      case compare_op::le: return f(std::integral_constant<compare_op, compare_op::le>{});
+      case compare_op::gt: return f(std::integral_constant<compare_op, compare_op::gt>{});
+      case compare_op::ge: return f(std::integral_constant<compare_op, compare_op::ge>{});
+      }
+      throw std::invalid_argument("simd: unknown compare_op");
+    }
+
+    template <typename F>
+    decltype(auto) WithTransform(transform_op op, F &&f)
+    {
+      switch (op)
+      {
+      case transform_op::add: return f(std::integral_constant<transform_op, transform_op::add>{});
+      case transform_op::sub: return f(std::integral_constant<transform_op, transform_op::sub>{});
+      case transform_op::mul: return f(std::integral_constant<transform_op, transform_op::mul>{});
+      case transform_op::min: return f(std::integral_constant<transform_op, transform_op::min>{});
+      case transform_op::max: return f(std::integral_constant<transform_op, transform_op::max>{});
+      }
+      throw std::invalid_argument("simd: unknown transform_op");
+    }
+  }
+
+  // The instruction set the CPU supports
+  inline level detected_level()
+  {
+    return detail::s_Detected;
+  }
+
+  // The instruction set in use, detected_level() unless lowered
+  inline level active_level()
+  {
+    return detail::s_Active.load(std::memory_order_relaxed);
+  }
+
+  // Uses wanted, or the detected level if the CPU does not support it
+  inline void set_level(level wanted)
+  {
+    detail::s_Active.store(wanted < detail::s_Detected ? wanted : detail::s_Detected, std::memory_order_relaxed);
+  }
+
+  template <typename R>
+  concept arithmetic_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+                             std::is_arithmetic_v<std::ranges::range_value_t<R>> &&
+                             !std::is_same_v<std::ranges::range_value_t<R>, bool>;
+
+  template <typename R>
+  concept writable_arithmetic_range = arithmetic_range<R> &&
+                                      !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+
+  // A list of nodes each holding a run of values, BList for instance
+  template <typename L>
+  concept segmented_list = requires(const L &list) {
+    list.GetHead()->values[0];
+    list.GetHead()->count;
+    list.GetHead()->next;
+  } && std::is_arithmetic_v<std::remove_cvref_t<decltype(std::declval<const L &>().GetHead()->values[0])>>;
+
+  template <segmented_list L>
+  using segment_value_t = std::remove_cvref_t<decltype(std::declval<const L &>().GetHead()->values[0])>;
+
+#if CUSTOMSTL_SIMD_X86
+#define CUSTOMSTL_SIMD_DISPATCH(...)              \
+  switch (active_level())                         \
+  {                                               \
+  case level::avx2:                               \
+    return detail::avx2::__VA_ARGS__;             \
+  case level::sse2:                               \
+    return detail::sse2::__VA_ARGS__;             \
+  default:                                        \
+    return detail::scalar::__VA_ARGS__;           \
+  }
+#else
+#define CUSTOMSTL_SIMD_DISPATCH(...) return detail::scalar::__VA_ARGS__;
+#endif
+
+  template <arithmetic_range R>
+  sum_t<std::ranges::range_value_t<R>> sum(R &&range)
+  {
+    const auto data = detail::View(range);
+    CUSTOMSTL_SIMD_DISPATCH(sum(data.data(), data.size()))
+  }
+
+  // Throws std::invalid_argument if the range is empty
+  template <arithmetic_range R>
+  std::ranges::range_value_t<R> min(R &&range)
+  {
+    const auto data = detail::View(range);
+    if (data.empty())
+      throw std::invalid_argument("simd::min: empty range");
+    CUSTOMSTL_SIMD_DISPATCH(extreme<false>(data.data(), data.size()))
+  }
+
+  template <arithmetic_range R>
+  std::ranges::range_value_t<R> max(R &&range)
+  {
+    const auto data = detail::View(range);
+    if (data.empty())
+      throw std::invalid_argument("simd::max: empty range");
+    CUSTOMSTL_SIMD_DISPATCH(extreme<true>(data.data(), data.size()))
+  }
+
+  // Index of the first element e for which "e op value" holds, the size of
+  // the range if there is none
+  template <arithmetic_range R>
+  size_t find_if(R &&range, compare_op op, std::ranges::range_value_t<R> value)
+  {
+    const auto data = detail::View(range);
+    return detail::WithCompare(op, [&](auto compare) -> size_t {
+      CUSTOMSTL_SIMD_DISPATCH(find_if<decltype(compare)::value>(data.data(), data.size(), value))
+    });
+  }
+
+  // Over a byte range this is memchr
+  template <arithmetic_range R>
+  size_t find(R &&range, std::ranges::range_value_t<R> value)
+  {
+    return simd::find_if(range, compare_op::eq, value);
+  }
+
+  // Number of elements e for which "e op value" holds
+  template <arithmetic_range R>
+  size_t count_if(R &&range, compare_op op, std::ranges::range_value_t<R> value)
+  {
+    const auto data = detail::View(range);
+    return detail::WithCompare(op, [&](auto compare) -> size_t {
+      CUSTOMSTL_SIMD_DISPATCH(count_if<decltype(compare)::value>(data.data(), data.size(), value))
+    });
+  }
+
+  template <arithmetic_range R>
+  size_t count(R &&range, std::ranges::range_value_t<R> value)
+  {
+    return simd::count_if(range, compare_op::eq, value);
+  }
+
+  // output[i] = input[i] op value. output may be input, other overlaps are
+  // not allowed. Throws std::invalid_argument if the sizes differ.
+  template <arithmetic_range In, writable_arithmetic_range Out>
+    requires std::same_as<std::ranges::range_value_t<In>, std::ranges::range_value_t<Out>>
+  void transform(In &&input, Out &&output, transform_op op, std::ranges::range_value_t<In> value)
+  {
+    const auto in = detail::View(input);
+    const auto out = detail::View(output);
+    if (in.size() != out.size())
+      throw std::invalid_argument("simd::transform: ranges differ in size");
+    detail::WithTransform(op, [&](auto apply) {
+      CUSTOMSTL_SIMD_DISPATCH(transform_value<decltype(apply)::value>(in.data(), out.data(), in.size(), value))
+    });
+  }
+
+  // output[i] = a[i] op b[i], with the same overlap rules
+  template <arithmetic_range A, arithmetic_range B, writable_arithmetic_range Out>
+    requires std::same_as<std::ranges::range_value_t<A>, std::ranges::range_value_t<B>> &&
+             std::same_as<std::ranges::range_value_t<A>, std::ranges::range_value_t<Out>>
+  void transform(A &&a, B &&b, Out &&output, transform_op op)
+  {
+    const auto left = detail::View(a);
+    const auto right = detail::View(b);
+    const auto out = detail::View(output);
+    if (left.size() != right.size() || left.size() != out.size())
+      throw std::invalid_argument("simd::transform: ranges differ in size");
+    detail::WithTransform(op, [&](auto apply) {
+      CUSTOMSTL_SIMD_DISPATCH(transform_pairs<decltype(apply)::value>(left.data(), right.data(), out.data(), out.size()))
+    });
+  }
+
+#undef CUSTOMSTL_SIMD_DISPATCH
+
+  // Calls f(std::span<const T>) for every non-empty node, in list order
+  template <segmented_list L, typename F>
+  void for_each_segment(const L &list, F &&f)
+  {
+    for (auto node = list.GetHead(); node; node = node->next)
+      if (node->count)
+        f(std::span<const segment_value_t<L>>(node->values, node->count));
+  }
+
+  template <segmented_list L>
+  sum_t<segment_value_t<L>> sum(const L &list)
+  {
+    sum_t<segment_value_t<L>> total = 0;
+    for_each_segment(list, [&](auto segment) { total += simd::sum(segment); });
+    return total;
+  }
+
+  template <segmented_list L>
+  segment_value_t<L> min(const L &list)
+  {
+    bool any = false;
+    segment_value_t<L> best{};
+    for_each_segment(list, [&](auto segment) {
+      const segment_value_t<L> low = simd::min(segment);
+      if (!any || low < best)
+        best = low;
+      any = true;
+    });
+    if (!any)
+      throw std::invalid_argument("simd::min: empty list");
+    return best;
+  }
+
+  template <segmented_list L>
+  segment_value_t<L> max(const L &list)
+  {
+    bool any = false;
+    segment_value_t<L> best{};
+    for_each_segment(list, [&](auto segment) {
+      const segment_value_t<L> high = simd::max(segment);
+      if (!any || best < high)
+        best = high;
+      any = true;
+    });
+    if (!any)
+      throw std::invalid_argument("simd::max: empty list");
+    return best;
+  }
+
+  // Index in the whole list, the item count if there is no match
+  template <segmented_list L>
+  size_t find_if(const L &list, compare_op op, segment_value_t<L> value)
+  {
+    size_t before = 0;
+    for (auto node = list.GetHead(); node; node = node->next)
+    {
+      const std::span<const segment_value_t<L>> segment(node->values, node->count);
+      const size_t found = simd::find_if(segment, op, value);
+      if (found != segment.size())
+        return before + found;
+      before += segment.size();
+    }
+    return before;
+  }
+
+  template <segmented_list L>
+  size_t find(const L &list, segment_value_t<L> value)
+  {
+    return simd::find_if(list, compare_op::eq, value);
+  }
+
+  template <segmented_list L>
+  size_t count_if(const L &list, compare_op op, segment_value_t<L> value)
+  {
+    size_t count = 0;
+    for_each_segment(list, [&](auto segment) { count += simd::count_if(segment, op, value); });
+    return count;
+  }
+
+  template <segmented_list L>
+  size_t count(const L &list, segment_value_t<L> value)
+  {
+    return simd::count_if(list, compare_op::eq, value);
+  }
+}
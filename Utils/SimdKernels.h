@@ -0,0 +1,255 @@
+/**********************************************************************************
+* \brief  The vector kernels behind SimdAlgorithms.h, written once against the
+*         lanes<S> traits of an instruction set. SimdAlgorithms.h includes this
+*         file once per instruction set, inside that set's namespace and with
+*         that set enabled, so there is deliberately no include guard.
+*
+*         lanes<S> gives, for a storage type S: reg, COUNT, FLOATING, load,
+*         store, set1, add, sub, bit_or, mask_bits (one bit per byte), as_int
+*         (the register reinterpreted as integer lanes), and for integers eq,
+*         bit_not and blend. Where the instruction set has them it also gives
+*         gt, min, max, mul and accumulate / reduce for sums, floating point
+*         lanes give compare<Op> instead of eq and gt. Kernels that need a
+*         member a lanes<S> lacks run the scalar version.
+**********************************************************************************/
+
+template <typename T>
+using lanes_for = lanes<typename storage<T>::type>;
+
+template <typename L>
+constexpr bool ORDERED = L::FLOATING || requires(typename L::reg r) { L::gt(r, r); };
+
+template <typename L, compare_op Op>
+constexpr bool COMPARES = Op == compare_op::eq || Op == compare_op::ne || ORDERED<L>;
+
+template <typename L, transform_op Op>
+constexpr bool APPLIES = Op == transform_op::add || Op == transform_op::sub ||
+                         (Op == transform_op::mul ? requires(typename L::reg r) { L::mul(r, r); } : ORDERED<L>);
+
+template <typename L>
+constexpr bool SUMS = requires(typename L::reg r) { L::accumulate(r, r); };
+
+// Integers only have eq and gt, the other compares are built from them
+template <typename L, compare_op Op>
+typename L::reg compare_lanes(typename L::reg a, typename L::reg b)
+{
+  if constexpr (L::FLOATING)
+    return L::template compare<Op>(a, b);
+  else if constexpr (Op == compare_op::eq)
+    return L::eq(a, b);
+  else if constexpr (Op == compare_op::ne)
+    return L::bit_not(L::eq(a, b));
+  else if constexpr (Op == compare_op::lt)
+    return L::gt(b, a);
+  else if constexpr (Op == compare_op::le)
+    return L::bit_not(L::gt(a, b));
+  else if constexpr (Op == compare_op::gt)
+    return L::gt(a, b);
+  else
+    return L::bit_not(L::gt(b, a));
+}
+
+template <bool Max, typename L>
+typename L::reg pick_lanes(typename L::reg a, typename L::reg b)
+{
+  if constexpr (Max)
+  {
+    if constexpr (requires { L::max(a, b); })
+      return L::max(a, b);
+    else
+      return L::blend(L::gt(a, b), a, b);
+  }
+  else
+  {
+    if constexpr (requires { L::min(a, b); })
+      return L::min(a, b);
+    else
+      return L::blend(L::gt(a, b), b, a);
+  }
+}
+
+template <typename L, transform_op Op>
+typename L::reg apply_lanes(typename L::reg a, typename L::reg b)
+{
+  if constexpr (Op == transform_op::add)
+    return L::add(a, b);
+  else if constexpr (Op == transform_op::sub)
+    return L::sub(a, b);
+  else if constexpr (Op == transform_op::mul)
+    return L::mul(a, b);
+  else
+    return pick_lanes<Op == transform_op::max, L>(a, b);
+}
+
+// Index within a register of the first set lane of a mask_bits result
+template <typename T>
+size_t first_lane(u32 bits)
+{
+  return static_cast<size_t>(std::countr_zero(bits)) / sizeof(T);
+}
+
+// Four accumulators so consecutive adds do not wait on each other
+template <typename T>
+sum_t<T> sum(const T *data, size_t size)
+{
+  using L = lanes_for<T>;
+  if constexpr (!L::SUPPORTED || !SUMS<L>)
+    return scalar::sum(data, size);
+  else
+  {
+    constexpr size_t STEP = L::COUNT;
+    typename L::reg acc0 = L::sum_zero(), acc1 = L::sum_zero(), acc2 = L::sum_zero(), acc3 = L::sum_zero();
+    size_t i = 0;
+    for (; i + 4 * STEP <= size; i += 4 * STEP)
+    {
+      L::accumulate(acc0, L::load(data + i));
+      L::accumulate(acc1, L::load(data + i + STEP));
+      L::accumulate(acc2, L::load(data + i + 2 * STEP));
+      L::accumulate(acc3, L::load(data + i + 3 * STEP));
+    }
+    for (; i + STEP <= size; i += STEP)
+      L::accumulate(acc0, L::load(data + i));
+
+    const sum_t<T> total = static_cast<sum_t<T>>(L::reduce(acc0) + L::reduce(acc1)) +
+                           static_cast<sum_t<T>>(L::reduce(acc2) + L::reduce(acc3));
+    return total + scalar::sum(data + i, size - i);
+  }
+}
+
+// size must be at least 1
+template <bool Max, typename T>
+T extreme(const T *data, size_t size)
+{
+  using L = lanes_for<T>;
+  if constexpr (!L::SUPPORTED || !ORDERED<L>)
+    return scalar::extreme<Max>(data, size);
+  else
+  {
+    constexpr size_t STEP = L::COUNT;
+    if (size < 2 * STEP)
+      return scalar::extreme<Max>(data, size);
+
+    typename L::reg best0 = L::load(data), best1 = L::load(data + STEP);
+    size_t i = 2 * STEP;
+    for (; i + 2 * STEP <= size; i += 2 * STEP)
+    {
+      best0 = pick_lanes<Max, L>(best0, L::load(data + i));
+      best1 = pick_lanes<Max, L>(best1, L::load(data + i + STEP));
+    }
+    // Reading the last two registers again cannot change the result, so
+    // the tail is one overlapping step instead of a scalar loop
+    if (i < size)
+    {
+      best0 = pick_lanes<Max, L>(best0, L::load(data + size - 2 * STEP));
+      best1 = pick_lanes<Max, L>(best1, L::load(data + size - STEP));
+    }
+
+    T values[STEP];
+    L::store(values, pick_lanes<Max, L>(best0, best1));
+    return scalar::extreme<Max>(values, STEP);
+  }
+}
+
+// Four registers are compared per step and their masks OR-ed, so a miss
+// costs one test per 4 registers, like memchr
+template <compare_op Op, typename T>
+size_t find_if(const T *data, size_t size, T value)
+{
+  using L = lanes_for<T>;
+  if constexpr (!L::SUPPORTED || !COMPARES<L, Op>)
+    return scalar::find_if<Op>(data, size, value);
+  else
+  {
+    constexpr size_t STEP = L::COUNT;
+    const typename L::reg needle = L::set1(value);
+    size_t i = 0;
+    for (; i + 4 * STEP <= size; i += 4 * STEP)
+    {
+      const typename L::reg m0 = compare_lanes<L, Op>(L::load(data + i), needle);
+      const typename L::reg m1 = compare_lanes<L, Op>(L::load(data + i + STEP), needle);
+      const typename L::reg m2 = compare_lanes<L, Op>(L::load(data + i + 2 * STEP), needle);
+      const typename L::reg m3 = compare_lanes<L, Op>(L::load(data + i + 3 * STEP), needle);
+      if (L::mask_bits(L::bit_or(L::bit_or(m0, m1), L::bit_or(m2, m3))))
+      {
+        if (const u32 bits = L::mask_bits(m0))
+          return i + first_lane<T>(bits);
+        if (const u32 bits = L::mask_bits(m1))
+          return i + STEP + first_lane<T>(bits);
+        if (const u32 bits = L::mask_bits(m2))
+          return i + 2 * STEP + first_lane<T>(bits);
+        return i + 3 * STEP + first_lane<T>(L::mask_bits(m3));
+      }
+    }
+    for (; i + STEP <= size; i += STEP)
+      if (const u32 bits = L::mask_bits(compare_lanes<L, Op>(L::load(data + i), needle)))
+        return i + first_lane<T>(bits);
+    return i + scalar::find_if<Op>(data + i, size - i, value);
+  }
+}
+
+// Matching lanes are all ones, so subtracting the masks counts matches per
+// lane. The counters are emptied before 8 or 16-bit lanes can wrap.
+template <compare_op Op, typename T>
+size_t count_if(const T *data, size_t size, T value)
+{
+  using L = lanes_for<T>;
+  if constexpr (!L::SUPPORTED || !COMPARES<L, Op>)
+    return scalar::count_if<Op>(data, size, value);
+  else
+  {
+    using U = typename int_of<sizeof(T), false>::type;
+    using C = lanes<U>;
+    constexpr size_t STEP = L::COUNT;
+    constexpr size_t BLOCK = sizeof(T) == 1 ? 255 : sizeof(T) == 2 ? 65535 : ~size_t(0) / STEP;
+    const typename L::reg needle = L::set1(value);
+    size_t count = 0;
+    size_t i = 0;
+    while (size - i >= STEP)
+    {
+      const size_t steps = (size - i) / STEP < BLOCK ? (size - i) / STEP : BLOCK;
+      const size_t end = i + steps * STEP;
+      typename C::reg counters = C::set1(0);
+      for (; i < end; i += STEP)
+        counters = C::sub(counters, L::as_int(compare_lanes<L, Op>(L::load(data + i), needle)));
+
+      U lanes[STEP];
+      C::store(lanes, counters);
+      for (const U lane : lanes)
+        count += lane;
+    }
+    return count + scalar::count_if<Op>(data + i, size - i, value);
+  }
+}
+
+template <transform_op Op, typename T>
+void transform_value(const T *input, T *output, size_t size, T value)
+{
+  using L = lanes_for<T>;
+  if constexpr (!L::SUPPORTED || !APPLIES<L, Op>)
+    scalar::transform_value<Op>(input, output, size, value);
+  else
+  {
+    constexpr size_t STEP = L::COUNT;
+    const typename L::reg operand = L::set1(value);
+    size_t i = 0;
+    for (; i + STEP <= size; i += STEP)
+      L::store(output + i, apply_lanes<L, Op>(L::load(input + i), operand));
+    scalar::transform_value<Op>(input + i, output + i, size - i, value);
+  }
+}
+
+template <transform_op Op, typename T>
+void transform_pairs(const T *a, const T *b, T *output, size_t size)
+{
+  using L = lanes_for<T>;
+  if constexpr (!L::SUPPORTED || !APPLIES<L, Op>)
+    scalar::transform_pairs<Op>(a, b, output, size);
+  else
+  {
+    constexpr size_t STEP = L::COUNT;
+    size_t i = 0;
+    for (; i + STEP <= size; i += STEP)
+      L::store(output + i, apply_lanes<L, Op>(L::load(a + i), L::load(b + i)));
+    scalar::transform_pairs<Op>(a + i, b + i, output + i, size - i);
+  }
+}
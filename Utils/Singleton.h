@@ -1,4 +1,15 @@
 #pragma once
+#include <Types/Base.h>
+
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// All singletons below are used the same way:
+//   class Foo : public Singleton<Foo> { friend class Singleton<Foo>; ... };
+// and differ in when the instance is built and how Instance() reaches it.
 
 template <typename T>
 class Singleton
@@ -19,3 +30,197 @@ private:
   Singleton(const Singleton&) = delete; // delete copy ctor
   Singleton& operator=(const Singleton&) = delete; // delete copy assignment
 };
+
+// Built during static initialization, before main, and destroyed after main
+// returns. Instance() is the address of a global, with no guard check.
+// Do not call it from another global's constructor, the order in which
+// translation units are initialized is unspecified.
+template <typename T>
+class EagerSingleton
+{
+public:
+  static T& Instance()
+  {
+    return s_Instance;
+  }
+
+protected:
+  EagerSingleton() = default;
+  ~EagerSingleton() = default;
+
+private:
+  EagerSingleton(const EagerSingleton&) = delete;
+  EagerSingleton& operator=(const EagerSingleton&) = delete;
+
+  static T s_Instance;
+};
+
+template <typename T>
+T EagerSingleton<T>::s_Instance;
+
+// One instance per thread, built on the thread's first call and destroyed
+// when the thread exits. After the first call Instance() is a TLS load and
+// a null check, the construction path is kept out of line.
+template <typename T>
+class ThreadLocalSingleton
+{
+public:
+  static T& Instance()
+  {
+    if (T *instance = s_Instance) [[likely]]
+      return *instance;
+    return Construct();
+  }
+
+protected:
+  ThreadLocalSingleton() = default;
+  ~ThreadLocalSingleton() = default;
+
+private:
+  ThreadLocalSingleton(const ThreadLocalSingleton&) = delete;
+  ThreadLocalSingleton& operator=(const ThreadLocalSingleton&) = delete;
+
+  // Constant initialized, so reading it needs no TLS init wrapper
+  static inline thread_local T *s_Instance = nullptr;
+
+  // Destroys the thread's instance at thread exit
+  struct Owner
+  {
+    T *instance = nullptr;
+    ~Owner()
+    {
+      s_Instance = nullptr;
+      delete instance;
+    }
+  };
+
+  [[gnu::noinline]] static T& Construct()
+  {
+    static thread_local Owner owner;
+    owner.instance = new T();
+    s_Instance = owner.instance;
+    return *s_Instance;
+  }
+};
+
+// Keeps the teardown order of ManagedSingletons. DestroyAll destroys them in
+// the reverse order they were created, so a singleton that uses another
+// during its destruction should be created after it.
+class SingletonRegistry
+{
+public:
+  static void DestroyAll()
+  {
+    for (;;)
+    {
+      FuncPtr<void()> destroy;
+      {
+        std::lock_guard<std::recursive_mutex> lock(Mutex());
+        if (Destroyers().empty())
+          return;
+        destroy = Destroyers().back();
+      }
+      // Destroy unregisters itself
+      destroy();
+    }
+  }
+
+private:
+  template <typename T>
+  friend class ManagedSingleton;
+
+  // Recursive so a constructor can Create the singletons it depends on,
+  // which then register first and are destroyed last. Both are leaked on
+  // purpose, so DestroyAll still works from atexit handlers.
+  static std::recursive_mutex& Mutex()
+  {
+    static std::recursive_mutex *mutex = new std::recursive_mutex();
+    return *mutex;
+  }
+
+  static std::vector<FuncPtr<void()>>& Destroyers()
+  {
+    static std::vector<FuncPtr<void()>> *destroyers = new std::vector<FuncPtr<void()>>();
+    return *destroyers;
+  }
+
+  static void Register(FuncPtr<void()> destroy)
+  {
+    Destroyers().push_back(destroy);
+  }
+
+  static void Unregister(FuncPtr<void()> destroy)
+  {
+    auto &destroyers = Destroyers();
+    for (size_t i = destroyers.size(); i-- > 0;)
+    {
+      if (destroyers[i] == destroy)
+      {
+        destroyers.erase(destroyers.begin() + static_cast<ptrdiff>(i));
+        return;
+      }
+    }
+  }
+};
+
+// Explicit lifetime: Create builds the instance, Destroy (or
+// SingletonRegistry::DestroyAll) tears it down. Instance() is a single
+// pointer load and must only be called between the two, which is checked
+// in debug builds.
+template <typename T>
+class ManagedSingleton
+{
+public:
+  static T& Instance()
+  {
+    T *instance = s_Instance.load(std::memory_order_acquire);
+    assert(instance && "ManagedSingleton used before Create or after Destroy");
+    return *instance;
+  }
+
+  // Builds the instance with the given arguments, returns the existing one
+  // if it was already created
+  template <typename... Args>
+  static T& Create(Args &&...args)
+  {
+    std::lock_guard<std::recursive_mutex> lock(SingletonRegistry::Mutex());
+    if (T *instance = s_Instance.load(std::memory_order_relaxed))
+      return *instance;
+
+    T *instance = new T(std::forward<Args>(args)...);
+    SingletonRegistry::Register(&Destroy);
+    s_Instance.store(instance, std::memory_order_release);
+    return *instance;
+  }
+
+  // Destroys the instance, does nothing if there is none. Other threads
+  // must have stopped using it.
+  static void Destroy()
+  {
+    T *instance;
+    {
+      std::lock_guard<std::recursive_mutex> lock(SingletonRegistry::Mutex());
+      instance = s_Instance.exchange(nullptr, std::memory_order_acq_rel);
+      if (!instance)
+        return;
+      SingletonRegistry::Unregister(&Destroy);
+    }
+    // Outside the lock, so the destructor may create or destroy others
+    delete instance;
+  }
+
+  static bool IsCreated()
+  {
+    return s_Instance.load(std::memory_order_acquire) != nullptr;
+  }
+
+protected:
+  ManagedSingleton() = default;
+  ~ManagedSingleton() = default;
+
+private:
+  ManagedSingleton(const ManagedSingleton&) = delete;
+  ManagedSingleton& operator=(const ManagedSingleton&) = delete;
+
+  static inline std::atomic<T *> s_Instance{nullptr};
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <Types/Base.h>
+
+#include <chrono>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**************************************************************************/
+/*!
+  \brief	Reads the CPU's time stamp counter: rdtsc on x86, the virtual
+          counter on ARM64 and the steady clock elsewhere. A few cycles,
+          no system call. Assumes an invariant TSC, as on any x86 CPU of
+          the last decade.
+*/
+/**************************************************************************/
+inline u64 ReadTsc()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  u64 value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count());
+#endif
+}
+
+/**************************************************************************/
+/*!
+  \brief	Maps time stamp counter values to wall clock time, from one
+          (counter, system clock) anchor and a measured tick rate.
+*/
+/**************************************************************************/
+struct TscCalibration
+{
+  u64 tsc = 0;
+  u64 nanoseconds = 0;              // System clock at tsc, since the epoch
+  double ticksPerNanosecond = 1.0;
+
+  static u64 SystemNanoseconds()
+  {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::system_clock::now().time_since_epoch())
+                                .count());
+  }
+
+  // Anchors at the current time and measures the rate by spinning for
+  // the given duration
+  static TscCalibration Measure(std::chrono::microseconds duration)
+  {
+    TscCalibration calibration;
+    calibration.nanoseconds = SystemNanoseconds();
+    calibration.tsc = ReadTsc();
+
+    const u64 until = calibration.nanoseconds + static_cast<u64>(duration.count()) * 1000;
+    while (SystemNanoseconds() < until)
+    {
+    }
+    calibration.Refine();
+    return calibration;
+  }
+
+  // Re-measures the rate over everything since the anchor, the longer the
+  // span the more exact
+  void Refine()
+  {
+    const u64 now = SystemNanoseconds();
+    const u64 ticks = ReadTsc();
+    if (now > nanoseconds && ticks > tsc)
+      ticksPerNanosecond = static_cast<double>(ticks - tsc) / static_cast<double>(now - nanoseconds);
+  }
+
+  u64 ToNanoseconds(u64 ticks) const
+  {
+    const double delta = static_cast<double>(static_cast<i64>(ticks - tsc)) / ticksPerNanosecond;
+    return nanoseconds + static_cast<u64>(static_cast<i64>(delta));
+  }
+};